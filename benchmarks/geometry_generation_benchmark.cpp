@@ -0,0 +1,198 @@
+#include "asr.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+static double measure_best_milliseconds(unsigned int run_count, Function function)
+{
+    double best{std::numeric_limits<double>::max()};
+    for (unsigned int run = 0; run < run_count; ++run) {
+        auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    return best;
+}
+
+// The generator the sphere test used before: four library calls per vertex.
+static asr::GeometryData generate_reference_sphere_geometry_data(
+                             float radius,
+                             unsigned int width_segments_count,
+                             unsigned int height_segments_count
+                         )
+{
+    asr::GeometryData geometry_data;
+    auto &[vertices, indices] = geometry_data;
+
+    for (unsigned int ring = 0; ring <= height_segments_count; ++ring) {
+        float v{static_cast<float>(ring) / static_cast<float>(height_segments_count)};
+        float phi{v * asr::pi};
+        for (unsigned int segment = 0; segment <= width_segments_count; ++segment) {
+            float u{static_cast<float>(segment) / static_cast<float>(width_segments_count)};
+            float theta{u * asr::two_pi};
+            vertices.push_back(asr::Vertex{
+                std::sin(phi) * std::cos(theta) * radius, std::cos(phi) * radius, std::sin(phi) * std::sin(theta) * radius,
+                1.0f, 1.0f, 1.0f, 1.0f,
+                1.0f - u, v
+            });
+        }
+    }
+
+    for (unsigned int ring = 0; ring < height_segments_count; ++ring) {
+        for (unsigned int segment = 0; segment < width_segments_count; ++segment) {
+            unsigned int index_a{ring * (width_segments_count + 1) + segment};
+            unsigned int index_b{index_a + 1};
+            unsigned int index_c{index_a + (width_segments_count + 1)};
+            unsigned int index_d{index_c + 1};
+
+            if (ring != 0) {
+                indices.push_back(index_a); indices.push_back(index_b); indices.push_back(index_c);
+            }
+            if (ring != height_segments_count - 1) {
+                indices.push_back(index_b); indices.push_back(index_d); indices.push_back(index_c);
+            }
+        }
+    }
+
+    return geometry_data;
+}
+
+// The largest distance between a unit sphere and the planes of the triangles, which bounds the silhouette error.
+static float measure_max_deviation(const asr::GeometryData &geometry_data)
+{
+    const auto &[vertices, indices] = geometry_data;
+
+    float max_deviation{0.0f};
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const asr::Vertex &a = vertices[indices[i]], &b = vertices[indices[i + 1]], &c = vertices[indices[i + 2]];
+        glm::vec3 normal{glm::cross(
+            glm::vec3{b.x - a.x, b.y - a.y, b.z - a.z},
+            glm::vec3{c.x - a.x, c.y - a.y, c.z - a.z}
+        )};
+        float length{glm::length(normal)};
+        if (length == 0.0f) continue;
+        max_deviation = std::max(max_deviation, 1.0f - glm::dot(normal, glm::vec3{a.x, a.y, a.z}) / length);
+    }
+
+    return max_deviation;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    static const size_t ANGLE_COUNT{1 << 20};
+    static const unsigned int RUN_COUNT{10};
+
+    std::mt19937 random_generator{42};
+    std::uniform_real_distribution<float> angle_distribution{-8.0f * pi, 8.0f * pi};
+    std::vector<float> angles(ANGLE_COUNT);
+    for (auto &angle : angles) {
+        angle = angle_distribution(random_generator);
+    }
+    std::vector<float> sines(ANGLE_COUNT), cosines(ANGLE_COUNT);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Job workers: " << get_job_worker_count() << std::endl << std::endl;
+
+    double library_time{measure_best_milliseconds(RUN_COUNT, [&] {
+        for (size_t i = 0; i < ANGLE_COUNT; ++i) {
+            sines[i] = std::sin(angles[i]);
+            cosines[i] = std::cos(angles[i]);
+        }
+    })};
+    double batch_time{measure_best_milliseconds(RUN_COUNT, [&] {
+        compute_sines_and_cosines(angles.data(), sines.data(), cosines.data(), ANGLE_COUNT);
+    })};
+
+    double max_error{0.0};
+    for (size_t i = 0; i < ANGLE_COUNT; ++i) {
+        max_error = std::max(max_error, std::abs(static_cast<double>(sines[i]) - std::sin(static_cast<double>(angles[i]))));
+        max_error = std::max(max_error, std::abs(static_cast<double>(cosines[i]) - std::cos(static_cast<double>(angles[i]))));
+    }
+
+    std::cout << "sin/cos of " << ANGLE_COUNT << " angles" << std::endl;
+    std::cout << "  std::sin + std::cos:       " << library_time << " ms" << std::endl;
+    std::cout << "  compute_sines_and_cosines: " << batch_time << " ms"
+              << " (" << library_time / batch_time << "x, max error " << std::scientific << max_error << std::fixed << ")"
+              << std::endl << std::endl;
+
+    for (unsigned int segment_count : {64u, 256u, 1024u, 2048u}) {
+        size_t vertex_count{0};
+        double reference_time{measure_best_milliseconds(RUN_COUNT, [&] {
+            vertex_count = generate_reference_sphere_geometry_data(1.0f, segment_count, segment_count / 2).first.size();
+        })};
+        double generator_time{measure_best_milliseconds(RUN_COUNT, [&] {
+            generate_sphere_geometry_data(1.0f, segment_count, segment_count / 2);
+        })};
+
+        std::cout << "Sphere " << segment_count << "x" << segment_count / 2 << " (" << vertex_count << " vertices)" << std::endl;
+        std::cout << "  per-vertex std::sin/cos:       " << reference_time << " ms" << std::endl;
+        std::cout << "  generate_sphere_geometry_data: " << generator_time << " ms"
+                  << " (" << reference_time / generator_time << "x)" << std::endl;
+    }
+
+    // Every icosphere level sets the error that the other shapes have to reach with as few vertices as they can.
+    std::cout << std::endl << "Vertices for the same maximum deviation" << std::endl;
+    for (unsigned int subdivision_count : {2u, 3u, 4u, 5u}) {
+        GeometryData icosphere{generate_icosphere_geometry_data(1.0f, subdivision_count)};
+        float target_deviation{measure_max_deviation(icosphere)};
+
+        unsigned int cube_segment_count{2};
+        while (measure_max_deviation(generate_cube_sphere_geometry_data(1.0f, cube_segment_count)) > target_deviation) {
+            cube_segment_count += 2;
+        }
+        unsigned int uv_segment_count{8};
+        while (measure_max_deviation(generate_sphere_geometry_data(1.0f, uv_segment_count, uv_segment_count / 2)) > target_deviation) {
+            uv_segment_count += 2;
+        }
+
+        size_t uv_vertex_count{generate_sphere_geometry_data(1.0f, uv_segment_count, uv_segment_count / 2).first.size()};
+        size_t cube_vertex_count{generate_cube_sphere_geometry_data(1.0f, cube_segment_count).first.size()};
+        size_t icosphere_vertex_count{icosphere.first.size()};
+        auto saving = [uv_vertex_count](size_t vertex_count) {
+            return 100.0 * (1.0 - static_cast<double>(vertex_count) / static_cast<double>(uv_vertex_count));
+        };
+
+        std::cout << "  deviation " << std::scientific << std::setprecision(2) << target_deviation
+                  << std::fixed << std::setprecision(1) << std::endl;
+        std::cout << "    UV sphere " << uv_segment_count << "x" << uv_segment_count / 2 << ": " << uv_vertex_count << std::endl;
+        std::cout << "    icosphere level " << subdivision_count << ": " << icosphere_vertex_count
+                  << " (" << saving(icosphere_vertex_count) << "% fewer)" << std::endl;
+        std::cout << "    cube sphere " << cube_segment_count << ": " << cube_vertex_count
+                  << " (" << saving(cube_vertex_count) << "% fewer)" << std::endl;
+    }
+
+    std::cout << std::endl << "Index bytes as triangle strips" << std::endl;
+    std::pair<const char *, GeometryData> meshes[]{
+        {"UV sphere 256x128", generate_sphere_geometry_data(1.0f, 256, 128)},
+        {"icosphere level 5", generate_icosphere_geometry_data(1.0f, 5)},
+        {"cube sphere 64", generate_cube_sphere_geometry_data(1.0f, 64)}
+    };
+    for (const auto &[name, mesh] : meshes) {
+        const std::vector<unsigned int> &triangle_indices = mesh.second;
+        std::vector<unsigned int> strip_indices;
+        double stripify_time{measure_best_milliseconds(3, [&] {
+            strip_indices = convert_triangles_to_strips(triangle_indices, true);
+        })};
+        size_t stitched_count{convert_triangles_to_strips(triangle_indices, false).size()};
+
+        std::cout << "  " << name << ": " << triangle_indices.size() * sizeof(unsigned int) << " -> "
+                  << strip_indices.size() * sizeof(unsigned int) << " with primitive restart ("
+                  << 100.0 * static_cast<double>(strip_indices.size()) / static_cast<double>(triangle_indices.size()) << "%), "
+                  << stitched_count * sizeof(unsigned int) << " with degenerate triangles, "
+                  << std::setprecision(3) << stripify_time << std::setprecision(1) << " ms" << std::endl;
+    }
+
+    stop_job_system();
+
+    return 0;
+}
@@ -13,27 +13,97 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define ASR_PIXEL_KERNELS_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ASR_PIXEL_KERNELS_SSE2
+    #if defined(__GNUC__)
+        // GCC and Clang compile the AVX2 kernels regardless of -m flags and pick them at run time.
+        #include <immintrin.h>
+        #define ASR_PIXEL_KERNELS_AVX2
+        #define ASR_TARGET_AVX2 __attribute__((target("avx2")))
+    #elif defined(__AVX2__)
+        #include <immintrin.h>
+        #define ASR_PIXEL_KERNELS_AVX2
+        #define ASR_TARGET_AVX2
+    #endif
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cctype>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
 #include <iostream>
 #include <limits>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 /*
  * Platform Quirks
  */
 
+#if defined(_MSC_VER)
+    #define ASR_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__)
+    #define ASR_NOINLINE __attribute__((noinline))
+#else
+    #define ASR_NOINLINE
+#endif
+
+/*
+ * Tracing
+ *
+ * Scoped CPU and GPU trace markers. They compile to nothing unless ASR_ENABLE_TRACING is defined.
+ */
+
+#ifdef ASR_ENABLE_TRACING
+#define ASR_TRACE_CONCATENATE_IMPLEMENTATION(a, b) a##b
+#define ASR_TRACE_CONCATENATE(a, b) ASR_TRACE_CONCATENATE_IMPLEMENTATION(a, b)
+#define ASR_TRACE_SCOPE(name) asr::utilities::TraceScope ASR_TRACE_CONCATENATE(asr_trace_scope_, __LINE__){name}
+#define ASR_TRACE_GPU_SCOPE(name) asr::utilities::GpuTraceScope ASR_TRACE_CONCATENATE(asr_gpu_trace_scope_, __LINE__){name}
+#else
+#define ASR_TRACE_SCOPE(name) ((void) 0)
+#define ASR_TRACE_GPU_SCOPE(name) ((void) 0)
+#endif
+
 namespace asr
 {
     /*
@@ -45,6 +115,107 @@ namespace asr
     static constexpr float half_pi{0.5f * static_cast<float>(M_PI)};
     static constexpr float quarter_pi{0.25f * static_cast<float>(M_PI)};
 
+    /*
+     * Memory Accounting Types
+     */
+
+    enum MemoryCategory
+    {
+        Buffers,
+        Textures,
+        RenderTargets,
+        Images,
+        Pools
+    };
+
+    static const unsigned int memory_category_count{5};
+
+    struct MemoryUsageRecord
+    {
+        std::string owner;
+        std::array<size_t, memory_category_count> bytes{};
+    };
+
+    namespace utilities
+    {
+        static void account_memory(MemoryCategory category, unsigned int owner, int64_t byte_delta);
+        static unsigned int get_current_memory_owner();
+    }
+
+    template<typename T, MemoryCategory category>
+    struct MemoryTrackingAllocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = MemoryTrackingAllocator<U, category>;
+        };
+
+        // Owner the block was charged to, so a release credits the same one.
+        static constexpr size_t header_size{alignof(std::max_align_t)};
+
+        MemoryTrackingAllocator() = default;
+
+        template<typename U>
+        MemoryTrackingAllocator(const MemoryTrackingAllocator<U, category> &) { }
+
+        // Set by utilities::resize_uninitialized() only.
+        static inline thread_local bool skip_value_initialization{false};
+
+        template<typename U>
+        void construct(U *pointer) noexcept(std::is_nothrow_default_constructible<U>::value)
+        {
+            if (skip_value_initialization) {
+                ::new(static_cast<void *>(pointer)) U;
+            } else {
+                ::new(static_cast<void *>(pointer)) U();
+            }
+        }
+
+        template<typename U, typename... Arguments>
+        void construct(U *pointer, Arguments &&...arguments)
+        {
+            ::new(static_cast<void *>(pointer)) U(std::forward<Arguments>(arguments)...);
+        }
+
+        T *allocate(size_t count)
+        {
+            size_t size{count * sizeof(T)};
+            auto *block = static_cast<uint8_t *>(::operator new(size + header_size));
+
+            unsigned int owner{utilities::get_current_memory_owner()};
+            std::memcpy(block, &owner, sizeof(owner));
+            utilities::account_memory(category, owner, static_cast<int64_t>(size));
+
+            return reinterpret_cast<T *>(block + header_size);
+        }
+
+        void deallocate(T *pointer, size_t count)
+        {
+            auto *block = reinterpret_cast<uint8_t *>(pointer) - header_size;
+
+            unsigned int owner;
+            std::memcpy(&owner, block, sizeof(owner));
+            utilities::account_memory(category, owner, -static_cast<int64_t>(count * sizeof(T)));
+
+            ::operator delete(block);
+        }
+    };
+
+    template<typename T, typename U, MemoryCategory category>
+    bool operator==(const MemoryTrackingAllocator<T, category> &, const MemoryTrackingAllocator<U, category> &)
+    {
+        return true;
+    }
+
+    template<typename T, typename U, MemoryCategory category>
+    bool operator!=(const MemoryTrackingAllocator<T, category> &, const MemoryTrackingAllocator<U, category> &)
+    {
+        return false;
+    }
+
     /*
      * Geometry Types
      */
@@ -54,6 +225,7 @@ namespace asr
         float x, y, z;
         float r, g, b, a;
         float u, v;
+        float layer{0.0f};
     };
 
     enum GeometryType
@@ -67,6 +239,27 @@ namespace asr
         TriangleStrip
     };
 
+    static const size_t parallel_shape_generation_threshold{65536};
+
+    // The fixed restart index of 32-bit indices.
+    static const unsigned int primitive_restart_index{0xFFFFFFFF};
+
+    enum SphereTextureMapping
+    {
+        SeamlessEquirectangularMapping,
+        EquirectangularMapping,
+        CubeFaceMapping
+    };
+
+    struct GeometryView
+    {
+        GeometryType type;
+        unsigned int first_index;
+        unsigned int index_count;
+    };
+
+    using GeometryViewData = std::pair<GeometryType, std::vector<unsigned int>>;
+
     struct Geometry
     {
         GeometryType type;
@@ -75,18 +268,51 @@ namespace asr
         int vertex_array_object;
         int vertex_buffer_object;
         int index_buffer_object;
+
+        size_t vertex_buffer_size;
+        size_t index_buffer_size;
+        unsigned int memory_owner;
+
+        std::vector<GeometryView> views;
     };
 
     /*
      * Texture Types
      */
 
+    using PixelData = std::vector<uint8_t, MemoryTrackingAllocator<uint8_t, Images>>;
+
     struct Image
     {
-        std::vector<uint8_t> pixel_data;
-        unsigned int width;
-        unsigned int height;
-        unsigned int channels;
+        PixelData pixel_data;
+        unsigned int width{0};
+        unsigned int height{0};
+        unsigned int channels{0};
+        bool bgr_order{false};
+
+        Image() = default;
+
+        Image(PixelData pixel_data, unsigned int width, unsigned int height, unsigned int channels, bool bgr_order = false)
+            : pixel_data{std::move(pixel_data)}, width{width}, height{height}, channels{channels}, bgr_order{bgr_order} { }
+
+        template<typename Allocator>
+        Image(
+            const std::vector<uint8_t, Allocator> &pixel_data,
+            unsigned int width, unsigned int height, unsigned int channels, bool bgr_order = false
+        )
+            : pixel_data(pixel_data.begin(), pixel_data.end()),
+              width{width}, height{height}, channels{channels}, bgr_order{bgr_order} { }
+    };
+
+    enum PixelConversion : unsigned int
+    {
+        NoPixelConversion = 0,
+        ExpandToRGBA = 1 << 0,
+        ConvertSRGBToLinear = 1 << 1,
+        PremultiplyAlpha = 1 << 2,
+        ConvertLinearToSRGB = 1 << 3,
+        SwizzleToBGRA = 1 << 4,
+        FlipVertically = 1 << 5
     };
 
     enum TexturingMode
@@ -115,11 +341,21 @@ namespace asr
         LinearMipmapLinear
     };
 
+    enum TextureType
+    {
+        Texture2D,
+        Texture2DArray
+    };
+
     struct Texture
     {
+        TextureType type{Texture2D};
+
         unsigned int width{};
         unsigned int height{};
         unsigned int channels{};
+        unsigned int layers{1};
+        bool bgr_order{false};
 
         TexturingMode mode{Modulation};
         TextureWrapMode wrap_mode_u{ClampToEdge};
@@ -129,624 +365,7935 @@ namespace asr
         float anisotropy{0.0f};
 
         GLuint texture_object{0};
+
+        size_t memory_size{0};
+        unsigned int memory_owner{0};
     };
 
     /*
-     * Transformation Types
+     * Shader Types
      */
 
-    enum MatrixMode
+    // Bound before linking, so vertex array objects work with every program.
+    static const GLuint position_attribute_location{0};
+    static const GLuint color_attribute_location{1};
+    static const GLuint texture_coordinates_attribute_location{2};
+
+    enum BuiltinUniform : uint8_t
     {
-        Model,
-        View,
-        Projection,
-        Texturing
+        ResolutionUniform,
+        MouseUniform,
+        TimeUniform,
+        DtUniform,
+        TextureSamplerUniform,
+        TextureEnabledUniform,
+        TextureSamplersUniform,
+        TexturesEnabledUniform,
+        TexturingModeUniform,
+        TextureTransformationMatrixUniform,
+        ModelMatrixUniform,
+        ViewMatrixUniform,
+        ModelViewMatrixUniform,
+        ProjectionMatrixUniform,
+        ViewProjectionMatrixUniform,
+        ModelViewProjectionMatrixUniform
     };
 
-    namespace data
-    {
-        /*
-         * Window Data
-         */
+    static const unsigned int builtin_uniform_count{16};
+
+    static constexpr const char *builtin_uniform_names[builtin_uniform_count]{
+        "resolution",
+        "mouse",
+        "time",
+        "get_dt",
+        "texture_sampler",
+        "texture_enabled",
+        "texture_samplers",
+        "textures_enabled",
+        "texturing_mode",
+        "texture_transformation_matrix",
+        "model_matrix",
+        "view_matrix",
+        "model_view_matrix",
+        "projection_matrix",
+        "view_projection_matrix",
+        "model_view_projection_matrix"
+    };
 
-        static unsigned int window_width{500};
-        static unsigned int window_height{500};
-        static const unsigned int fullscreen{std::numeric_limits<bool>::max()};
+    struct BuiltinUniformBinding
+    {
+        BuiltinUniform uniform;
+        GLint location;
+    };
 
-        static SDL_Window *window{nullptr};
-        static SDL_GLContext gl_context;
+    struct ShaderProgram
+    {
+        GLuint program_object{0};
 
-        static uint32_t mouse_state{0};
-        static int mouse_x{0}, mouse_y{0};
+        std::array<BuiltinUniformBinding, builtin_uniform_count> builtin_uniforms{};
+        unsigned int active_builtin_uniform_count{0};
 
-        static std::function<void(int)> key_down_event_handler;
-        static std::function<void(const uint8_t *)> keys_down_event_handler;
+        bool uses_frame_uniform_block{false};
+        bool uses_view_uniform_block{false};
+    };
 
-        /*
-         * Shader Data
-         */
+    // Interfaces are structs whose static constexpr get_shader_uniforms() returns a tuple of make_shader_uniform()s.
+    template<typename Interface, typename T>
+    struct ShaderUniform
+    {
+        const char *name;
+        T Interface::*member;
+    };
 
-        static GLuint shader_program{0};
+    template<typename Interface, typename T>
+    constexpr ShaderUniform<Interface, T> make_shader_uniform(const char *name, T Interface::*member)
+    {
+        return ShaderUniform<Interface, T>{name, member};
+    }
 
-        static GLint position_attribute_location{-1};
-        static GLint color_attribute_location{-1};
-        static GLint texture_coordinates_attribute_location{-1};
+    template<typename Interface>
+    struct ShaderInterface
+    {
+        using UniformUploader = void (*)(GLint, const Interface &);
 
-        static GLint resolution_uniform_location{-1};
-        static GLint mouse_uniform_location{-1};
+        struct Binding
+        {
+            GLint location;
+            UniformUploader upload;
+        };
 
-        static GLint time_uniform_location{-1};
-        static GLint dt_uniform_location{-1};
+        static constexpr size_t uniform_count{std::tuple_size<decltype(Interface::get_shader_uniforms())>::value};
 
-        static GLint texture_sampler_uniform_location{-1};
-        static GLint texture_enabled_uniform_location{-1};
-        static GLint texturing_mode_uniform_location{-1};
-        static GLint texture_transformation_matrix_uniform_location{-1};
+        GLuint program_object{0};
+        std::array<Binding, uniform_count> uniforms{};
+        size_t active_uniform_count{0};
+    };
 
-        static GLint model_matrix_uniform_location{-1};
-        static GLint view_matrix_uniform_location{-1};
-        static GLint model_view_matrix_uniform_location{-1};
-        static GLint projection_matrix_uniform_location{-1};
-        static GLint view_projection_matrix_uniform_location{-1};
-        static GLint mvp_matrix_uniform_location{-1};
+    // Variants define ASR_TEXTURE_ENABLED, ASR_TEXTURING_MODE and ASR_VERTEX_COLOR_ENABLED to match the draw state.
+    static const uint32_t no_shader_variant{std::numeric_limits<uint32_t>::max()};
 
-        /*
-         * Geometry Data
-         */
+    struct ShaderVariants
+    {
+        std::string vertex_shader_source;
+        std::string fragment_shader_source;
+        std::unordered_map<uint32_t, ShaderProgram> programs;
 
-        static Geometry *current_geometry{nullptr};
+        uint32_t last_key{no_shader_variant};
+        ShaderProgram *last_program{nullptr};
+    };
 
-        /*
-         * Texture Data
-         */
+    /*
+     * Shared Uniform Blocks
+     *
+     * On GL 3.1+ (or with GL_ARB_uniform_buffer_object) frame-global values are written once per frame into
+     * uniform buffers bound to every program. Shaders opt in by declaring the blocks (GLSL 1.40+):
+     *
+     *     layout(std140) uniform FrameUniforms
+     *     {
+     *         vec2 resolution;
+     *         vec2 mouse;
+     *         float time;
+     *         float dt;
+     *     };
+     *
+     *     layout(std140) uniform ViewUniforms
+     *     {
+     *         mat4 view_matrix;
+     *         mat4 projection_matrix;
+     *         mat4 view_projection_matrix;
+     *     };
+     *
+     * Programs that declare the plain uniforms instead keep receiving them per draw.
+     */
 
-        static Texture *current_texture{nullptr};
+    static const GLuint frame_uniform_block_binding{0};
+    static const GLuint view_uniform_block_binding{1};
 
-        /*
-         * Transformation Data
-         */
+    struct FrameUniformBlock
+    {
+        glm::vec2 resolution;
+        glm::vec2 mouse;
+        float time;
+        float dt;
+        float padding[2];
+    };
 
-        static std::stack<glm::mat4> model_matrix_stack;
-        static std::stack<glm::mat4> view_matrix_stack;
-        static std::stack<glm::mat4> projection_matrix_stack;
-        static std::stack<glm::mat4> texture_matrix_stack;
+    struct ViewUniformBlock
+    {
+        glm::mat4 view_matrix;
+        glm::mat4 projection_matrix;
+        glm::mat4 view_projection_matrix;
+    };
 
-        static std::stack<glm::mat4> *current_matrix_stack = &model_matrix_stack;
+    static_assert(sizeof(FrameUniformBlock) == 32, "FrameUniformBlock must match the std140 layout");
+    static_assert(sizeof(ViewUniformBlock) == 192, "ViewUniformBlock must match the std140 layout");
 
-        /*
-         * Utility Data
-         */
+    /*
+     * Resource Upload Types
+     */
 
-        static std::chrono::system_clock::time_point rendering_start_time;
-        static std::chrono::system_clock::time_point frame_rendering_start_time;
-        static float frame_rendering_delta_time{0.016f};
-        static float time_scale{1.0f};
-    }
+    struct TextureUpload
+    {
+        Texture texture{};
+        bool ready{false};
+    };
 
-    namespace utilities
+    struct GeometryUpload
     {
-        /*
-         * Geometry Handling
-         */
+        Geometry geometry{};
+        bool ready{false};
+    };
 
-        static GLenum convert_geometry_type_to_es2_geometry_type(GeometryType type)
-        {
-            switch (type) {
-                case GeometryType::Points:
-                    return GL_POINTS;
-                case GeometryType::Lines:
-                    return GL_LINES;
-                case GeometryType::LineLoop:
-                    return GL_LINE_LOOP;
-                case GeometryType::LineStrip:
-                    return GL_LINE_STRIP;
-                case GeometryType::Triangles:
-                    return GL_TRIANGLES;
-                case GeometryType::TriangleFan:
-                    return GL_TRIANGLE_FAN;
-                case GeometryType::TriangleStrip:
-                    return GL_TRIANGLE_STRIP;
-            }
+    struct ResourceUploadJob
+    {
+        std::function<void()> upload;
+        std::function<void()> publish;
 
-            return GL_TRIANGLES;
-        }
+        GLsync fence{nullptr};
+    };
 
-        /*
-        * Texture Handling
-        */
+    /*
+     * Job Types
+     */
 
-        static GLint convert_wrap_mode_to_es2_texture_wrap_mode(TextureWrapMode wrap_mode)
-        {
-            switch (wrap_mode) {
-                case Repeat:
-                    return GL_REPEAT;
-                case MirroredRepeat:
-                    return GL_MIRRORED_REPEAT;
-                case ClampToEdge:
-                    return GL_CLAMP_TO_EDGE;
-            }
+    struct JobGroup
+    {
+        std::atomic<size_t> unfinished_job_count{0};
+    };
 
-            return GL_REPEAT;
-        }
+    struct Job
+    {
+        std::function<void()> function;
+        JobGroup *group{nullptr};
+        bool background{false};
+
+        std::atomic<unsigned int> unfinished_dependency_count{0};
+        std::atomic<bool> finished{false};
+        std::mutex continuation_mutex;
+        std::vector<std::shared_ptr<Job>> continuations;
+    };
 
-        static GLint convert_filter_type_to_es2_texture_filter_type(TextureFilterType filter)
-        {
-            switch (filter) {
-                case Nearest:
-                    return GL_NEAREST;
-                case Linear:
-                    return GL_LINEAR;
-                case NearestMipmapNearest:
-                    return GL_NEAREST_MIPMAP_NEAREST;
-                case NearestMipmapLinear:
-                    return GL_NEAREST_MIPMAP_LINEAR;
-                case LinearMipmapNearest:
-                    return GL_LINEAR_MIPMAP_NEAREST;
-                case LinearMipmapLinear:
-                    return GL_LINEAR_MIPMAP_LINEAR;
-            }
+    using JobHandle = std::shared_ptr<Job>;
 
-            return GL_NEAREST;
-        }
-    }
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+    };
 
     /*
-     * Window Handling
+     * Asynchronous Loading Types
      */
 
-    static void create_window(unsigned int width, unsigned int height)
+    enum LoadState
     {
-        SDL_Init(SDL_INIT_VIDEO);
+        Pending,
+        Ready,
+        Failed,
+        Cancelled
+    };
 
-        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
-        SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
-        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 2);
+    enum LoadPriority
+    {
+        Low,
+        Normal,
+        High
+    };
 
-        data::window_width = width;
-        data::window_height = height;
+    // state is only written on the render thread after value and error, so once it is not Pending both can be read.
+    template<typename T>
+    struct AsyncLoad
+    {
+        LoadState state{Pending};
+        T value{};
+        std::string error;
 
-        unsigned int flags{SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI};
-        if (data::window_width == data::fullscreen || data::window_height == data::fullscreen) {
-            flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
-        }
-        data::window =
-            SDL_CreateWindow(
-                "ASR: Version 3.0",
-                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                static_cast<int>(data::window_width),
-                static_cast<int>(data::window_height),
-                flags
-            );
-        SDL_GL_GetDrawableSize(
-            data::window,
-            reinterpret_cast<int *>(&data::window_width),
-            reinterpret_cast<int *>(&data::window_height)
-        );
+        std::atomic<bool> cancel_requested{false};
+    };
 
-        data::gl_context = SDL_GL_CreateContext(data::window);
-        SDL_GL_MakeCurrent(data::window, data::gl_context);
+    struct AsyncLoadJob
+    {
+        LoadPriority priority{Normal};
+        uint64_t sequence{0};
 
-        if (glewInit() != GLEW_OK) {
+        std::function<bool()> is_cancelled;
+        std::function<void()> load;
+        std::function<void()> complete;
+    };
+
+    /*
+     * Texture Streaming Types
+     */
+
+    static const unsigned int texture_stream_buffer_count{2};
+
+    struct TextureStreamBuffer
+    {
+        GLuint pixel_buffer_object{0};
+        GLsync fence{nullptr};
+
+        uint8_t *mapped_pixels{nullptr};
+        const uint8_t *source_pixels{nullptr};
+        size_t source_row_size{0};
+        size_t row_size{0};
+
+        unsigned int x{0}, y{0};
+        unsigned int width{0}, height{0};
+        std::vector<uint8_t> dirty_rows;
+
+        bool copied{false};
+        bool pending{false};
+    };
+
+    // The OpenGL texture has to outlive the stream.
+    struct TextureStream
+    {
+        Texture texture{};
+
+        std::array<TextureStreamBuffer, texture_stream_buffer_count> buffers{};
+        unsigned int next_buffer{0};
+        size_t buffer_size{0};
+
+        bool track_dirty_rows{false};
+        std::vector<uint8_t> dirty_rows;
+    };
+
+    /*
+     * Virtual Texture Types
+     */
+
+    // The rectangle includes the tile borders. Returning false requests the tile again later.
+    using VirtualTextureTileProvider = std::function<bool(
+        unsigned int level, int x, int y, unsigned int width, unsigned int height, uint8_t *pixels
+    )>;
+
+    static const unsigned int virtual_texture_tile_border{1};
+
+    struct VirtualTextureSlot
+    {
+        uint64_t tile_key{0};
+        unsigned int last_used_frame{0};
+        bool occupied{false};
+        bool pinned{false};
+    };
+
+    struct VirtualTextureTileData
+    {
+        uint64_t tile_key{0};
+        bool loaded{false};
+        std::vector<uint8_t> pixels;
+    };
+
+    struct VirtualTexture
+    {
+        unsigned int width{0};
+        unsigned int height{0};
+
+        unsigned int tile_size{0};
+        unsigned int padded_tile_size{0};
+        unsigned int tiles_per_side{0};
+        unsigned int level_count{0};
+        unsigned int atlas_tiles_per_side{0};
+        unsigned int max_tile_uploads_per_frame{8};
+
+        Texture atlas_texture{};
+        Texture indirection_texture{};
+
+        VirtualTextureTileProvider provider;
+
+        // Per level: the atlas slot of every tile, or one of the states below.
+        std::vector<std::vector<int32_t>> tile_slots;
+        std::vector<std::vector<uint32_t>> indirection_levels;
+        std::vector<VirtualTextureSlot> slots;
+
+        unsigned int frame{0};
+        std::vector<uint64_t> missing_tiles;
+        std::vector<VirtualTextureTileData> committed_tiles;
+
+        // One job at a time, so the provider is never called concurrently.
+        JobGroup loader_jobs;
+        unsigned int active_loader_jobs{0};
+        unsigned int max_loader_jobs{1};
+        std::mutex mutex;
+        bool loader_should_stop{false};
+        std::vector<uint64_t> requested_tiles;
+        size_t next_requested_tile{0};
+        std::vector<VirtualTextureTileData> finished_tiles;
+        std::vector<std::vector<uint8_t>> free_tile_buffers;
+    };
+
+    static const int32_t virtual_texture_tile_absent{-1};
+    static const int32_t virtual_texture_tile_requested{-2};
+
+    /*
+     * Archive Types
+     */
+
+    struct MappedFile
+    {
+        const uint8_t *data{nullptr};
+        size_t size{0};
+
+#ifdef _WIN32
+        HANDLE file{INVALID_HANDLE_VALUE};
+        HANDLE mapping{nullptr};
+#else
+        int file{-1};
+#endif
+    };
+
+    static const char archive_magic[8]{'A', 'S', 'R', 'P', 'A', 'C', 'K', '\0'};
+    static const uint32_t archive_version{1};
+    static const uint64_t archive_alignment{64};
+    static const unsigned int archive_entry_name_size{64};
+    static const unsigned int archive_max_sections{16};
+
+    enum ArchiveEntryType : uint32_t
+    {
+        ArchiveTexture = 1,
+        ArchiveGeometry = 2
+    };
+
+    // Every payload and section starts on a 64-byte boundary. Values are little-endian.
+    struct ArchiveHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t entry_count;
+        uint64_t table_of_contents_offset;
+        uint8_t reserved[40];
+    };
+
+    // Offsets are relative to the start of the payload.
+    struct ArchiveEntry
+    {
+        char name[archive_entry_name_size];
+        uint32_t type;
+
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t bgr_order;
+
+        uint32_t geometry_type;
+        uint32_t vertex_count;
+        uint32_t index_count;
+
+        uint64_t offset;
+        uint64_t size;
+
+        uint32_t section_count;
+        uint32_t reserved;
+        uint64_t section_offsets[archive_max_sections];
+        uint64_t section_sizes[archive_max_sections];
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 64, "The archive header must keep its on-disk size");
+    static_assert(sizeof(ArchiveEntry) == 376, "The archive entry must keep its on-disk size");
+
+    struct Archive
+    {
+        std::string path;
+        MappedFile file;
+
+        const ArchiveHeader *header{nullptr};
+        const ArchiveEntry *entries{nullptr};
+    };
+
+    struct ArchiveBuilder
+    {
+        std::vector<ArchiveEntry> entries;
+        std::vector<std::vector<std::pair<const uint8_t *, size_t>>> sections;
+        std::deque<std::vector<uint8_t>> owned_data;
+    };
+
+    /*
+     * Geometry File Types
+     */
+
+    enum GeometryFileCompression : uint32_t
+    {
+        UncompressedGeometryFile = 0,
+        LZ4GeometryFile = 1
+    };
+
+    static const char geometry_file_magic[8]{'A', 'S', 'R', 'G', 'E', 'O', 'M', '\0'};
+    static const uint32_t geometry_file_version{1};
+    static const uint64_t geometry_file_alignment{64};
+    static const uint32_t geometry_file_chunk_size{1u << 20};
+    static const unsigned int geometry_file_attribute_count{3};
+
+    struct GeometryBounds
+    {
+        glm::vec3 minimum{0.0f};
+        glm::vec3 maximum{0.0f};
+    };
+
+    struct GeometryFileAttribute
+    {
+        uint32_t location;
+        uint32_t components;
+        uint32_t offset;
+    };
+
+    // Compressed files cut the same layout into geometry_file_chunk_size chunks of independent LZ4 blocks.
+    struct GeometryFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t geometry_type;
+        uint32_t vertex_count;
+        uint32_t index_count;
+
+        uint32_t vertex_stride;
+        uint32_t attribute_count;
+        GeometryFileAttribute attributes[geometry_file_attribute_count];
+
+        float bounds_minimum[3];
+        float bounds_maximum[3];
+
+        uint32_t compression;
+        uint32_t chunk_count;
+        uint32_t reserved;
+
+        uint64_t vertex_data_offset;
+        uint64_t index_data_offset;
+        uint64_t chunk_table_offset;
+    };
+
+    // A chunk whose compressed size equals its size is stored as it is.
+    struct GeometryFileChunk
+    {
+        uint64_t offset;
+        uint32_t compressed_size;
+        uint32_t size;
+    };
+
+    static_assert(sizeof(GeometryFileHeader) == 128, "The geometry file header must keep its on-disk size");
+    static_assert(sizeof(GeometryFileChunk) == 16, "The geometry file chunk must keep its on-disk size");
+
+    /*
+     * Geometry Import Types
+     */
+
+    using GeometryData = std::pair<std::vector<Vertex>, std::vector<unsigned int>>;
+
+    static const size_t geometry_import_chunk_size{8u << 20};
+
+    // Relative OBJ indices keep this bias until the vertex count before their chunk is known.
+    static const int64_t obj_relative_index_bias{static_cast<int64_t>(1) << 48};
+
+    struct ObjChunk
+    {
+        std::vector<float> positions;
+        std::vector<float> colors;
+        std::vector<float> texture_coordinates;
+        std::vector<int64_t> position_indices;
+        std::vector<int64_t> texture_coordinate_indices;
+
+        bool has_colors{false};
+        bool failed{false};
+    };
+
+    enum PlyFormat
+    {
+        PlyAscii,
+        PlyBinaryLittleEndian,
+        PlyBinaryBigEndian
+    };
+
+    enum PlyType
+    {
+        PlyInt8,
+        PlyUInt8,
+        PlyInt16,
+        PlyUInt16,
+        PlyInt32,
+        PlyUInt32,
+        PlyFloat32,
+        PlyFloat64
+    };
+
+    enum PlyVertexAttribute
+    {
+        PlyIgnored = -1,
+        PlyX, PlyY, PlyZ,
+        PlyRed, PlyGreen, PlyBlue, PlyAlpha,
+        PlyU, PlyV
+    };
+
+    struct PlyProperty
+    {
+        std::string name;
+        PlyType type{PlyFloat32};
+        bool is_list{false};
+        PlyType count_type{PlyUInt8};
+        int attribute{PlyIgnored};
+    };
+
+    struct PlyElement
+    {
+        std::string name;
+        size_t count{0};
+        std::vector<PlyProperty> properties;
+    };
+
+    /*
+     * Particle Types
+     */
+
+    using ParticleData = std::vector<float, MemoryTrackingAllocator<float, Pools>>;
+
+    static const size_t particle_chunk_size{32768};
+    static const size_t parallel_particle_threshold{65536};
+
+    struct ParticleAttractor
+    {
+        glm::vec3 position{0.0f};
+        float strength{1.0f};
+    };
+
+    struct ParticleEmitter
+    {
+        glm::vec3 position{0.0f};
+        glm::vec3 position_spread{0.0f};
+        glm::vec3 velocity{0.0f};
+        glm::vec3 velocity_spread{0.0f};
+
+        float minimum_lifetime{1.0f};
+        float maximum_lifetime{1.0f};
+        float minimum_size{1.0f};
+        float maximum_size{1.0f};
+
+        glm::vec4 color{1.0f};
+    };
+
+    // Shaders get the size in texture_coordinates.x and the lifetime fraction in texture_coordinates.y.
+    struct ParticleVertex
+    {
+        float x, y, z;
+        float size;
+        float age;
+        uint8_t r, g, b, a;
+    };
+
+    struct ParticleSystem
+    {
+        size_t capacity{0};
+        size_t count{0};
+
+        ParticleData positions_x, positions_y, positions_z;
+        ParticleData velocities_x, velocities_y, velocities_z;
+        ParticleData ages, lifetimes, sizes;
+        std::vector<uint32_t, MemoryTrackingAllocator<uint32_t, Pools>> colors;
+
+        glm::vec3 gravity{0.0f};
+        float drag{0.0f};
+        std::vector<ParticleAttractor> attractors;
+        float attractor_softening{0.01f};
+        bool parallel{true};
+
+        uint64_t random_state{0x9E3779B97F4A7C15ull};
+
+        GLuint vertex_array_object{0};
+        GLuint vertex_buffer_object{0};
+        std::vector<ParticleVertex, MemoryTrackingAllocator<ParticleVertex, Pools>> staging_vertices;
+
+        size_t vertex_buffer_size{0};
+        unsigned int memory_owner{0};
+    };
+
+    /*
+     * Rendering Types
+     */
+
+    enum BlendingMode
+    {
+        AlphaBlending,
+        PremultipliedAlphaBlending,
+        AdditiveBlending
+    };
+
+    // Weighted blended order-independent transparency (McGuire and Bavoil).
+    struct TransparencyTargets
+    {
+        GLuint framebuffer{0};
+        GLuint accumulation_texture{0};
+        GLuint weight_texture{0};
+        GLuint depth_renderbuffer{0};
+        unsigned int width{0};
+        unsigned int height{0};
+        size_t memory_size{0};
+
+        ShaderProgram composite_program{};
+        GLuint composite_vertex_array{0};
+        GLuint composite_vertex_buffer{0};
+    };
+
+    /*
+     * Transformation Types
+     */
+
+    enum MatrixMode
+    {
+        Model,
+        View,
+        Projection,
+        Texturing
+    };
+
+    // A vector, so pushing and popping every frame does not allocate.
+    using MatrixStack = std::stack<glm::mat4, std::vector<glm::mat4>>;
+
+    /*
+     * Allocation Tracking Types
+     */
+
+    struct FrameAllocationStatistics
+    {
+        size_t allocation_count{0};
+        size_t deallocation_count{0};
+        size_t allocated_bytes{0};
+    };
+
+    /*
+     * Statistics Types
+     */
+
+    struct FrameStatistics
+    {
+        size_t draw_calls{0};
+        size_t drawn_indices{0};
+        size_t program_binds{0};
+        size_t vertex_array_binds{0};
+        size_t texture_binds{0};
+        size_t buffer_binds{0};
+        size_t uniform_uploads{0};
+        size_t state_changes{0};
+        size_t uploaded_bytes{0};
+        size_t background_uploaded_bytes{0};
+        size_t redundant_calls_skipped{0};
+    };
+
+    /*
+     * OpenGL State Types
+     */
+
+    static const unsigned int max_texture_units{16};
+
+    // Tri-state flags start unknown (-1), so the first request always reaches the driver.
+    struct GLStateCache
+    {
+        GLuint program{0};
+        GLuint vertex_array_object{0};
+        GLuint array_buffer{0};
+
+        unsigned int active_texture_unit{0};
+        std::array<GLuint, max_texture_units> bound_textures{};
+        std::array<GLenum, max_texture_units> bound_texture_targets{};
+
+        int8_t depth_test{-1};
+        int8_t face_culling{-1};
+        int8_t blending{-1};
+        int8_t program_point_size{-1};
+        int8_t point_sprite{-1};
+        int8_t polygon_offset_fill{-1};
+        int8_t depth_writes{-1};
+
+        GLenum depth_function{GL_LESS};
+        GLenum front_face{GL_CCW};
+        GLenum cull_face{GL_BACK};
+        GLenum blend_source_factor{GL_ONE};
+        GLenum blend_destination_factor{GL_ZERO};
+        GLenum blend_source_alpha_factor{GL_ONE};
+        GLenum blend_destination_alpha_factor{GL_ZERO};
+
+        std::array<GLint, 4> viewport{-1, -1, -1, -1};
+        GLfloat line_width{1.0f};
+        GLfloat polygon_offset_factor{0.0f};
+        GLfloat polygon_offset_units{0.0f};
+    };
+
+    /*
+     * Tracing Types
+     */
+
+#ifdef ASR_ENABLE_TRACING
+    struct TraceEvent
+    {
+        const char *name;
+        int64_t start_time;
+        int64_t duration;
+    };
+
+    struct TraceBuffer
+    {
+        static const size_t capacity{1 << 16};
+
+        // Only the owning thread appends; readers see the events published through 'count'.
+        std::vector<TraceEvent> events = std::vector<TraceEvent>(capacity);
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> dropped_count{0};
+
+        unsigned int thread_id{0};
+        std::string thread_name;
+    };
+
+    struct GpuTraceQuery
+    {
+        const char *name;
+        GLuint start_query;
+        GLuint end_query;
+    };
+#endif
+
+    namespace data
+    {
+        /*
+         * Window Data
+         */
+
+        static unsigned int window_width{500};
+        static unsigned int window_height{500};
+        static const unsigned int fullscreen{std::numeric_limits<bool>::max()};
+
+        static SDL_Window *window{nullptr};
+        static SDL_GLContext gl_context;
+
+        static uint32_t mouse_state{0};
+        static int mouse_x{0}, mouse_y{0};
+
+        static std::function<void(int)> key_down_event_handler;
+        static std::function<void(const uint8_t *)> keys_down_event_handler;
+
+        /*
+         * Shader Data
+         */
+
+        static ShaderProgram shader_program;
+        static ShaderProgram *current_shader_program{&shader_program};
+        static ShaderVariants *current_shader_variants{nullptr};
+        static bool vertex_colors_enabled{true};
+
+        static bool uniform_buffers_supported{false};
+        static GLuint frame_uniform_buffer{0};
+        static GLuint view_uniform_buffer{0};
+        static glm::mat4 uploaded_view_matrix{1.0f};
+        static glm::mat4 uploaded_projection_matrix{1.0f};
+        static bool view_uniform_block_uploaded{false};
+
+        /*
+         * Geometry Data
+         */
+
+        static Geometry *current_geometry{nullptr};
+
+        /*
+         * Texture Data
+         */
+
+        static Texture *current_texture{nullptr};
+        static std::array<const Texture *, max_texture_units> current_textures{};
+        static std::array<GLint, max_texture_units> texture_sampler_units{
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+        };
+
+        /*
+         * Transparency Data
+         */
+
+        static TransparencyTargets transparency_targets;
+        static bool transparency_pass_active{false};
+        static GLStateCache state_before_transparency_pass;
+
+        /*
+         * Job System Data
+         */
+
+        static std::vector<std::thread> job_workers;
+        static std::deque<JobQueue> job_queues;
+        static std::atomic<bool> job_system_running{false};
+        static std::mutex job_system_mutex;
+
+        static std::mutex job_sleep_mutex;
+        static std::condition_variable job_sleep_condition;
+        static std::atomic<size_t> queued_job_count{0};
+        static bool job_workers_should_stop{false};
+
+        // Only idle workers take background jobs, and never all of them at once.
+        static JobQueue background_job_queue;
+        static std::atomic<size_t> queued_background_job_count{0};
+        static std::atomic<size_t> running_background_job_count{0};
+        static size_t max_running_background_jobs{1};
+
+        static std::condition_variable job_wait_condition;
+        static std::atomic<size_t> job_waiter_count{0};
+        static std::atomic<uint64_t> job_event_count{0};
+
+        static const size_t no_job_queue{std::numeric_limits<size_t>::max()};
+        static thread_local size_t job_queue_index{no_job_queue};
+
+        static JobGroup frame_job_group;
+
+        /*
+         * Resource Loader Data
+         */
+
+        static SDL_GLContext resource_loader_gl_context{nullptr};
+        static std::thread resource_loader_thread;
+        static bool resource_loader_should_stop{false};
+
+        static std::mutex resource_loader_mutex;
+        static std::condition_variable resource_loader_condition;
+        static std::deque<ResourceUploadJob> pending_resource_uploads;
+        static std::deque<ResourceUploadJob> finished_resource_uploads;
+        static std::deque<ResourceUploadJob> fenced_resource_uploads;
+
+        static const size_t resource_upload_band_size{4 * 1024 * 1024};
+
+        /*
+         * Pixel Conversion Data
+         */
+
+        static const size_t parallel_pixel_conversion_threshold{16 * 1024 * 1024};
+
+        /*
+         * Asynchronous Loading Data
+         */
+
+        static JobGroup async_load_jobs;
+        static std::atomic<bool> async_loaders_should_stop{false};
+
+        static std::mutex async_load_mutex;
+        static std::vector<AsyncLoadJob> pending_async_loads;
+        static std::deque<AsyncLoadJob> completed_async_loads;
+        static uint64_t async_load_sequence{0};
+
+        static Texture placeholder_texture{};
+
+        /*
+         * Texture Streaming Data
+         */
+
+        static std::vector<std::shared_ptr<TextureStream>> texture_streams;
+
+        static std::thread texture_stream_thread;
+        static bool texture_stream_thread_should_stop{false};
+
+        static std::mutex texture_stream_mutex;
+        static std::condition_variable texture_stream_condition;
+        static std::vector<TextureStreamBuffer *> pending_texture_stream_copies;
+
+        static const size_t texture_stream_copy_queue_capacity{64};
+
+        /*
+         * Memory Accounting Data
+         */
+
+        static std::mutex memory_accounting_mutex;
+        static std::vector<std::string> memory_owners{"untagged"};
+        static std::vector<std::array<int64_t, memory_category_count>> memory_usage(1);
+        static std::atomic<unsigned int> current_memory_owner{0};
+
+        /*
+         * Transformation Data
+         */
+
+        static MatrixStack model_matrix_stack;
+        static MatrixStack view_matrix_stack;
+        static MatrixStack projection_matrix_stack;
+        static MatrixStack texture_matrix_stack;
+
+        static MatrixStack *current_matrix_stack = &model_matrix_stack;
+
+        static const size_t matrix_stack_capacity{32};
+
+        /*
+         * Utility Data
+         */
+
+        static std::chrono::system_clock::time_point rendering_start_time;
+        static std::chrono::system_clock::time_point frame_rendering_start_time;
+        static float frame_rendering_delta_time{0.016f};
+        static float time_scale{1.0f};
+
+        /*
+         * Allocation Tracking Data
+         */
+
+        static thread_local bool frame_allocation_tracking{false};
+        static FrameAllocationStatistics current_frame_allocation_statistics;
+        static FrameAllocationStatistics last_frame_allocation_statistics;
+
+        /*
+         * OpenGL State Data
+         */
+
+        static thread_local GLStateCache gl_state;
+
+        /*
+         * Statistics Data
+         */
+
+        static thread_local FrameStatistics current_frame_statistics;
+        static FrameStatistics last_frame_statistics;
+        static std::atomic<size_t> background_uploaded_bytes{0};
+
+        static unsigned int frame_statistics_print_interval{0};
+        static uint64_t frame_count{0};
+
+        /*
+         * Tracing Data
+         */
+
+#ifdef ASR_ENABLE_TRACING
+        static const std::chrono::steady_clock::time_point trace_epoch{std::chrono::steady_clock::now()};
+
+        static std::mutex trace_buffers_mutex;
+        static std::vector<std::shared_ptr<TraceBuffer>> trace_buffers;
+        static thread_local TraceBuffer *thread_trace_buffer{nullptr};
+
+        static TraceBuffer gpu_trace_buffer;
+        static std::vector<GLuint> free_gpu_trace_queries;
+        static std::deque<GpuTraceQuery> pending_gpu_trace_queries;
+        static int64_t gpu_trace_clock_offset{0};
+        static int64_t gpu_trace_clock_calibration_time{0};
+        static bool gpu_trace_clock_calibrated{false};
+#endif
+    }
+
+    namespace utilities
+    {
+        /*
+         * Tracing
+         */
+
+#ifdef ASR_ENABLE_TRACING
+        static inline int64_t get_trace_time()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - data::trace_epoch
+            ).count();
+        }
+
+        static TraceBuffer *get_thread_trace_buffer()
+        {
+            if (data::thread_trace_buffer == nullptr) {
+                auto buffer = std::make_shared<TraceBuffer>();
+
+                std::lock_guard<std::mutex> lock{data::trace_buffers_mutex};
+                buffer->thread_id = static_cast<unsigned int>(data::trace_buffers.size()) + 1;
+                buffer->thread_name = "thread " + std::to_string(buffer->thread_id);
+                data::trace_buffers.push_back(buffer);
+                data::thread_trace_buffer = buffer.get();
+            }
+
+            return data::thread_trace_buffer;
+        }
+
+        static inline void record_trace_event(TraceBuffer &buffer, const char *name, int64_t start_time, int64_t end_time)
+        {
+            size_t index{buffer.count.load(std::memory_order_relaxed)};
+            if (index >= TraceBuffer::capacity) {
+                buffer.dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            buffer.events[index] = TraceEvent{name, start_time, end_time - start_time};
+            buffer.count.store(index + 1, std::memory_order_release);
+        }
+
+        struct TraceScope
+        {
+            const char *name;
+            int64_t start_time;
+
+            explicit TraceScope(const char *name) : name{name}, start_time{get_trace_time()} { }
+
+            ~TraceScope()
+            {
+                record_trace_event(*get_thread_trace_buffer(), name, start_time, get_trace_time());
+            }
+
+            TraceScope(const TraceScope &) = delete;
+            TraceScope &operator=(const TraceScope &) = delete;
+        };
+
+        static GLuint acquire_gpu_trace_query()
+        {
+            if (data::free_gpu_trace_queries.empty()) {
+                GLuint query;
+                glGenQueries(1, &query);
+
+                return query;
+            }
+
+            GLuint query = data::free_gpu_trace_queries.back();
+            data::free_gpu_trace_queries.pop_back();
+
+            return query;
+        }
+
+        static void calibrate_gpu_trace_clock()
+        {
+            GLint64 gpu_time;
+            glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+
+            int64_t cpu_time{get_trace_time()};
+            data::gpu_trace_clock_offset = cpu_time - static_cast<int64_t>(gpu_time);
+            data::gpu_trace_clock_calibration_time = cpu_time;
+            data::gpu_trace_clock_calibrated = true;
+        }
+
+        static void collect_gpu_trace_events()
+        {
+            if (!GLEW_ARB_timer_query) return;
+
+            // The GPU clock drifts from the CPU one, so the mapping between them is refreshed every second.
+            if (!data::gpu_trace_clock_calibrated ||
+                get_trace_time() - data::gpu_trace_clock_calibration_time > 1000000000) {
+                calibrate_gpu_trace_clock();
+            }
+
+            while (!data::pending_gpu_trace_queries.empty()) {
+                GpuTraceQuery &query = data::pending_gpu_trace_queries.front();
+
+                GLint available{GL_FALSE};
+                glGetQueryObjectiv(query.end_query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == GL_FALSE) break;
+
+                GLuint64 start_time, end_time;
+                glGetQueryObjectui64v(query.start_query, GL_QUERY_RESULT, &start_time);
+                glGetQueryObjectui64v(query.end_query, GL_QUERY_RESULT, &end_time);
+                record_trace_event(
+                    data::gpu_trace_buffer, query.name,
+                    static_cast<int64_t>(start_time) + data::gpu_trace_clock_offset,
+                    static_cast<int64_t>(end_time) + data::gpu_trace_clock_offset
+                );
+
+                data::free_gpu_trace_queries.push_back(query.start_query);
+                data::free_gpu_trace_queries.push_back(query.end_query);
+                data::pending_gpu_trace_queries.pop_front();
+            }
+        }
+
+        struct GpuTraceScope
+        {
+            TraceScope cpu_scope;
+            GpuTraceQuery query{nullptr, 0, 0};
+
+            explicit GpuTraceScope(const char *name) : cpu_scope{name}
+            {
+                if (!GLEW_ARB_timer_query) return;
+
+                query = GpuTraceQuery{name, acquire_gpu_trace_query(), acquire_gpu_trace_query()};
+                glQueryCounter(query.start_query, GL_TIMESTAMP);
+            }
+
+            ~GpuTraceScope()
+            {
+                if (query.name == nullptr) return;
+
+                glQueryCounter(query.end_query, GL_TIMESTAMP);
+                data::pending_gpu_trace_queries.push_back(query);
+            }
+
+            GpuTraceScope(const GpuTraceScope &) = delete;
+            GpuTraceScope &operator=(const GpuTraceScope &) = delete;
+        };
+
+        static void write_trace_string(std::ostream &stream, const std::string &string)
+        {
+            stream << '"';
+            for (char character : string) {
+                if (character == '"' || character == '\\') {
+                    stream << '\\' << character;
+                } else if (static_cast<unsigned char>(character) < 0x20) {
+                    stream << ' ';
+                } else {
+                    stream << character;
+                }
+            }
+            stream << '"';
+        }
+
+        static void write_trace_buffer(std::ostream &stream, const TraceBuffer &buffer, bool &first_event)
+        {
+            stream << (first_event ? "" : ",\n")
+                   << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer.thread_id
+                   << R"(,"args":{"name":)";
+            write_trace_string(stream, buffer.thread_name);
+            stream << "}}";
+            first_event = false;
+
+            size_t count{std::min(buffer.count.load(std::memory_order_acquire), TraceBuffer::capacity)};
+            for (size_t i = 0; i < count; ++i) {
+                const TraceEvent &event = buffer.events[i];
+                stream << ",\n" << R"({"name":)";
+                write_trace_string(stream, event.name);
+                stream << R"(,"ph":"X","pid":1,"tid":)" << buffer.thread_id
+                       << R"(,"ts":)" << std::fixed << std::setprecision(3) << static_cast<double>(event.start_time) / 1000.0
+                       << R"(,"dur":)" << static_cast<double>(event.duration) / 1000.0 << "}";
+            }
+        }
+#endif
+
+        /*
+         * OpenGL Calls
+         */
+
+        static inline bool skip_redundant_call()
+        {
+            ++data::current_frame_statistics.redundant_calls_skipped;
+            return true;
+        }
+
+        static inline void use_program(GLuint program)
+        {
+            if (data::gl_state.program == program && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.program_binds;
+            data::gl_state.program = program;
+            glUseProgram(program);
+        }
+
+        static inline void bind_vertex_array(GLuint vertex_array_object)
+        {
+            if (data::gl_state.vertex_array_object == vertex_array_object && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.vertex_array_binds;
+            data::gl_state.vertex_array_object = vertex_array_object;
+#ifdef __APPLE__
+            glBindVertexArrayAPPLE(vertex_array_object);
+#else
+            glBindVertexArray(vertex_array_object);
+#endif
+        }
+
+        static inline void set_active_texture_unit(unsigned int unit)
+        {
+            if (data::gl_state.active_texture_unit == unit && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.active_texture_unit = unit;
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+
+        static inline void bind_texture(GLenum target, GLuint texture_object)
+        {
+            GLuint &bound_texture = data::gl_state.bound_textures[data::gl_state.active_texture_unit];
+            GLenum &bound_target = data::gl_state.bound_texture_targets[data::gl_state.active_texture_unit];
+            if (bound_texture == texture_object && bound_target == target && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.texture_binds;
+            bound_texture = texture_object;
+            bound_target = target;
+            glBindTexture(target, texture_object);
+        }
+
+        static inline void bind_buffer(GLenum target, GLuint buffer_object)
+        {
+            // The element array binding is part of the vertex array object, so only the array buffer is shadowed.
+            if (target == GL_ARRAY_BUFFER) {
+                if (data::gl_state.array_buffer == buffer_object && skip_redundant_call()) return;
+                data::gl_state.array_buffer = buffer_object;
+            }
+
+            ++data::current_frame_statistics.buffer_binds;
+            glBindBuffer(target, buffer_object);
+        }
+
+        static inline void upload_buffer_data(GLenum target, size_t size, const GLvoid *buffer_data, GLenum usage)
+        {
+            data::current_frame_statistics.uploaded_bytes += size;
+            glBufferData(target, static_cast<GLsizeiptr>(size), buffer_data, usage);
+        }
+
+        static inline void count_uploaded_bytes(size_t size)
+        {
+            data::current_frame_statistics.uploaded_bytes += size;
+        }
+
+        static inline int8_t *find_cached_capability(GLenum capability)
+        {
+            switch (capability) {
+                case GL_DEPTH_TEST:
+                    return &data::gl_state.depth_test;
+                case GL_CULL_FACE:
+                    return &data::gl_state.face_culling;
+                case GL_BLEND:
+                    return &data::gl_state.blending;
+                case GL_PROGRAM_POINT_SIZE:
+                    return &data::gl_state.program_point_size;
+                case GL_POINT_SPRITE:
+                    return &data::gl_state.point_sprite;
+                case GL_POLYGON_OFFSET_FILL:
+                    return &data::gl_state.polygon_offset_fill;
+                default:
+                    return nullptr;
+            }
+        }
+
+        static inline void set_capability(GLenum capability, bool enabled)
+        {
+            int8_t *cached_state = find_cached_capability(capability);
+            if (cached_state != nullptr) {
+                if (*cached_state == static_cast<int8_t>(enabled) && skip_redundant_call()) return;
+                *cached_state = static_cast<int8_t>(enabled);
+            }
+
+            ++data::current_frame_statistics.state_changes;
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+
+        // Core profiles always rasterize points as sprites and reject GL_POINT_SPRITE.
+        static void enable_point_sprites()
+        {
+            if (!GLEW_VERSION_3_1 || GLEW_ARB_compatibility) {
+                set_capability(GL_POINT_SPRITE, true);
+            }
+        }
+
+        static inline void set_depth_function(GLenum function)
+        {
+            if (data::gl_state.depth_function == function && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.depth_function = function;
+            glDepthFunc(function);
+        }
+
+        static inline void set_front_face(GLenum mode)
+        {
+            if (data::gl_state.front_face == mode && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.front_face = mode;
+            glFrontFace(mode);
+        }
+
+        static inline void set_cull_face(GLenum mode)
+        {
+            if (data::gl_state.cull_face == mode && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.cull_face = mode;
+            glCullFace(mode);
+        }
+
+        static inline void set_blend_function(
+                               GLenum source_factor, GLenum destination_factor,
+                               GLenum source_alpha_factor, GLenum destination_alpha_factor
+                           )
+        {
+            if (data::gl_state.blend_source_factor == source_factor &&
+                data::gl_state.blend_destination_factor == destination_factor &&
+                data::gl_state.blend_source_alpha_factor == source_alpha_factor &&
+                data::gl_state.blend_destination_alpha_factor == destination_alpha_factor && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.blend_source_factor = source_factor;
+            data::gl_state.blend_destination_factor = destination_factor;
+            data::gl_state.blend_source_alpha_factor = source_alpha_factor;
+            data::gl_state.blend_destination_alpha_factor = destination_alpha_factor;
+            glBlendFuncSeparate(source_factor, destination_factor, source_alpha_factor, destination_alpha_factor);
+        }
+
+        static inline void set_blend_function(GLenum source_factor, GLenum destination_factor)
+        {
+            set_blend_function(source_factor, destination_factor, source_factor, destination_factor);
+        }
+
+        static inline void set_depth_writes(bool enabled)
+        {
+            if (data::gl_state.depth_writes == static_cast<int8_t>(enabled) && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.depth_writes = static_cast<int8_t>(enabled);
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        }
+
+        static inline void set_viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            std::array<GLint, 4> viewport{x, y, width, height};
+            if (data::gl_state.viewport == viewport && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.viewport = viewport;
+            glViewport(x, y, width, height);
+        }
+
+        static inline void set_line_width(GLfloat line_width)
+        {
+            if (data::gl_state.line_width == line_width && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.line_width = line_width;
+            glLineWidth(line_width);
+        }
+
+        static inline void set_polygon_offset(GLfloat factor, GLfloat units)
+        {
+            if (data::gl_state.polygon_offset_factor == factor &&
+                data::gl_state.polygon_offset_units == units && skip_redundant_call()) return;
+
+            ++data::current_frame_statistics.state_changes;
+            data::gl_state.polygon_offset_factor = factor;
+            data::gl_state.polygon_offset_units = units;
+            glPolygonOffset(factor, units);
+        }
+
+        static void forget_deleted_texture(GLuint texture_object)
+        {
+            for (auto &bound_texture : data::gl_state.bound_textures) {
+                if (bound_texture == texture_object) bound_texture = 0;
+            }
+        }
+
+        static void forget_deleted_vertex_array(GLuint vertex_array_object)
+        {
+            if (data::gl_state.vertex_array_object == vertex_array_object) data::gl_state.vertex_array_object = 0;
+        }
+
+        static void forget_deleted_buffer(GLuint buffer_object)
+        {
+            if (data::gl_state.array_buffer == buffer_object) data::gl_state.array_buffer = 0;
+        }
+
+        static void forget_deleted_program(GLuint program)
+        {
+            if (data::gl_state.program == program) data::gl_state.program = 0;
+        }
+
+        static inline void set_texture_parameter(GLenum target, GLenum parameter, GLint value)
+        {
+            ++data::current_frame_statistics.state_changes;
+            glTexParameteri(target, parameter, value);
+        }
+
+        static inline void set_texture_parameter(GLenum target, GLenum parameter, GLfloat value)
+        {
+            ++data::current_frame_statistics.state_changes;
+            glTexParameterf(target, parameter, value);
+        }
+
+        static inline void set_uniform(GLint location, GLint value)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform1i(location, value);
+        }
+
+        static inline void set_uniform(GLint location, GLfloat value)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform1f(location, value);
+        }
+
+        static inline void set_uniform(GLint location, GLfloat x, GLfloat y)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform2f(location, x, y);
+        }
+
+        static inline void set_uniform(GLint location, GLsizei count, const GLint *values)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform1iv(location, count, values);
+        }
+
+        static inline void set_uniform(GLint location, const glm::vec2 &vector)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform2fv(location, 1, glm::value_ptr(vector));
+        }
+
+        static inline void set_uniform(GLint location, const glm::vec3 &vector)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform3fv(location, 1, glm::value_ptr(vector));
+        }
+
+        static inline void set_uniform(GLint location, const glm::vec4 &vector)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniform4fv(location, 1, glm::value_ptr(vector));
+        }
+
+        static inline void set_uniform(GLint location, const glm::mat4 &matrix)
+        {
+            ++data::current_frame_statistics.uniform_uploads;
+            glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+        }
+
+        static inline void draw_elements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+        {
+            ++data::current_frame_statistics.draw_calls;
+            data::current_frame_statistics.drawn_indices += static_cast<size_t>(count);
+            glDrawElements(mode, count, type, indices);
+        }
+
+        static inline void draw_arrays(GLenum mode, GLint first, GLsizei count)
+        {
+            ++data::current_frame_statistics.draw_calls;
+            data::current_frame_statistics.drawn_indices += static_cast<size_t>(count);
+            glDrawArrays(mode, first, count);
+        }
+
+        static void print_frame_statistics(const FrameStatistics &statistics)
+        {
+            std::cout << "Frame " << data::frame_count << ": "
+                      << statistics.draw_calls << " draws (" << statistics.drawn_indices << " indices), "
+                      << statistics.program_binds << " program binds, "
+                      << statistics.vertex_array_binds << " VAO binds, "
+                      << statistics.texture_binds << " texture binds, "
+                      << statistics.buffer_binds << " buffer binds, "
+                      << statistics.uniform_uploads << " uniform uploads, "
+                      << statistics.state_changes << " state changes, "
+                      << statistics.uploaded_bytes << " bytes uploaded ("
+                      << statistics.background_uploaded_bytes << " in the background), "
+                      << statistics.redundant_calls_skipped << " redundant calls skipped" << std::endl;
+        }
+
+        /*
+         * Memory Accounting
+         */
+
+        static void account_memory(MemoryCategory category, unsigned int owner, int64_t byte_delta)
+        {
+            std::lock_guard<std::mutex> lock{data::memory_accounting_mutex};
+            if (owner >= data::memory_usage.size()) owner = 0;
+
+            data::memory_usage[owner][category] += byte_delta;
+        }
+
+        static unsigned int get_current_memory_owner()
+        {
+            return data::current_memory_owner.load(std::memory_order_relaxed);
+        }
+
+        // For buffers that are overwritten whole right after, such as converted pixels.
+        template<typename T, MemoryCategory category>
+        static void resize_uninitialized(std::vector<T, MemoryTrackingAllocator<T, category>> &vector, size_t size)
+        {
+            MemoryTrackingAllocator<T, category>::skip_value_initialization = true;
+            vector.resize(size);
+            MemoryTrackingAllocator<T, category>::skip_value_initialization = false;
+        }
+
+        static size_t calculate_texture_memory_size(
+                          unsigned int width, unsigned int height, unsigned int channels,
+                          bool with_mipmaps
+                      )
+        {
+            // Drivers store three-channel textures with a padding byte per texel.
+            size_t bytes_per_texel{channels == 3 ? 4u : channels};
+
+            size_t size{0};
+            for (;;) {
+                size += static_cast<size_t>(width) * height * bytes_per_texel;
+                if (!with_mipmaps || (width == 1 && height == 1)) break;
+
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+            }
+
+            return size;
+        }
+
+        /*
+         * Allocation Tracking
+         */
+
+        static inline void record_allocation(size_t size)
+        {
+            if (data::frame_allocation_tracking) {
+                ++data::current_frame_allocation_statistics.allocation_count;
+                data::current_frame_allocation_statistics.allocated_bytes += size;
+            }
+        }
+
+        static inline void record_deallocation()
+        {
+            if (data::frame_allocation_tracking) {
+                ++data::current_frame_allocation_statistics.deallocation_count;
+            }
+        }
+
+        // Out of line, so the compiler cannot match malloc() against a delete expression it inlined a hook into.
+        ASR_NOINLINE static void *allocate_tracked_memory(size_t size, size_t alignment) noexcept
+        {
+            record_allocation(size);
+
+            size = size == 0 ? 1 : size;
+            if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#ifdef _WIN32
+            return _aligned_malloc(size, alignment);
+#else
+            void *pointer{nullptr};
+            if (posix_memalign(&pointer, std::max(alignment, sizeof(void *)), size) != 0) return nullptr;
+
+            return pointer;
+#endif
+        }
+
+        ASR_NOINLINE static void free_tracked_memory(void *pointer, size_t alignment) noexcept
+        {
+            if (pointer == nullptr) return;
+
+            record_deallocation();
+#ifdef _WIN32
+            if (alignment > alignof(std::max_align_t)) {
+                _aligned_free(pointer);
+                return;
+            }
+#else
+            static_cast<void>(alignment);
+#endif
+            std::free(pointer);
+        }
+
+        /*
+         * Transformation
+         */
+
+        static void reset_matrix_stack(MatrixStack &stack)
+        {
+            std::vector<glm::mat4> storage;
+            storage.reserve(data::matrix_stack_capacity);
+            storage.push_back(glm::mat4{1.0f});
+
+            stack = MatrixStack{std::move(storage)};
+        }
+
+        /*
+         * Geometry Handling
+         */
+
+        static GLenum convert_geometry_type_to_es2_geometry_type(GeometryType type)
+        {
+            switch (type) {
+                case GeometryType::Points:
+                    return GL_POINTS;
+                case GeometryType::Lines:
+                    return GL_LINES;
+                case GeometryType::LineLoop:
+                    return GL_LINE_LOOP;
+                case GeometryType::LineStrip:
+                    return GL_LINE_STRIP;
+                case GeometryType::Triangles:
+                    return GL_TRIANGLES;
+                case GeometryType::TriangleFan:
+                    return GL_TRIANGLE_FAN;
+                case GeometryType::TriangleStrip:
+                    return GL_TRIANGLE_STRIP;
+            }
+
+            return GL_TRIANGLES;
+        }
+
+        /*
+         * Job System
+         */
+
+        static void notify_job_waiters()
+        {
+            ++data::job_event_count;
+            if (data::job_waiter_count == 0) return;
+
+            { std::lock_guard<std::mutex> lock{data::job_sleep_mutex}; }
+            data::job_wait_condition.notify_all();
+        }
+
+        static void enqueue_job(const JobHandle &job)
+        {
+            // Counting before pushing keeps a thread that takes the job right away from taking the count below zero.
+            if (job->background) {
+                ++data::queued_background_job_count;
+                std::lock_guard<std::mutex> lock{data::background_job_queue.mutex};
+                data::background_job_queue.jobs.push_back(job);
+            } else {
+                ++data::queued_job_count;
+                size_t queue_index{std::min(data::job_queue_index, data::job_queues.size() - 1)};
+                JobQueue &queue = data::job_queues[queue_index];
+                std::lock_guard<std::mutex> lock{queue.mutex};
+                queue.jobs.push_back(job);
+            }
+
+            // Taking the lock orders this wake-up after any worker that is between its check and its wait.
+            { std::lock_guard<std::mutex> lock{data::job_sleep_mutex}; }
+            data::job_sleep_condition.notify_one();
+            if (!job->background) notify_job_waiters();
+        }
+
+        static void run_job(const JobHandle &job)
+        {
+            job->function();
+            job->function = nullptr;
+
+            std::vector<JobHandle> continuations;
+            {
+                std::lock_guard<std::mutex> lock{job->continuation_mutex};
+                job->finished = true;
+                continuations.swap(job->continuations);
+            }
+            for (const auto &continuation : continuations) {
+                if (--continuation->unfinished_dependency_count == 0) enqueue_job(continuation);
+            }
+
+            if (job->group) --job->group->unfinished_job_count;
+            notify_job_waiters();
+        }
+
+        // Other threads only take the jobs they wait for, so a wait on the render thread never runs unrelated work.
+        static bool try_run_job(const Job *awaited_job = nullptr, const JobGroup *awaited_group = nullptr)
+        {
+            if (!data::job_system_running || data::queued_job_count == 0) return false;
+            size_t queue_count{data::job_queues.size()};
+
+            size_t own_queue_index{std::min(data::job_queue_index, queue_count - 1)};
+            bool is_worker{data::job_queue_index != data::no_job_queue};
+            bool takes_any_job{is_worker || (awaited_job == nullptr && awaited_group == nullptr)};
+
+            JobHandle job;
+            for (size_t i = 0; i < queue_count && !job; ++i) {
+                JobQueue &queue = data::job_queues[(own_queue_index + i) % queue_count];
+                std::lock_guard<std::mutex> lock{queue.mutex};
+                if (queue.jobs.empty()) continue;
+
+                if (i == 0 && is_worker) {
+                    job = std::move(queue.jobs.back());
+                    queue.jobs.pop_back();
+                } else if (takes_any_job) {
+                    job = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                } else {
+                    auto awaited = std::find_if(queue.jobs.begin(), queue.jobs.end(), [=](const JobHandle &queued_job) {
+                        return queued_job.get() == awaited_job || (awaited_group && queued_job->group == awaited_group);
+                    });
+                    if (awaited == queue.jobs.end()) continue;
+
+                    job = std::move(*awaited);
+                    queue.jobs.erase(awaited);
+                }
+            }
+            if (!job) return false;
+
+            --data::queued_job_count;
+            run_job(job);
+
+            return true;
+        }
+
+        static bool can_start_background_job()
+        {
+            return data::queued_background_job_count > 0 &&
+                   data::running_background_job_count < data::max_running_background_jobs;
+        }
+
+        static bool try_run_background_job()
+        {
+            size_t running_count{data::running_background_job_count};
+            do {
+                if (running_count >= data::max_running_background_jobs) return false;
+            } while (!data::running_background_job_count.compare_exchange_weak(running_count, running_count + 1));
+
+            JobHandle job;
+            {
+                std::lock_guard<std::mutex> lock{data::background_job_queue.mutex};
+                if (!data::background_job_queue.jobs.empty()) {
+                    job = std::move(data::background_job_queue.jobs.front());
+                    data::background_job_queue.jobs.pop_front();
+                }
+            }
+            if (job) {
+                --data::queued_background_job_count;
+                run_job(job);
+            }
+            --data::running_background_job_count;
+
+            // The slot this job held may be the one another worker is waiting for.
+            if (data::queued_background_job_count > 0) {
+                { std::lock_guard<std::mutex> lock{data::job_sleep_mutex}; }
+                data::job_sleep_condition.notify_one();
+            }
+
+            return job != nullptr;
+        }
+
+        static void run_job_worker(size_t queue_index)
+        {
+#ifdef ASR_ENABLE_TRACING
+            get_thread_trace_buffer()->thread_name = "job worker " + std::to_string(queue_index);
+#endif
+            data::job_queue_index = queue_index;
+
+            for (;;) {
+                if (try_run_job() || try_run_background_job()) continue;
+
+                std::unique_lock<std::mutex> lock{data::job_sleep_mutex};
+                data::job_sleep_condition.wait(lock, [] {
+                    return data::job_workers_should_stop || data::queued_job_count > 0 || can_start_background_job();
+                });
+                if (data::job_workers_should_stop) break;
+            }
+        }
+
+        static void start_job_system()
+        {
+            if (data::job_system_running) return;
+
+            std::lock_guard<std::mutex> lock{data::job_system_mutex};
+            if (data::job_system_running) return;
+
+            size_t worker_count{std::max(1u, std::thread::hardware_concurrency()) - 1};
+            worker_count = std::max<size_t>(1, worker_count);
+            for (size_t i = 0; i <= worker_count; ++i) {
+                data::job_queues.emplace_back();
+            }
+            data::max_running_background_jobs = std::max<size_t>(1, worker_count - 1);
+
+            data::job_workers_should_stop = false;
+            for (size_t i = 0; i < worker_count; ++i) {
+                data::job_workers.emplace_back(run_job_worker, i);
+            }
+            data::job_system_running = true;
+        }
+
+        static size_t get_job_worker_count()
+        {
+            start_job_system();
+            return data::job_workers.size();
+        }
+
+        static JobHandle schedule_job(
+                             std::function<void()> function,
+                             const std::vector<JobHandle> &dependencies,
+                             JobGroup *group,
+                             bool background = false
+                         )
+        {
+            start_job_system();
+
+            auto job = std::make_shared<Job>();
+            job->function = std::move(function);
+            job->group = group;
+            job->background = background;
+            if (group) ++group->unfinished_job_count;
+
+            // The extra count keeps dependencies that finish during the loop from queueing the job early.
+            job->unfinished_dependency_count = 1;
+            for (const auto &dependency : dependencies) {
+                std::lock_guard<std::mutex> lock{dependency->continuation_mutex};
+                if (!dependency->finished) {
+                    ++job->unfinished_dependency_count;
+                    dependency->continuations.push_back(job);
+                }
+            }
+            if (--job->unfinished_dependency_count == 0) enqueue_job(job);
+
+            return job;
+        }
+
+        // The event count is read before checking, so a job that finishes in between is not missed.
+        template<typename IsFinished>
+        static void wait_for_jobs(const Job *awaited_job, const JobGroup *awaited_group, IsFinished is_finished)
+        {
+            ++data::job_waiter_count;
+            for (;;) {
+                uint64_t seen_event_count{data::job_event_count};
+                if (is_finished()) break;
+                if (try_run_job(awaited_job, awaited_group)) continue;
+
+                std::unique_lock<std::mutex> lock{data::job_sleep_mutex};
+                data::job_wait_condition.wait(lock, [seen_event_count] {
+                    return data::job_event_count != seen_event_count;
+                });
+            }
+            --data::job_waiter_count;
+        }
+
+        static void wait_for_job(const JobHandle &job)
+        {
+            wait_for_jobs(job.get(), nullptr, [&job] { return job->finished.load(); });
+        }
+
+        static void wait_for_job_group(JobGroup &group)
+        {
+            wait_for_jobs(nullptr, &group, [&group] { return group.unfinished_job_count == 0; });
+        }
+
+        // Without a grain size every thread gets about four ranges.
+        static void parallel_for(
+                        size_t begin, size_t end,
+                        const std::function<void(size_t, size_t)> &function,
+                        size_t grain_size = 0
+                    )
+        {
+            if (begin >= end) return;
+
+            size_t count{end - begin};
+            size_t worker_count{get_job_worker_count()};
+            if (grain_size == 0) grain_size = std::max<size_t>(1, count / ((worker_count + 1) * 4));
+            size_t range_count{(count + grain_size - 1) / grain_size};
+            if (range_count == 1) {
+                function(begin, end);
+                return;
+            }
+
+            struct ParallelForState
+            {
+                std::atomic<size_t> next_range{0};
+                JobGroup group;
+            } state;
+            auto run_ranges = [&state, &function, begin, end, grain_size, range_count]() {
+                for (size_t range = state.next_range++; range < range_count; range = state.next_range++) {
+                    size_t range_begin{begin + range * grain_size};
+                    function(range_begin, std::min(end, range_begin + grain_size));
+                }
+            };
+
+            size_t helper_count{std::min(worker_count, range_count - 1)};
+            for (size_t i = 0; i < helper_count; ++i) {
+                schedule_job(run_ranges, {}, &state.group);
+            }
+            run_ranges();
+            wait_for_job_group(state.group);
+        }
+
+        static void run_parallel_tasks(size_t task_count, const std::function<void(size_t)> &task)
+        {
+            parallel_for(0, task_count, [&task](size_t first_task, size_t last_task) {
+                for (size_t i = first_task; i < last_task; ++i) {
+                    task(i);
+                }
+            }, 1);
+        }
+
+        static void stop_job_system()
+        {
+            if (!data::job_system_running) return;
+
+            wait_for_jobs(nullptr, nullptr, [] {
+                return data::queued_job_count == 0 && data::queued_background_job_count == 0;
+            });
+
+            {
+                std::lock_guard<std::mutex> lock{data::job_sleep_mutex};
+                data::job_workers_should_stop = true;
+            }
+            data::job_sleep_condition.notify_all();
+            for (auto &worker : data::job_workers) {
+                worker.join();
+            }
+
+            std::lock_guard<std::mutex> lock{data::job_system_mutex};
+            data::job_workers.clear();
+            data::job_queues.clear();
+            data::job_system_running = false;
+        }
+
+        /*
+         * Pixel Conversion
+         */
+
+        static inline uint8_t multiply_by_alpha(unsigned int value, unsigned int alpha)
+        {
+            // Rounds value * alpha / 255 exactly without a division.
+            unsigned int product{value * alpha + 128};
+            return static_cast<uint8_t>((product + (product >> 8)) >> 8);
+        }
+
+        static const std::array<uint8_t, 256> &get_srgb_to_linear_table()
+        {
+            static const std::array<uint8_t, 256> table = [] {
+                std::array<uint8_t, 256> result{};
+                for (unsigned int i = 0; i < 256; ++i) {
+                    float value{static_cast<float>(i) / 255.0f};
+                    value = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                    result[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+                }
+                return result;
+            }();
+
+            return table;
+        }
+
+        static const std::array<uint8_t, 256> &get_linear_to_srgb_table()
+        {
+            static const std::array<uint8_t, 256> table = [] {
+                std::array<uint8_t, 256> result{};
+                for (unsigned int i = 0; i < 256; ++i) {
+                    float value{static_cast<float>(i) / 255.0f};
+                    value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    result[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+                }
+                return result;
+            }();
+
+            return table;
+        }
+
+#ifdef ASR_PIXEL_KERNELS_AVX2
+        static bool is_avx2_supported()
+        {
+#if defined(__GNUC__)
+            static const bool supported{__builtin_cpu_supports("avx2") != 0};
+            return supported;
+#else
+            return true;
+#endif
+        }
+
+        ASR_TARGET_AVX2 static size_t expand_rgb_to_rgba_avx2(const uint8_t *source, uint8_t *destination, size_t count)
+        {
+            const __m256i shuffle = _mm256_setr_epi8(
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+            );
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+            // Each lane loads 16 bytes for its 12, so the loop stops while the overread is still in bounds.
+            size_t i{0};
+            for (; i + 10 <= count; i += 8) {
+                __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3));
+                __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3 + 12));
+                __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+                pixels = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), alpha);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * 4), pixels);
+            }
+
+            return i;
+        }
+
+        ASR_TARGET_AVX2 static size_t premultiply_rgba_avx2(uint8_t *pixels, size_t count)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i color_mask = _mm256_set1_epi64x(0x0000FFFFFFFFFFFFll);
+            const __m256i alpha_factor = _mm256_set1_epi64x(0x00FF000000000000ll);
+            const __m256i rounding = _mm256_set1_epi16(128);
+
+            size_t i{0};
+            for (; i + 8 <= count; i += 8) {
+                __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i * 4));
+
+                __m256i halves[2] = {_mm256_unpacklo_epi8(values, zero), _mm256_unpackhi_epi8(values, zero)};
+                for (auto &half : halves) {
+                    __m256i alphas = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(half, 0xFF), 0xFF);
+                    alphas = _mm256_or_si256(_mm256_and_si256(alphas, color_mask), alpha_factor);
+
+                    half = _mm256_add_epi16(_mm256_mullo_epi16(half, alphas), rounding);
+                    half = _mm256_srli_epi16(_mm256_add_epi16(half, _mm256_srli_epi16(half, 8)), 8);
+                }
+
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(pixels + i * 4),
+                    _mm256_packus_epi16(halves[0], halves[1])
+                );
+            }
+
+            return i;
+        }
+
+        ASR_TARGET_AVX2 static size_t swizzle_rgba_to_bgra_avx2(uint8_t *pixels, size_t count)
+        {
+            const __m256i shuffle = _mm256_setr_epi8(
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+            );
+
+            size_t i{0};
+            for (; i + 8 <= count; i += 8) {
+                __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i * 4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixels + i * 4), _mm256_shuffle_epi8(values, shuffle));
+            }
+
+            return i;
+        }
+#endif
+
+        static void expand_gray_to_rgba(const uint8_t *source, uint8_t *destination, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16_t luminance = vld1q_u8(source + i);
+                uint8x16x4_t pixels = {{luminance, luminance, luminance, vdupq_n_u8(255)}};
+                vst4q_u8(destination + i * 4, pixels);
+            }
+#elif defined(ASR_PIXEL_KERNELS_SSE2)
+            const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+            for (; i + 16 <= count; i += 16) {
+                __m128i luminance = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+                __m128i pairs_low = _mm_unpacklo_epi8(luminance, luminance);
+                __m128i pairs_high = _mm_unpackhi_epi8(luminance, luminance);
+                __m128i alphas_low = _mm_unpacklo_epi8(luminance, alpha);
+                __m128i alphas_high = _mm_unpackhi_epi8(luminance, alpha);
+
+                auto *output = reinterpret_cast<__m128i *>(destination + i * 4);
+                _mm_storeu_si128(output + 0, _mm_unpacklo_epi16(pairs_low, alphas_low));
+                _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(pairs_low, alphas_low));
+                _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(pairs_high, alphas_high));
+                _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(pairs_high, alphas_high));
+            }
+#endif
+            for (; i < count; ++i) {
+                destination[i * 4 + 0] = source[i];
+                destination[i * 4 + 1] = source[i];
+                destination[i * 4 + 2] = source[i];
+                destination[i * 4 + 3] = 255;
+            }
+        }
+
+        static void expand_gray_alpha_to_rgba(const uint8_t *source, uint8_t *destination, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x2_t gray_alpha = vld2q_u8(source + i * 2);
+                uint8x16x4_t pixels = {{gray_alpha.val[0], gray_alpha.val[0], gray_alpha.val[0], gray_alpha.val[1]}};
+                vst4q_u8(destination + i * 4, pixels);
+            }
+#elif defined(ASR_PIXEL_KERNELS_SSE2)
+            const __m128i luminance_mask = _mm_set1_epi16(0x00FF);
+            for (; i + 8 <= count; i += 8) {
+                __m128i gray_alpha = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 2));
+                __m128i luminance = _mm_and_si128(gray_alpha, luminance_mask);
+                __m128i pairs = _mm_or_si128(luminance, _mm_slli_epi16(luminance, 8));
+
+                auto *output = reinterpret_cast<__m128i *>(destination + i * 4);
+                _mm_storeu_si128(output + 0, _mm_unpacklo_epi16(pairs, gray_alpha));
+                _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(pairs, gray_alpha));
+            }
+#endif
+            for (; i < count; ++i) {
+                destination[i * 4 + 0] = source[i * 2];
+                destination[i * 4 + 1] = source[i * 2];
+                destination[i * 4 + 2] = source[i * 2];
+                destination[i * 4 + 3] = source[i * 2 + 1];
+            }
+        }
+
+        static void expand_rgb_to_rgba(const uint8_t *source, uint8_t *destination, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x3_t rgb = vld3q_u8(source + i * 3);
+                uint8x16x4_t pixels = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(255)}};
+                vst4q_u8(destination + i * 4, pixels);
+            }
+#elif defined(ASR_PIXEL_KERNELS_SSE2)
+#ifdef ASR_PIXEL_KERNELS_AVX2
+            if (is_avx2_supported()) {
+                i = expand_rgb_to_rgba_avx2(source, destination, count);
+            }
+#endif
+            const __m128i lane_masks[4] = {
+                _mm_setr_epi32(0x00FFFFFF, 0, 0, 0),
+                _mm_setr_epi32(0, 0x00FFFFFF, 0, 0),
+                _mm_setr_epi32(0, 0, 0x00FFFFFF, 0),
+                _mm_setr_epi32(0, 0, 0, 0x00FFFFFF)
+            };
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            for (; i + 6 <= count; i += 4) {
+                __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3));
+                __m128i pixels = _mm_or_si128(
+                    _mm_or_si128(
+                        _mm_and_si128(rgb, lane_masks[0]),
+                        _mm_and_si128(_mm_slli_si128(rgb, 1), lane_masks[1])
+                    ),
+                    _mm_or_si128(
+                        _mm_and_si128(_mm_slli_si128(rgb, 2), lane_masks[2]),
+                        _mm_and_si128(_mm_slli_si128(rgb, 3), lane_masks[3])
+                    )
+                );
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4), _mm_or_si128(pixels, alpha));
+            }
+#endif
+            for (; i < count; ++i) {
+                destination[i * 4 + 0] = source[i * 3 + 0];
+                destination[i * 4 + 1] = source[i * 3 + 1];
+                destination[i * 4 + 2] = source[i * 3 + 2];
+                destination[i * 4 + 3] = 255;
+            }
+        }
+
+        static void premultiply_rgba(uint8_t *pixels, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t values = vld4q_u8(pixels + i * 4);
+                for (int channel = 0; channel < 3; ++channel) {
+                    uint16x8_t low = vmull_u8(vget_low_u8(values.val[channel]), vget_low_u8(values.val[3]));
+                    uint16x8_t high = vmull_u8(vget_high_u8(values.val[channel]), vget_high_u8(values.val[3]));
+                    values.val[channel] = vcombine_u8(
+                        vrshrn_n_u16(vrsraq_n_u16(low, low, 8), 8),
+                        vrshrn_n_u16(vrsraq_n_u16(high, high, 8), 8)
+                    );
+                }
+                vst4q_u8(pixels + i * 4, values);
+            }
+#elif defined(ASR_PIXEL_KERNELS_SSE2)
+#ifdef ASR_PIXEL_KERNELS_AVX2
+            if (is_avx2_supported()) {
+                i = premultiply_rgba_avx2(pixels, count);
+            }
+#endif
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i color_mask = _mm_set1_epi64x(0x0000FFFFFFFFFFFFll);
+            const __m128i alpha_factor = _mm_set1_epi64x(0x00FF000000000000ll);
+            const __m128i rounding = _mm_set1_epi16(128);
+            for (; i + 4 <= count; i += 4) {
+                __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i * 4));
+
+                // Alpha is multiplied by 255 in its own lane, which the rounding division maps back to itself.
+                __m128i halves[2] = {_mm_unpacklo_epi8(values, zero), _mm_unpackhi_epi8(values, zero)};
+                for (auto &half : halves) {
+                    __m128i alphas = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, 0xFF), 0xFF);
+                    alphas = _mm_or_si128(_mm_and_si128(alphas, color_mask), alpha_factor);
+
+                    half = _mm_add_epi16(_mm_mullo_epi16(half, alphas), rounding);
+                    half = _mm_srli_epi16(_mm_add_epi16(half, _mm_srli_epi16(half, 8)), 8);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i * 4), _mm_packus_epi16(halves[0], halves[1]));
+            }
+#endif
+            for (; i < count; ++i) {
+                uint8_t alpha{pixels[i * 4 + 3]};
+                pixels[i * 4 + 0] = multiply_by_alpha(pixels[i * 4 + 0], alpha);
+                pixels[i * 4 + 1] = multiply_by_alpha(pixels[i * 4 + 1], alpha);
+                pixels[i * 4 + 2] = multiply_by_alpha(pixels[i * 4 + 2], alpha);
+            }
+        }
+
+        static void premultiply_gray_alpha(uint8_t *pixels, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                pixels[i * 2] = multiply_by_alpha(pixels[i * 2], pixels[i * 2 + 1]);
+            }
+        }
+
+        static void swizzle_rgba_to_bgra(uint8_t *pixels, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t values = vld4q_u8(pixels + i * 4);
+                std::swap(values.val[0], values.val[2]);
+                vst4q_u8(pixels + i * 4, values);
+            }
+#elif defined(ASR_PIXEL_KERNELS_SSE2)
+#ifdef ASR_PIXEL_KERNELS_AVX2
+            if (is_avx2_supported()) {
+                i = swizzle_rgba_to_bgra_avx2(pixels, count);
+            }
+#endif
+            const __m128i green_alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m128i low_byte_mask = _mm_set1_epi32(0x000000FF);
+            for (; i + 4 <= count; i += 4) {
+                __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i * 4));
+                __m128i green_alpha = _mm_and_si128(values, green_alpha_mask);
+                __m128i red = _mm_slli_epi32(_mm_and_si128(values, low_byte_mask), 16);
+                __m128i blue = _mm_and_si128(_mm_srli_epi32(values, 16), low_byte_mask);
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i *>(pixels + i * 4),
+                    _mm_or_si128(green_alpha, _mm_or_si128(red, blue))
+                );
+            }
+#endif
+            for (; i < count; ++i) {
+                std::swap(pixels[i * 4 + 0], pixels[i * 4 + 2]);
+            }
+        }
+
+        static void swizzle_rgb_to_bgr(uint8_t *pixels, size_t count)
+        {
+            size_t i{0};
+#if defined(ASR_PIXEL_KERNELS_NEON)
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x3_t values = vld3q_u8(pixels + i * 3);
+                std::swap(values.val[0], values.val[2]);
+                vst3q_u8(pixels + i * 3, values);
+            }
+#endif
+            for (; i < count; ++i) {
+                std::swap(pixels[i * 3 + 0], pixels[i * 3 + 2]);
+            }
+        }
+
+        static void apply_color_table(uint8_t *pixels, size_t count, unsigned int channels, const std::array<uint8_t, 256> &table)
+        {
+            // Alpha is linear in both encodings, so only the color channels go through the table.
+            unsigned int color_channels{channels == 2 || channels == 4 ? channels - 1 : channels};
+            for (size_t i = 0; i < count; ++i) {
+                uint8_t *pixel = pixels + i * channels;
+                for (unsigned int channel = 0; channel < color_channels; ++channel) {
+                    pixel[channel] = table[pixel[channel]];
+                }
+            }
+        }
+
+        static unsigned int get_converted_channel_count(unsigned int channels, unsigned int conversions)
+        {
+            return (conversions & ExpandToRGBA) != 0 ? 4 : channels;
+        }
+
+        static void convert_pixel_row(
+                        const uint8_t *source, uint8_t *destination,
+                        size_t count, unsigned int channels, unsigned int conversions
+                    )
+        {
+            if ((conversions & ExpandToRGBA) != 0 && channels != 4) {
+                switch (channels) {
+                    case 1: expand_gray_to_rgba(source, destination, count); break;
+                    case 2: expand_gray_alpha_to_rgba(source, destination, count); break;
+                    case 3: expand_rgb_to_rgba(source, destination, count); break;
+                    default: break;
+                }
+                channels = 4;
+            } else if (source != destination) {
+                std::memcpy(destination, source, count * channels);
+            }
+
+            if ((conversions & ConvertSRGBToLinear) != 0) {
+                apply_color_table(destination, count, channels, get_srgb_to_linear_table());
+            }
+            if ((conversions & PremultiplyAlpha) != 0) {
+                if (channels == 4) premultiply_rgba(destination, count);
+                if (channels == 2) premultiply_gray_alpha(destination, count);
+            }
+            if ((conversions & ConvertLinearToSRGB) != 0) {
+                apply_color_table(destination, count, channels, get_linear_to_srgb_table());
+            }
+            if ((conversions & SwizzleToBGRA) != 0) {
+                if (channels == 4) swizzle_rgba_to_bgra(destination, count);
+                if (channels == 3) swizzle_rgb_to_bgr(destination, count);
+            }
+        }
+
+        static void convert_pixels(
+                        const uint8_t *source, uint8_t *destination,
+                        unsigned int width, unsigned int height, unsigned int channels,
+                        unsigned int conversions
+                    )
+        {
+            ASR_TRACE_SCOPE("convert_pixels");
+
+            assert(source != destination || ((conversions & (ExpandToRGBA | FlipVertically)) == 0));
+
+            size_t source_row_size{static_cast<size_t>(width) * channels};
+            size_t destination_row_size{static_cast<size_t>(width) * get_converted_channel_count(channels, conversions)};
+            bool flip{(conversions & FlipVertically) != 0};
+
+            auto convert_rows = [=](unsigned int first_row, unsigned int last_row) {
+                for (unsigned int row = first_row; row < last_row; ++row) {
+                    unsigned int destination_row{flip ? height - 1 - row : row};
+                    convert_pixel_row(
+                        source + row * source_row_size,
+                        destination + destination_row * destination_row_size,
+                        width, channels, conversions
+                    );
+                }
+            };
+
+            size_t image_size{static_cast<size_t>(height) * std::max(source_row_size, destination_row_size)};
+            if (image_size < data::parallel_pixel_conversion_threshold) {
+                convert_rows(0, height);
+                return;
+            }
+
+            parallel_for(0, height, [&convert_rows](size_t first_row, size_t last_row) {
+                convert_rows(static_cast<unsigned int>(first_row), static_cast<unsigned int>(last_row));
+            });
+        }
+
+        /*
+         * Trigonometry
+         */
+
+        // Cephes polynomials after a Cody-Waite reduction. Angles past 8192, infinities and NaNs use std::sin and std::cos.
+        static const float sincos_max_reduced_angle{8192.0f};
+        static const float sincos_four_over_pi{1.27323954473516f};
+        static const float sincos_reduction_1{0.78515625f};
+        static const float sincos_reduction_2{2.4187564849853515625e-4f};
+        static const float sincos_reduction_3{3.77489497744594108e-8f};
+        static const float sine_coefficients[3]{-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+        static const float cosine_coefficients[3]{2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+
+        // Kernels stop at the first group they cannot reduce; the scalar kernel finishes the rest.
+        static void compute_sines_and_cosines_scalar(const float *angles, float *sines, float *cosines, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) {
+                float x{std::fabs(angles[i])};
+                // Written so that NaN fails the test too.
+                if (!(x <= sincos_max_reduced_angle)) {
+                    float angle{angles[i]};
+                    sines[i] = std::sin(angle);
+                    cosines[i] = std::cos(angle);
+                    continue;
+                }
+
+                auto octant = static_cast<int32_t>(x * sincos_four_over_pi);
+                octant = (octant + 1) & ~1;
+                auto y = static_cast<float>(octant);
+                x = ((x - y * sincos_reduction_1) - y * sincos_reduction_2) - y * sincos_reduction_3;
+
+                float z{x * x};
+                float sine{x + x * z * ((sine_coefficients[0] * z + sine_coefficients[1]) * z + sine_coefficients[2])};
+                float cosine{1.0f - 0.5f * z + z * z * ((cosine_coefficients[0] * z + cosine_coefficients[1]) * z + cosine_coefficients[2])};
+                if ((octant & 2) != 0) std::swap(sine, cosine);
+
+                bool negate_sine{((octant & 4) != 0) != (angles[i] < 0.0f)};
+                bool negate_cosine{((octant - 2) & 4) == 0};
+                sines[i] = negate_sine ? -sine : sine;
+                cosines[i] = negate_cosine ? -cosine : cosine;
+            }
+        }
+
+#if defined(ASR_PIXEL_KERNELS_SSE2)
+        static size_t compute_sines_and_cosines_sse2(const float *angles, float *sines, float *cosines, size_t begin, size_t end)
+        {
+            const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(0x80000000u)));
+            const __m128i one = _mm_set1_epi32(1);
+            const __m128i two = _mm_set1_epi32(2);
+            const __m128i four = _mm_set1_epi32(4);
+
+            size_t i{begin};
+            for (; i + 4 <= end; i += 4) {
+                __m128 angle = _mm_loadu_ps(angles + i);
+                __m128 sine_sign = _mm_and_ps(angle, sign_mask);
+                __m128 x = _mm_andnot_ps(sign_mask, angle);
+                if (_mm_movemask_ps(_mm_cmpnle_ps(x, _mm_set1_ps(sincos_max_reduced_angle))) != 0) break;
+
+                __m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(sincos_four_over_pi)));
+                octant = _mm_andnot_si128(one, _mm_add_epi32(octant, one));
+                __m128 y = _mm_cvtepi32_ps(octant);
+                x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduction_1)));
+                x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduction_2)));
+                x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduction_3)));
+
+                sine_sign = _mm_xor_ps(sine_sign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, four), 29)));
+                __m128 cosine_sign = _mm_castsi128_ps(
+                    _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, two), four), 29)
+                );
+                __m128 swap_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, two), two));
+
+                __m128 z = _mm_mul_ps(x, x);
+                __m128 sine = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sine_coefficients[0]), z), _mm_set1_ps(sine_coefficients[1]));
+                sine = _mm_add_ps(_mm_mul_ps(sine, z), _mm_set1_ps(sine_coefficients[2]));
+                sine = _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(sine, z), x));
+                __m128 cosine = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cosine_coefficients[0]), z), _mm_set1_ps(cosine_coefficients[1]));
+                cosine = _mm_add_ps(_mm_mul_ps(cosine, z), _mm_set1_ps(cosine_coefficients[2]));
+                cosine = _mm_add_ps(
+                    _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)),
+                    _mm_mul_ps(_mm_mul_ps(cosine, z), z)
+                );
+
+                __m128 swapped_sine = _mm_or_ps(_mm_and_ps(swap_mask, cosine), _mm_andnot_ps(swap_mask, sine));
+                __m128 swapped_cosine = _mm_or_ps(_mm_and_ps(swap_mask, sine), _mm_andnot_ps(swap_mask, cosine));
+                _mm_storeu_ps(sines + i, _mm_xor_ps(swapped_sine, sine_sign));
+                _mm_storeu_ps(cosines + i, _mm_xor_ps(swapped_cosine, cosine_sign));
+            }
+
+            return i;
+        }
+#endif
+
+#ifdef ASR_PIXEL_KERNELS_AVX2
+        ASR_TARGET_AVX2 static size_t compute_sines_and_cosines_avx2(const float *angles, float *sines, float *cosines, size_t begin, size_t end)
+        {
+            const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int32_t>(0x80000000u)));
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i two = _mm256_set1_epi32(2);
+            const __m256i four = _mm256_set1_epi32(4);
+
+            size_t i{begin};
+            for (; i + 8 <= end; i += 8) {
+                __m256 angle = _mm256_loadu_ps(angles + i);
+                __m256 sine_sign = _mm256_and_ps(angle, sign_mask);
+                __m256 x = _mm256_andnot_ps(sign_mask, angle);
+                if (_mm256_movemask_ps(_mm256_cmp_ps(x, _mm256_set1_ps(sincos_max_reduced_angle), _CMP_NLE_UQ)) != 0) break;
+
+                __m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(sincos_four_over_pi)));
+                octant = _mm256_andnot_si256(one, _mm256_add_epi32(octant, one));
+                __m256 y = _mm256_cvtepi32_ps(octant);
+                x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(sincos_reduction_1)));
+                x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(sincos_reduction_2)));
+                x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(sincos_reduction_3)));
+
+                sine_sign = _mm256_xor_ps(sine_sign, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, four), 29)));
+                __m256 cosine_sign = _mm256_castsi256_ps(
+                    _mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(octant, two), four), 29)
+                );
+                __m256 swap_mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(octant, two), two));
+
+                __m256 z = _mm256_mul_ps(x, x);
+                __m256 sine = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(sine_coefficients[0]), z), _mm256_set1_ps(sine_coefficients[1]));
+                sine = _mm256_add_ps(_mm256_mul_ps(sine, z), _mm256_set1_ps(sine_coefficients[2]));
+                sine = _mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(sine, z), x));
+                __m256 cosine = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(cosine_coefficients[0]), z), _mm256_set1_ps(cosine_coefficients[1]));
+                cosine = _mm256_add_ps(_mm256_mul_ps(cosine, z), _mm256_set1_ps(cosine_coefficients[2]));
+                cosine = _mm256_add_ps(
+                    _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)),
+                    _mm256_mul_ps(_mm256_mul_ps(cosine, z), z)
+                );
+
+                _mm256_storeu_ps(sines + i, _mm256_xor_ps(_mm256_blendv_ps(sine, cosine, swap_mask), sine_sign));
+                _mm256_storeu_ps(cosines + i, _mm256_xor_ps(_mm256_blendv_ps(cosine, sine, swap_mask), cosine_sign));
+            }
+
+            return i;
+        }
+#endif
+
+#ifdef ASR_PIXEL_KERNELS_NEON
+        static size_t compute_sines_and_cosines_neon(const float *angles, float *sines, float *cosines, size_t begin, size_t end)
+        {
+            const int32x4_t one = vdupq_n_s32(1);
+            const int32x4_t two = vdupq_n_s32(2);
+            const int32x4_t four = vdupq_n_s32(4);
+
+            size_t i{begin};
+            for (; i + 4 <= end; i += 4) {
+                float32x4_t angle = vld1q_f32(angles + i);
+                uint32x4_t sine_sign = vandq_u32(vreinterpretq_u32_f32(angle), vdupq_n_u32(0x80000000u));
+                float32x4_t x = vabsq_f32(angle);
+                uint32x4_t reducible = vcleq_f32(x, vdupq_n_f32(sincos_max_reduced_angle));
+                uint32x2_t all_reducible = vand_u32(vget_low_u32(reducible), vget_high_u32(reducible));
+                if ((vget_lane_u32(all_reducible, 0) & vget_lane_u32(all_reducible, 1)) == 0) break;
+
+                int32x4_t octant = vcvtq_s32_f32(vmulq_n_f32(x, sincos_four_over_pi));
+                octant = vbicq_s32(vaddq_s32(octant, one), one);
+                float32x4_t y = vcvtq_f32_s32(octant);
+                x = vmlsq_n_f32(x, y, sincos_reduction_1);
+                x = vmlsq_n_f32(x, y, sincos_reduction_2);
+                x = vmlsq_n_f32(x, y, sincos_reduction_3);
+
+                sine_sign = veorq_u32(sine_sign, vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(octant, four), 29)));
+                uint32x4_t cosine_sign = vreinterpretq_u32_s32(vshlq_n_s32(vbicq_s32(four, vsubq_s32(octant, two)), 29));
+                uint32x4_t swap_mask = vceqq_s32(vandq_s32(octant, two), two);
+
+                float32x4_t z = vmulq_f32(x, x);
+                float32x4_t sine = vmlaq_f32(vdupq_n_f32(sine_coefficients[1]), vdupq_n_f32(sine_coefficients[0]), z);
+                sine = vmlaq_f32(vdupq_n_f32(sine_coefficients[2]), sine, z);
+                sine = vmlaq_f32(x, vmulq_f32(sine, z), x);
+                float32x4_t cosine = vmlaq_f32(vdupq_n_f32(cosine_coefficients[1]), vdupq_n_f32(cosine_coefficients[0]), z);
+                cosine = vmlaq_f32(vdupq_n_f32(cosine_coefficients[2]), cosine, z);
+                cosine = vmlaq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), z, 0.5f), vmulq_f32(cosine, z), z);
+
+                float32x4_t swapped_sine = vbslq_f32(swap_mask, cosine, sine);
+                float32x4_t swapped_cosine = vbslq_f32(swap_mask, sine, cosine);
+                vst1q_f32(sines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(swapped_sine), sine_sign)));
+                vst1q_f32(cosines + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(swapped_cosine), cosine_sign)));
+            }
+
+            return i;
+        }
+#endif
+
+        static void compute_sines_and_cosines(const float *angles, float *sines, float *cosines, size_t count)
+        {
+            size_t begin{0};
+#ifdef ASR_PIXEL_KERNELS_AVX2
+            if (is_avx2_supported()) begin = compute_sines_and_cosines_avx2(angles, sines, cosines, begin, count);
+#endif
+#if defined(ASR_PIXEL_KERNELS_SSE2)
+            begin = compute_sines_and_cosines_sse2(angles, sines, cosines, begin, count);
+#elif defined(ASR_PIXEL_KERNELS_NEON)
+            begin = compute_sines_and_cosines_neon(angles, sines, cosines, begin, count);
+#endif
+            compute_sines_and_cosines_scalar(angles, sines, cosines, begin, count);
+        }
+
+        struct TrigonometryTable
+        {
+            std::vector<float> sines;
+            std::vector<float> cosines;
+        };
+
+        static TrigonometryTable make_trigonometry_table(size_t count, float first_angle, float angle_step)
+        {
+            TrigonometryTable table;
+            table.sines.resize(count);
+            table.cosines.resize(count);
+
+            // The angles are stored in the sine table, which the kernels are allowed to overwrite in place.
+            for (size_t i = 0; i < count; ++i) {
+                table.sines[i] = first_angle + static_cast<float>(i) * angle_step;
+            }
+            compute_sines_and_cosines(table.sines.data(), table.sines.data(), table.cosines.data(), count);
+
+            return table;
+        }
+
+        /*
+         * Shape Generation
+         */
+
+        static unsigned int get_edge_midpoint(
+                                std::vector<glm::vec3> &positions,
+                                std::unordered_map<uint64_t, unsigned int> &midpoints,
+                                unsigned int a, unsigned int b
+                            )
+        {
+            uint64_t key{static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b)};
+            auto [iterator, inserted] = midpoints.emplace(key, static_cast<unsigned int>(positions.size()));
+            if (inserted) {
+                positions.push_back(glm::normalize(positions[a] + positions[b]));
+            }
+
+            return iterator->second;
+        }
+
+        // With split_seam, seam triangles get vertex copies past u = 1 and every pole triangle its own pole vertex.
+        static std::vector<Vertex> map_sphere_positions_to_equirectangular_vertices(
+                                       const std::vector<glm::vec3> &positions,
+                                       std::vector<unsigned int> &triangles,
+                                       float radius,
+                                       bool split_seam
+                                   )
+        {
+            static const float pole_distance{1e-6f};
+
+            std::vector<Vertex> vertices;
+            vertices.reserve(positions.size() + (split_seam ? positions.size() / 16 : 0));
+            for (const auto &position : positions) {
+                float theta{std::atan2(position.z, position.x)};
+                if (theta < 0.0f) theta += two_pi;
+                vertices.push_back(Vertex{
+                    position.x * radius, position.y * radius, position.z * radius,
+                    1.0f, 1.0f, 1.0f, 1.0f,
+                    1.0f - theta / two_pi, std::acos(std::clamp(position.y, -1.0f, 1.0f)) / pi
+                });
+            }
+            if (!split_seam) return vertices;
+
+            auto is_pole = [&positions](unsigned int index) {
+                return std::abs(positions[index].x) < pole_distance && std::abs(positions[index].z) < pole_distance;
+            };
+
+            std::unordered_map<unsigned int, unsigned int> seam_copies;
+            for (size_t triangle = 0; triangle < triangles.size(); triangle += 3) {
+                unsigned int *corners = &triangles[triangle];
+
+                // Decided before any corner is remapped, since the copies lie past the end of positions.
+                std::array<bool, 3> poles{is_pole(corners[0]), is_pole(corners[1]), is_pole(corners[2])};
+
+                float min_u{std::numeric_limits<float>::max()};
+                float max_u{std::numeric_limits<float>::lowest()};
+                for (unsigned int i = 0; i < 3; ++i) {
+                    if (poles[i]) continue;
+                    min_u = std::min(min_u, vertices[corners[i]].u);
+                    max_u = std::max(max_u, vertices[corners[i]].u);
+                }
+                if (max_u - min_u > 0.5f) {
+                    for (unsigned int i = 0; i < 3; ++i) {
+                        if (poles[i] || vertices[corners[i]].u >= 0.5f) continue;
+
+                        auto [iterator, inserted] = seam_copies.emplace(corners[i], static_cast<unsigned int>(vertices.size()));
+                        if (inserted) {
+                            Vertex copy{vertices[corners[i]]};
+                            copy.u += 1.0f;
+                            vertices.push_back(copy);
+                        }
+                        corners[i] = iterator->second;
+                    }
+                }
+
+                for (unsigned int i = 0; i < 3; ++i) {
+                    if (!poles[i]) continue;
+
+                    Vertex copy{vertices[corners[i]]};
+                    copy.u = 0.5f * (vertices[corners[(i + 1) % 3]].u + vertices[corners[(i + 2) % 3]].u);
+                    corners[i] = static_cast<unsigned int>(vertices.size());
+                    vertices.push_back(copy);
+                }
+            }
+
+            return vertices;
+        }
+
+        static GeometryData make_triangle_mesh_geometry_data(
+                                std::vector<Vertex> vertices,
+                                const std::vector<unsigned int> &triangles,
+                                GeometryType type
+                            )
+        {
+            assert(type == Triangles || type == Lines || type == Points);
+
+            GeometryData geometry_data;
+            auto &[geometry_vertices, indices] = geometry_data;
+            geometry_vertices = std::move(vertices);
+
+            if (type == Triangles) {
+                indices = triangles;
+            } else if (type == Lines) {
+                indices.reserve(triangles.size() * 2);
+                for (size_t i = 0; i < triangles.size(); i += 3) {
+                    for (unsigned int index : {
+                             triangles[i], triangles[i + 1], triangles[i + 1],
+                             triangles[i + 2], triangles[i + 2], triangles[i]
+                         }) {
+                        indices.push_back(index);
+                    }
+                }
+            } else {
+                indices.resize(geometry_vertices.size());
+                for (unsigned int i = 0; i < indices.size(); ++i) {
+                    indices[i] = i;
+                }
+            }
+
+            return geometry_data;
+        }
+
+        /*
+         * Triangle Strips
+         */
+
+        static uint64_t make_directed_edge_key(unsigned int from, unsigned int to)
+        {
+            return static_cast<uint64_t>(from) << 32 | to;
+        }
+
+        // Triangles of this attempt are marked with its stamp.
+        static void grow_triangle_strip(
+                        const unsigned int *indices,
+                        const std::unordered_map<uint64_t, unsigned int> &edge_triangles,
+                        const std::vector<uint8_t> &used_triangles,
+                        std::vector<unsigned int> &triangle_stamps,
+                        unsigned int stamp,
+                        unsigned int first_triangle,
+                        unsigned int first_corner,
+                        std::vector<unsigned int> &strip,
+                        std::vector<unsigned int> &strip_triangles
+                    )
+        {
+            strip.clear();
+            strip_triangles.clear();
+            for (unsigned int i = 0; i < 3; ++i) {
+                strip.push_back(indices[first_triangle * 3 + (first_corner + i) % 3]);
+            }
+            strip_triangles.push_back(first_triangle);
+            triangle_stamps[first_triangle] = stamp;
+
+            for (;;) {
+                unsigned int p{strip[strip.size() - 2]};
+                unsigned int q{strip[strip.size() - 1]};
+                // Even triangles of a strip contain the edge p->q, odd ones q->p; the neighbour runs the other way.
+                bool last_is_even{(strip.size() - 3) % 2 == 0};
+                auto neighbour = edge_triangles.find(last_is_even ? make_directed_edge_key(q, p) : make_directed_edge_key(p, q));
+                if (neighbour == edge_triangles.end()) break;
+
+                unsigned int triangle{neighbour->second};
+                if (used_triangles[triangle] || triangle_stamps[triangle] == stamp) break;
+
+                const unsigned int *corners = indices + triangle * 3;
+                unsigned int next{corners[0] + corners[1] + corners[2] - p - q};
+                strip.push_back(next);
+                strip_triangles.push_back(triangle);
+                triangle_stamps[triangle] = stamp;
+            }
+        }
+
+        // Degenerate joins keep every strip at an even position so its winding survives.
+        static std::vector<unsigned int> stripify_triangles(const unsigned int *indices, size_t index_count, bool use_primitive_restart)
+        {
+            assert(index_count % 3 == 0);
+            auto triangle_count = static_cast<unsigned int>(index_count / 3);
+
+            std::unordered_map<uint64_t, unsigned int> edge_triangles;
+            edge_triangles.reserve(index_count);
+            for (unsigned int triangle = 0; triangle < triangle_count; ++triangle) {
+                const unsigned int *corners = indices + triangle * 3;
+                for (unsigned int i = 0; i < 3; ++i) {
+                    edge_triangles.emplace(make_directed_edge_key(corners[i], corners[(i + 1) % 3]), triangle);
+                }
+            }
+
+            std::vector<uint8_t> used_triangles(triangle_count, 0);
+            std::vector<unsigned int> triangle_stamps(triangle_count, 0);
+            unsigned int stamp{0};
+
+            std::vector<unsigned int> strips;
+            strips.reserve(index_count / 2);
+            std::vector<unsigned int> strip, strip_triangles, best_strip, best_strip_triangles;
+            for (unsigned int first_triangle = 0; first_triangle < triangle_count; ++first_triangle) {
+                if (used_triangles[first_triangle]) continue;
+
+                const unsigned int *corners = indices + first_triangle * 3;
+                if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) {
+                    used_triangles[first_triangle] = 1;
+                    continue;
+                }
+
+                best_strip.clear();
+                best_strip_triangles.clear();
+                for (unsigned int first_corner = 0; first_corner < 3; ++first_corner) {
+                    grow_triangle_strip(
+                        indices, edge_triangles, used_triangles, triangle_stamps, ++stamp,
+                        first_triangle, first_corner, strip, strip_triangles
+                    );
+                    if (strip.size() > best_strip.size()) {
+                        best_strip.swap(strip);
+                        best_strip_triangles.swap(strip_triangles);
+                    }
+                }
+                for (unsigned int triangle : best_strip_triangles) {
+                    used_triangles[triangle] = 1;
+                }
+
+                if (!strips.empty()) {
+                    if (use_primitive_restart) {
+                        strips.push_back(primitive_restart_index);
+                    } else {
+                        unsigned int last_index{strips.back()};
+                        strips.push_back(last_index);
+                        strips.push_back(best_strip.front());
+                        if (strips.size() % 2 != 0) strips.push_back(best_strip.front());
+                    }
+                }
+                strips.insert(strips.end(), best_strip.begin(), best_strip.end());
+            }
+
+            return strips;
+        }
+
+        static void enable_primitive_restart()
+        {
+            if (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility) {
+                set_capability(GL_PRIMITIVE_RESTART_FIXED_INDEX, true);
+            } else if (GLEW_VERSION_3_1) {
+                set_capability(GL_PRIMITIVE_RESTART, true);
+                glPrimitiveRestartIndex(primitive_restart_index);
+            }
+        }
+
+        /*
+         * Wireframe
+         */
+
+        // index % 3 is the slot of a corner, which shaders read as gl_VertexID % 3.
+        static GeometryData assign_barycentric_slots(
+                                const Vertex *vertices, size_t vertex_count,
+                                const unsigned int *indices, size_t index_count
+                            )
+        {
+            static const unsigned int no_copy{std::numeric_limits<unsigned int>::max()};
+            static const unsigned int slot_orders[6][3]{{0, 1, 2}, {1, 2, 0}, {2, 0, 1}, {0, 2, 1}, {1, 0, 2}, {2, 1, 0}};
+
+            assert(index_count % 3 == 0);
+            auto triangle_count = static_cast<unsigned int>(index_count / 3);
+
+            std::unordered_map<uint64_t, unsigned int> edge_triangles;
+            edge_triangles.reserve(index_count);
+            for (unsigned int triangle = 0; triangle < triangle_count; ++triangle) {
+                const unsigned int *corners = indices + triangle * 3;
+                for (unsigned int i = 0; i < 3; ++i) {
+                    edge_triangles.emplace(make_directed_edge_key(corners[i], corners[(i + 1) % 3]), triangle);
+                }
+            }
+
+            std::vector<std::array<unsigned int, 3>> vertex_copies(vertex_count, {no_copy, no_copy, no_copy});
+            std::array<std::vector<unsigned int>, 3> slot_vertices;
+            std::vector<unsigned int> triangle_indices(index_count);
+
+            std::vector<uint8_t> visited_triangles(triangle_count, 0);
+            std::vector<unsigned int> queue;
+            queue.reserve(triangle_count);
+            for (unsigned int first_triangle = 0; first_triangle < triangle_count; ++first_triangle) {
+                if (visited_triangles[first_triangle]) continue;
+                visited_triangles[first_triangle] = 1;
+                queue.clear();
+                queue.push_back(first_triangle);
+
+                for (size_t next = 0; next < queue.size(); ++next) {
+                    unsigned int triangle{queue[next]};
+                    const unsigned int *corners = indices + triangle * 3;
+                    assert(corners[0] < vertex_count && corners[1] < vertex_count && corners[2] < vertex_count);
+
+                    const unsigned int *best_order{slot_orders[0]};
+                    size_t best_cost{std::numeric_limits<size_t>::max()};
+                    for (const auto &order : slot_orders) {
+                        size_t cost{0};
+                        for (unsigned int i = 0; i < 3; ++i) {
+                            if (vertex_copies[corners[i]][order[i]] == no_copy) {
+                                cost += (static_cast<size_t>(index_count) + 1) + slot_vertices[order[i]].size();
+                            }
+                        }
+                        if (cost < best_cost) {
+                            best_cost = cost;
+                            best_order = order;
+                        }
+                    }
+
+                    for (unsigned int i = 0; i < 3; ++i) {
+                        unsigned int slot{best_order[i]};
+                        unsigned int &copy = vertex_copies[corners[i]][slot];
+                        if (copy == no_copy) {
+                            copy = static_cast<unsigned int>(slot_vertices[slot].size());
+                            slot_vertices[slot].push_back(corners[i]);
+                        }
+                        triangle_indices[triangle * 3 + i] = copy * 3 + slot;
+                    }
+
+                    for (unsigned int i = 0; i < 3; ++i) {
+                        auto neighbour = edge_triangles.find(make_directed_edge_key(corners[(i + 1) % 3], corners[i]));
+                        if (neighbour == edge_triangles.end() || visited_triangles[neighbour->second]) continue;
+
+                        visited_triangles[neighbour->second] = 1;
+                        queue.push_back(neighbour->second);
+                    }
+                }
+            }
+
+            size_t row_count{std::max({slot_vertices[0].size(), slot_vertices[1].size(), slot_vertices[2].size()})};
+            std::vector<Vertex> triangle_vertices(row_count * 3, Vertex{});
+            for (unsigned int slot = 0; slot < 3; ++slot) {
+                for (size_t row = 0; row < slot_vertices[slot].size(); ++row) {
+                    triangle_vertices[row * 3 + slot] = vertices[slot_vertices[slot][row]];
+                }
+            }
+
+            return std::make_pair(std::move(triangle_vertices), std::move(triangle_indices));
+        }
+
+        /*
+         * Transparency
+         */
+
+        // Blits need matching depth formats, so the window's one is mirrored.
+        static GLenum get_window_depth_format()
+        {
+            GLint depth_size{24}, stencil_size{0};
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_DEPTH, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth_size);
+            glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil_size);
+
+            if (stencil_size > 0) return depth_size > 24 ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+            if (depth_size <= 16) return GL_DEPTH_COMPONENT16;
+            return depth_size > 24 ? GL_DEPTH_COMPONENT32F : GL_DEPTH_COMPONENT24;
+        }
+
+        static GLuint generate_transparency_target_texture(GLint internal_format, GLenum format, unsigned int width, unsigned int height)
+        {
+            GLuint texture_object{0};
+            glGenTextures(1, &texture_object);
+            set_active_texture_unit(0);
+            GLuint previous_texture{data::gl_state.bound_textures[0]};
+            GLenum previous_target{data::gl_state.bound_texture_targets[0]};
+
+            bind_texture(GL_TEXTURE_2D, texture_object);
+            glTexImage2D(
+                GL_TEXTURE_2D, 0, internal_format,
+                static_cast<GLsizei>(width), static_cast<GLsizei>(height), 0, format, GL_FLOAT, nullptr
+            );
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            bind_texture(previous_target != 0 ? previous_target : GL_TEXTURE_2D, previous_texture);
+
+            return texture_object;
+        }
+
+        static void destroy_transparency_target_textures()
+        {
+            TransparencyTargets &targets = data::transparency_targets;
+
+            if (targets.framebuffer != 0) glDeleteFramebuffers(1, &targets.framebuffer);
+            if (targets.depth_renderbuffer != 0) glDeleteRenderbuffers(1, &targets.depth_renderbuffer);
+            for (GLuint *texture_object : {&targets.accumulation_texture, &targets.weight_texture}) {
+                if (*texture_object == 0) continue;
+                forget_deleted_texture(*texture_object);
+                glDeleteTextures(1, texture_object);
+            }
+            account_memory(RenderTargets, 0, -static_cast<int64_t>(targets.memory_size));
+
+            targets.framebuffer = 0;
+            targets.accumulation_texture = 0;
+            targets.weight_texture = 0;
+            targets.depth_renderbuffer = 0;
+            targets.width = 0;
+            targets.height = 0;
+            targets.memory_size = 0;
+        }
+
+        static void resize_transparency_targets(unsigned int width, unsigned int height)
+        {
+            TransparencyTargets &targets = data::transparency_targets;
+            destroy_transparency_target_textures();
+
+            targets.accumulation_texture = generate_transparency_target_texture(GL_RGBA16F, GL_RGBA, width, height);
+            targets.weight_texture = generate_transparency_target_texture(GL_R16F, GL_RED, width, height);
+
+            GLenum depth_format{get_window_depth_format()};
+            glGenRenderbuffers(1, &targets.depth_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, targets.depth_renderbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, depth_format, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+            bool has_stencil{depth_format == GL_DEPTH24_STENCIL8 || depth_format == GL_DEPTH32F_STENCIL8};
+            glGenFramebuffers(1, &targets.framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, targets.framebuffer);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targets.accumulation_texture, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, targets.weight_texture, 0);
+            glFramebufferRenderbuffer(
+                GL_FRAMEBUFFER, has_stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT,
+                GL_RENDERBUFFER, targets.depth_renderbuffer
+            );
+            static const GLenum draw_buffers[2]{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+            glDrawBuffers(2, draw_buffers);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "Failed to create the render targets for order-independent transparency." << std::endl;
+                std::exit(-1);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            size_t depth_bytes{depth_format == GL_DEPTH_COMPONENT16 ? 2u : (depth_format == GL_DEPTH32F_STENCIL8 ? 8u : 4u)};
+            targets.width = width;
+            targets.height = height;
+            targets.memory_size = static_cast<size_t>(width) * height * (8 + 2 + depth_bytes);
+            account_memory(RenderTargets, 0, static_cast<int64_t>(targets.memory_size));
+        }
+
+        static void destroy_transparency_targets()
+        {
+            TransparencyTargets &targets = data::transparency_targets;
+            destroy_transparency_target_textures();
+
+            if (targets.composite_program.program_object != 0) {
+                forget_deleted_program(targets.composite_program.program_object);
+                glDeleteProgram(targets.composite_program.program_object);
+                targets.composite_program = ShaderProgram{};
+            }
+            if (targets.composite_vertex_array != 0) {
+                if (data::gl_state.vertex_array_object == targets.composite_vertex_array) bind_vertex_array(0);
+#ifdef __APPLE__
+                glDeleteVertexArraysAPPLE(1, &targets.composite_vertex_array);
+#else
+                glDeleteVertexArrays(1, &targets.composite_vertex_array);
+#endif
+                targets.composite_vertex_array = 0;
+            }
+            if (targets.composite_vertex_buffer != 0) {
+                glDeleteBuffers(1, &targets.composite_vertex_buffer);
+                targets.composite_vertex_buffer = 0;
+            }
+        }
+
+        /*
+        * Texture Handling
+        */
+
+        static GLint get_internal_pixel_format(unsigned int channels)
+        {
+            switch (channels) {
+                case 1:
+                    return GL_LUMINANCE;
+                case 2:
+                    return GL_LUMINANCE_ALPHA;
+                case 3:
+                    return GL_RGB;
+                default:
+                    return GL_RGBA;
+            }
+        }
+
+        static GLenum get_pixel_format(unsigned int channels, bool bgr_order)
+        {
+            switch (channels) {
+                case 1:
+                    return GL_LUMINANCE;
+                case 2:
+                    return GL_LUMINANCE_ALPHA;
+                case 3:
+                    return bgr_order ? GL_BGR : GL_RGB;
+                default:
+                    return bgr_order ? GL_BGRA : GL_RGBA;
+            }
+        }
+
+        static GLenum convert_texture_type_to_gl_texture_target(TextureType type)
+        {
+            switch (type) {
+                case Texture2D:
+                    return GL_TEXTURE_2D;
+                case Texture2DArray:
+                    return GL_TEXTURE_2D_ARRAY;
+            }
+
+            return GL_TEXTURE_2D;
+        }
+
+        // Binds a texture for sampling; which texture the parameter setters change is up to the caller.
+        static void bind_sampled_texture(const Texture *texture, unsigned int sampler)
+        {
+            assert(sampler < max_texture_units);
+
+            const Texture *previous_texture = data::current_textures[sampler];
+            data::current_textures[sampler] = texture;
+
+            set_active_texture_unit(sampler);
+            if (texture != nullptr) {
+                bind_texture(convert_texture_type_to_gl_texture_target(texture->type), texture->texture_object);
+            } else {
+                bind_texture(
+                    convert_texture_type_to_gl_texture_target(
+                        previous_texture != nullptr ? previous_texture->type : Texture2D
+                    ),
+                    0
+                );
+            }
+        }
+
+        static GLint convert_wrap_mode_to_es2_texture_wrap_mode(TextureWrapMode wrap_mode)
+        {
+            switch (wrap_mode) {
+                case Repeat:
+                    return GL_REPEAT;
+                case MirroredRepeat:
+                    return GL_MIRRORED_REPEAT;
+                case ClampToEdge:
+                    return GL_CLAMP_TO_EDGE;
+            }
+
+            return GL_REPEAT;
+        }
+
+        static GLint convert_filter_type_to_es2_texture_filter_type(TextureFilterType filter)
+        {
+            switch (filter) {
+                case Nearest:
+                    return GL_NEAREST;
+                case Linear:
+                    return GL_LINEAR;
+                case NearestMipmapNearest:
+                    return GL_NEAREST_MIPMAP_NEAREST;
+                case NearestMipmapLinear:
+                    return GL_NEAREST_MIPMAP_LINEAR;
+                case LinearMipmapNearest:
+                    return GL_LINEAR_MIPMAP_NEAREST;
+                case LinearMipmapLinear:
+                    return GL_LINEAR_MIPMAP_LINEAR;
+            }
+
+            return GL_NEAREST;
+        }
+
+        /*
+         * Shared Uniform Blocks
+         */
+
+        static void create_uniform_buffers()
+        {
+            data::uniform_buffers_supported = GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object;
+            if (!data::uniform_buffers_supported) return;
+
+            glGenBuffers(1, &data::frame_uniform_buffer);
+            bind_buffer(GL_UNIFORM_BUFFER, data::frame_uniform_buffer);
+            upload_buffer_data(GL_UNIFORM_BUFFER, sizeof(FrameUniformBlock), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, frame_uniform_block_binding, data::frame_uniform_buffer);
+
+            glGenBuffers(1, &data::view_uniform_buffer);
+            bind_buffer(GL_UNIFORM_BUFFER, data::view_uniform_buffer);
+            upload_buffer_data(GL_UNIFORM_BUFFER, sizeof(ViewUniformBlock), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, view_uniform_block_binding, data::view_uniform_buffer);
+
+            bind_buffer(GL_UNIFORM_BUFFER, 0);
+            account_memory(Buffers, 0, static_cast<int64_t>(sizeof(FrameUniformBlock) + sizeof(ViewUniformBlock)));
+        }
+
+        static void destroy_uniform_buffers()
+        {
+            if (!data::uniform_buffers_supported) return;
+
+            glDeleteBuffers(1, &data::frame_uniform_buffer);
+            glDeleteBuffers(1, &data::view_uniform_buffer);
+            data::frame_uniform_buffer = 0;
+            data::view_uniform_buffer = 0;
+            data::view_uniform_block_uploaded = false;
+
+            account_memory(Buffers, 0, -static_cast<int64_t>(sizeof(FrameUniformBlock) + sizeof(ViewUniformBlock)));
+        }
+
+        static void update_frame_uniform_block()
+        {
+            if (!data::uniform_buffers_supported) return;
+
+            FrameUniformBlock block{
+                glm::vec2{static_cast<float>(data::window_width), static_cast<float>(data::window_height)},
+                glm::vec2{static_cast<float>(data::mouse_x), static_cast<float>(data::mouse_y)},
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    data::frame_rendering_start_time - data::rendering_start_time
+                ).count() / 1000.0f,
+                data::frame_rendering_delta_time,
+                {0.0f, 0.0f}
+            };
+
+            bind_buffer(GL_UNIFORM_BUFFER, data::frame_uniform_buffer);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+            count_uploaded_bytes(sizeof(block));
+        }
+
+        static void update_view_uniform_block()
+        {
+            // Uploaded lazily on the first draw after the camera changed.
+            const glm::mat4 &view_matrix = data::view_matrix_stack.top();
+            const glm::mat4 &projection_matrix = data::projection_matrix_stack.top();
+            if (data::view_uniform_block_uploaded &&
+                std::memcmp(&view_matrix, &data::uploaded_view_matrix, sizeof(glm::mat4)) == 0 &&
+                std::memcmp(&projection_matrix, &data::uploaded_projection_matrix, sizeof(glm::mat4)) == 0) {
+                return;
+            }
+
+            ViewUniformBlock block;
+            block.view_matrix = glm::inverse(view_matrix);
+            block.projection_matrix = projection_matrix;
+            block.view_projection_matrix = projection_matrix * block.view_matrix;
+
+            bind_buffer(GL_UNIFORM_BUFFER, data::view_uniform_buffer);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+            count_uploaded_bytes(sizeof(block));
+
+            data::uploaded_view_matrix = view_matrix;
+            data::uploaded_projection_matrix = projection_matrix;
+            data::view_uniform_block_uploaded = true;
+        }
+
+        /*
+         * Shader Variants
+         */
+
+        static uint32_t get_shader_variant_key()
+        {
+            const Texture *texture = data::current_textures[0];
+            uint32_t key{texture != nullptr ? 1u | static_cast<uint32_t>(texture->mode) << 2 : 0u};
+            if (data::vertex_colors_enabled) key |= 2u;
+
+            return key;
+        }
+
+        // The defines go right after the #version line, which must stay the first statement of the source.
+        static std::string insert_shader_variant_defines(const std::string &source, uint32_t key)
+        {
+            std::ostringstream defines;
+            if ((key & 1u) != 0) {
+                defines << "#define ASR_TEXTURE_ENABLED\n"
+                        << "#define ASR_TEXTURING_MODE " << (key >> 2) << "\n";
+            }
+            if ((key & 2u) != 0) {
+                defines << "#define ASR_VERTEX_COLOR_ENABLED\n";
+            }
+
+            size_t insertion_point{0};
+            size_t version = source.find("#version");
+            if (version != std::string::npos) {
+                size_t line_end = source.find('\n', version);
+                insertion_point = line_end != std::string::npos ? line_end + 1 : source.size();
+            }
+
+            std::string variant_source{source};
+            variant_source.insert(insertion_point, defines.str());
+
+            return variant_source;
+        }
+
+        /*
+         * Shader Interfaces
+         */
+
+        template<typename Interface, size_t I>
+        static void upload_shader_interface_uniform(GLint location, const Interface &values)
+        {
+            constexpr auto uniform = std::get<I>(Interface::get_shader_uniforms());
+            set_uniform(location, values.*(uniform.member));
+        }
+
+        template<typename Interface, size_t... I>
+        static void bind_shader_interface_uniforms(ShaderInterface<Interface> &interface, std::index_sequence<I...>)
+        {
+            constexpr auto uniforms = Interface::get_shader_uniforms();
+            constexpr std::array<const char *, sizeof...(I)> names{std::get<I>(uniforms).name...};
+            constexpr std::array<typename ShaderInterface<Interface>::UniformUploader, sizeof...(I)> uploaders{
+                &upload_shader_interface_uniform<Interface, I>...
+            };
+
+            for (size_t i = 0; i < sizeof...(I); ++i) {
+                GLint location{glGetUniformLocation(interface.program_object, names[i])};
+                if (location != -1) {
+                    interface.uniforms[interface.active_uniform_count++] = {location, uploaders[i]};
+                }
+            }
+        }
+
+        /*
+         * Resource Uploading
+         */
+
+        static void apply_texture_parameters(const Texture &texture)
+        {
+            GLenum target{convert_texture_type_to_gl_texture_target(texture.type)};
+            set_texture_parameter(
+                target, GL_TEXTURE_WRAP_S,
+                convert_wrap_mode_to_es2_texture_wrap_mode(texture.wrap_mode_u)
+            );
+            set_texture_parameter(
+                target, GL_TEXTURE_WRAP_T,
+                convert_wrap_mode_to_es2_texture_wrap_mode(texture.wrap_mode_v)
+            );
+            set_texture_parameter(
+                target, GL_TEXTURE_MAG_FILTER,
+                convert_filter_type_to_es2_texture_filter_type(texture.magnification_filter)
+            );
+            set_texture_parameter(
+                target, GL_TEXTURE_MIN_FILTER,
+                convert_filter_type_to_es2_texture_filter_type(texture.minification_filter)
+            );
+            set_texture_parameter(
+                target, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                static_cast<GLfloat>(texture.anisotropy)
+            );
+        }
+
+        static void upload_texture_image(Texture &texture, const Image &image, bool generate_mipmaps, bool upload_in_bands)
+        {
+            ASR_TRACE_SCOPE("upload_texture_image");
+
+            texture.type = Texture2D;
+            texture.width = image.width;
+            texture.height = image.height;
+            texture.channels = image.channels;
+            texture.layers = 1;
+            texture.bgr_order = image.bgr_order;
+
+            glGenTextures(1, &texture.texture_object);
+            bind_texture(GL_TEXTURE_2D, texture.texture_object);
+            apply_texture_parameters(texture);
+
+            GLint internal_format = get_internal_pixel_format(texture.channels);
+            GLenum format = get_pixel_format(texture.channels, texture.bgr_order);
+            const auto *pixels = reinterpret_cast<const GLubyte *>(image.pixel_data.data());
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            count_uploaded_bytes(image.pixel_data.size());
+            if (!upload_in_bands) {
+                glTexImage2D(
+                    GL_TEXTURE_2D, 0, internal_format,
+                    static_cast<GLsizei>(texture.width),
+                    static_cast<GLsizei>(texture.height),
+                    0, format, GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const GLvoid *>(pixels)
+                );
+            } else {
+                glTexImage2D(
+                    GL_TEXTURE_2D, 0, internal_format,
+                    static_cast<GLsizei>(texture.width),
+                    static_cast<GLsizei>(texture.height),
+                    0, format, GL_UNSIGNED_BYTE,
+                    nullptr
+                );
+
+                // Sent in bands with a flush in between, so the render context never waits behind one huge transfer.
+                size_t row_size{static_cast<size_t>(texture.width) * texture.channels};
+                unsigned int rows_per_band{
+                    static_cast<unsigned int>(std::max<size_t>(1, data::resource_upload_band_size / std::max<size_t>(1, row_size)))
+                };
+                for (unsigned int row = 0; row < texture.height; row += rows_per_band) {
+                    unsigned int row_count{std::min(rows_per_band, texture.height - row)};
+                    glTexSubImage2D(
+                        GL_TEXTURE_2D, 0,
+                        0, static_cast<GLint>(row),
+                        static_cast<GLsizei>(texture.width),
+                        static_cast<GLsizei>(row_count),
+                        format, GL_UNSIGNED_BYTE,
+                        reinterpret_cast<const GLvoid *>(pixels + row * row_size)
+                    );
+                    glFlush();
+                }
+            }
+
+            if (generate_mipmaps) {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+
+            bind_texture(GL_TEXTURE_2D, 0);
+
+            texture.memory_size =
+                calculate_texture_memory_size(texture.width, texture.height, texture.channels, generate_mipmaps);
+            account_memory(Textures, texture.memory_owner, static_cast<int64_t>(texture.memory_size));
+        }
+
+        static void upload_texture_array_images(Texture &texture, const std::vector<Image> &images, bool generate_mipmaps)
+        {
+            ASR_TRACE_SCOPE("upload_texture_array_images");
+
+            texture.type = Texture2DArray;
+            texture.width = images.front().width;
+            texture.height = images.front().height;
+            texture.channels = images.front().channels;
+            texture.layers = static_cast<unsigned int>(images.size());
+            texture.bgr_order = images.front().bgr_order;
+
+            glGenTextures(1, &texture.texture_object);
+            bind_texture(GL_TEXTURE_2D_ARRAY, texture.texture_object);
+            apply_texture_parameters(texture);
+
+            GLint internal_format = get_internal_pixel_format(texture.channels);
+            GLenum format = get_pixel_format(texture.channels, texture.bgr_order);
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage3D(
+                GL_TEXTURE_2D_ARRAY, 0, internal_format,
+                static_cast<GLsizei>(texture.width),
+                static_cast<GLsizei>(texture.height),
+                static_cast<GLsizei>(texture.layers),
+                0, format, GL_UNSIGNED_BYTE,
+                nullptr
+            );
+            for (unsigned int layer = 0; layer < texture.layers; ++layer) {
+                const Image &image = images[layer];
+                count_uploaded_bytes(image.pixel_data.size());
+                glTexSubImage3D(
+                    GL_TEXTURE_2D_ARRAY, 0,
+                    0, 0, static_cast<GLint>(layer),
+                    static_cast<GLsizei>(texture.width),
+                    static_cast<GLsizei>(texture.height),
+                    1, format, GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const GLvoid *>(image.pixel_data.data())
+                );
+            }
+
+            if (generate_mipmaps) {
+                glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+            }
+
+            bind_texture(GL_TEXTURE_2D_ARRAY, 0);
+
+            texture.memory_size =
+                calculate_texture_memory_size(texture.width, texture.height, texture.channels, generate_mipmaps) *
+                texture.layers;
+            account_memory(Textures, texture.memory_owner, static_cast<int64_t>(texture.memory_size));
+        }
+
+        static void upload_geometry_buffers(
+                        Geometry &geometry,
+                        const Vertex *vertices, size_t vertex_count,
+                        const unsigned int *indices, size_t index_count
+                    )
+        {
+            ASR_TRACE_SCOPE("upload_geometry_buffers");
+
+            GLuint vertex_buffer_object{0};
+            GLuint index_buffer_object{0};
+
+            // The element array binding belongs to a vertex array object, which may not exist on this thread.
+            glGenBuffers(1, &vertex_buffer_object);
+            geometry.vertex_buffer_object = static_cast<int>(vertex_buffer_object);
+            bind_buffer(GL_ARRAY_BUFFER, vertex_buffer_object);
+            upload_buffer_data(
+                GL_ARRAY_BUFFER,
+                vertex_count * sizeof(Vertex),
+                reinterpret_cast<const GLvoid *>(vertices),
+                GL_STATIC_DRAW
+            );
+
+            glGenBuffers(1, &index_buffer_object);
+            geometry.index_buffer_object = static_cast<int>(index_buffer_object);
+            bind_buffer(GL_ARRAY_BUFFER, index_buffer_object);
+            upload_buffer_data(
+                GL_ARRAY_BUFFER,
+                index_count * sizeof(unsigned int),
+                reinterpret_cast<const GLvoid *>(indices),
+                GL_STATIC_DRAW
+            );
+
+            bind_buffer(GL_ARRAY_BUFFER, 0);
+
+            geometry.vertex_buffer_size = vertex_count * sizeof(Vertex);
+            geometry.index_buffer_size = index_count * sizeof(unsigned int);
+            account_memory(
+                Buffers, geometry.memory_owner,
+                static_cast<int64_t>(geometry.vertex_buffer_size + geometry.index_buffer_size)
+            );
+        }
+
+        static void configure_vertex_array(Geometry &geometry)
+        {
+            GLuint vertex_array_object{0};
+
+#ifdef __APPLE__
+            glGenVertexArraysAPPLE(1, &vertex_array_object);
+#else
+            glGenVertexArrays(1, &vertex_array_object);
+#endif
+            bind_vertex_array(vertex_array_object);
+            geometry.vertex_array_object = static_cast<int>(vertex_array_object);
+
+            bind_buffer(GL_ARRAY_BUFFER, static_cast<GLuint>(geometry.vertex_buffer_object));
+            bind_buffer(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLuint>(geometry.index_buffer_object));
+
+            GLsizei stride = sizeof(Vertex);
+            glEnableVertexAttribArray(position_attribute_location);
+            glVertexAttribPointer(
+                position_attribute_location,
+                3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offsetof(Vertex, x))
+            );
+            glEnableVertexAttribArray(color_attribute_location);
+            glVertexAttribPointer(
+                color_attribute_location,
+                4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offsetof(Vertex, r))
+            );
+            glEnableVertexAttribArray(texture_coordinates_attribute_location);
+            glVertexAttribPointer(
+                texture_coordinates_attribute_location,
+                3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offsetof(Vertex, u))
+            );
+
+            bind_vertex_array(0);
+            bind_buffer(GL_ARRAY_BUFFER, 0);
+            bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+
+        /*
+         * Texture Streaming
+         */
+
+        static bool are_texture_streams_supported()
+        {
+            return (GLEW_VERSION_3_0 || (GLEW_ARB_pixel_buffer_object && GLEW_ARB_map_buffer_range)) && GLEW_ARB_sync;
+        }
+
+        static bool is_texture_stream_row_dirty(const TextureStreamBuffer &buffer, unsigned int row)
+        {
+            return buffer.dirty_rows.empty() || buffer.dirty_rows[buffer.y + row] != 0;
+        }
+
+        static void copy_texture_stream_rows(const TextureStreamBuffer &buffer)
+        {
+            for (unsigned int row = 0; row < buffer.height; ++row) {
+                if (!is_texture_stream_row_dirty(buffer, row)) continue;
+
+                std::memcpy(
+                    buffer.mapped_pixels + row * buffer.row_size,
+                    buffer.source_pixels + row * buffer.source_row_size,
+                    buffer.row_size
+                );
+            }
+        }
+
+        static void run_texture_stream_copier()
+        {
+#ifdef ASR_ENABLE_TRACING
+            get_thread_trace_buffer()->thread_name = "texture streaming";
+#endif
+
+            std::vector<TextureStreamBuffer *> copies;
+            copies.reserve(data::texture_stream_copy_queue_capacity);
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock{data::texture_stream_mutex};
+                    data::texture_stream_condition.wait(lock, [] {
+                        return data::texture_stream_thread_should_stop || !data::pending_texture_stream_copies.empty();
+                    });
+                    if (data::texture_stream_thread_should_stop) break;
+
+                    copies.swap(data::pending_texture_stream_copies);
+                }
+
+                for (TextureStreamBuffer *buffer : copies) {
+                    ASR_TRACE_SCOPE("copy_texture_stream_rows");
+                    copy_texture_stream_rows(*buffer);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock{data::texture_stream_mutex};
+                    for (TextureStreamBuffer *buffer : copies) {
+                        buffer->copied = true;
+                    }
+                }
+                data::texture_stream_condition.notify_all();
+                copies.clear();
+            }
+        }
+
+        static void start_texture_stream_copier()
+        {
+            if (data::texture_stream_thread.joinable()) return;
+
+            data::pending_texture_stream_copies.reserve(data::texture_stream_copy_queue_capacity);
+            data::texture_stream_thread_should_stop = false;
+            data::texture_stream_thread = std::thread{run_texture_stream_copier};
+        }
+
+        static void stop_texture_stream_copier()
+        {
+            if (!data::texture_stream_thread.joinable()) return;
+
+            {
+                std::lock_guard<std::mutex> lock{data::texture_stream_mutex};
+                data::texture_stream_thread_should_stop = true;
+            }
+            data::texture_stream_condition.notify_all();
+            data::texture_stream_thread.join();
+        }
+
+        static void wait_for_texture_stream_copy(TextureStreamBuffer &buffer)
+        {
+            std::unique_lock<std::mutex> lock{data::texture_stream_mutex};
+            data::texture_stream_condition.wait(lock, [&buffer] { return buffer.copied; });
+        }
+
+        static void commit_texture_stream_buffer(TextureStream &stream, TextureStreamBuffer &buffer)
+        {
+            ASR_TRACE_SCOPE("commit_texture_stream_buffer");
+
+            wait_for_texture_stream_copy(buffer);
+
+            bind_buffer(GL_PIXEL_UNPACK_BUFFER, buffer.pixel_buffer_object);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            buffer.mapped_pixels = nullptr;
+
+            unsigned int unit{data::gl_state.active_texture_unit};
+            GLuint previous_texture{data::gl_state.bound_textures[unit]};
+            GLenum previous_target{data::gl_state.bound_texture_targets[unit]};
+
+            const Texture &texture = stream.texture;
+            GLenum format = get_pixel_format(texture.channels, texture.bgr_order);
+            bind_texture(GL_TEXTURE_2D, texture.texture_object);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            // Every run of dirty rows becomes one transfer. Without tracking the whole region is a single run.
+            unsigned int row{0};
+            while (row < buffer.height) {
+                if (!is_texture_stream_row_dirty(buffer, row)) {
+                    ++row;
+                    continue;
+                }
+
+                unsigned int run_end{row + 1};
+                while (run_end < buffer.height && is_texture_stream_row_dirty(buffer, run_end)) {
+                    ++run_end;
+                }
+
+                glTexSubImage2D(
+                    GL_TEXTURE_2D, 0,
+                    static_cast<GLint>(buffer.x), static_cast<GLint>(buffer.y + row),
+                    static_cast<GLsizei>(buffer.width), static_cast<GLsizei>(run_end - row),
+                    format, GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const GLvoid *>(row * buffer.row_size)
+                );
+                count_uploaded_bytes((run_end - row) * buffer.row_size);
+
+                row = run_end;
+            }
+
+            bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            bind_texture(previous_target != 0 ? previous_target : GL_TEXTURE_2D, previous_texture);
+
+            buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            buffer.pending = false;
+        }
+
+        static void commit_texture_stream(TextureStream &stream)
+        {
+            // The oldest buffer is the one that is written next, so updates land in submission order.
+            for (unsigned int i = 0; i < texture_stream_buffer_count; ++i) {
+                TextureStreamBuffer &buffer = stream.buffers[(stream.next_buffer + i) % texture_stream_buffer_count];
+                if (buffer.pending) {
+                    commit_texture_stream_buffer(stream, buffer);
+                }
+            }
+        }
+
+        static void commit_texture_streams()
+        {
+            for (const auto &stream : data::texture_streams) {
+                commit_texture_stream(*stream);
+            }
+        }
+
+        // Buffers the GPU may still read, or that hold an update of this frame, are skipped rather than waited for.
+        static TextureStreamBuffer *acquire_texture_stream_buffer(TextureStream &stream)
+        {
+            for (unsigned int i = 0; i < texture_stream_buffer_count; ++i) {
+                unsigned int index{(stream.next_buffer + i) % texture_stream_buffer_count};
+                TextureStreamBuffer &buffer = stream.buffers[index];
+                if (buffer.pending) continue;
+
+                if (buffer.fence != nullptr) {
+                    GLenum status = glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+                    if (status == GL_TIMEOUT_EXPIRED) continue;
+                    if (status == GL_WAIT_FAILED) {
+                        std::cerr << "Failed to wait for a texture stream fence, finishing all OpenGL work instead" << std::endl;
+                        glFinish();
+                    }
+                    glDeleteSync(buffer.fence);
+                    buffer.fence = nullptr;
+                }
+
+                stream.next_buffer = (index + 1) % texture_stream_buffer_count;
+                return &buffer;
+            }
+
+            return nullptr;
+        }
+
+        /*
+         * Virtual Texturing
+         */
+
+        static inline uint64_t make_virtual_texture_tile_key(unsigned int level, unsigned int x, unsigned int y)
+        {
+            return (static_cast<uint64_t>(level) << 48) | (static_cast<uint64_t>(y) << 24) | x;
+        }
+
+        static inline void split_virtual_texture_tile_key(uint64_t key, unsigned int &level, unsigned int &x, unsigned int &y)
+        {
+            level = static_cast<unsigned int>(key >> 48);
+            y = static_cast<unsigned int>((key >> 24) & 0xFFFFFF);
+            x = static_cast<unsigned int>(key & 0xFFFFFF);
+        }
+
+        static inline int32_t &get_virtual_texture_tile_slot(VirtualTexture &texture, unsigned int level, unsigned int x, unsigned int y)
+        {
+            return texture.tile_slots[level][y * (texture.tiles_per_side >> level) + x];
+        }
+
+        static void run_virtual_texture_loader(VirtualTexture *texture)
+        {
+            for (;;) {
+                VirtualTextureTileData tile;
+                {
+                    std::lock_guard<std::mutex> lock{texture->mutex};
+                    if (texture->loader_should_stop ||
+                        texture->next_requested_tile == texture->requested_tiles.size() ||
+                        texture->free_tile_buffers.empty()) {
+                        --texture->active_loader_jobs;
+                        break;
+                    }
+
+                    tile.tile_key = texture->requested_tiles[texture->next_requested_tile++];
+                    tile.pixels = std::move(texture->free_tile_buffers.back());
+                    texture->free_tile_buffers.pop_back();
+                }
+
+                {
+                    ASR_TRACE_SCOPE("provide_virtual_texture_tile");
+
+                    unsigned int level, x, y;
+                    split_virtual_texture_tile_key(tile.tile_key, level, x, y);
+                    tile.loaded = texture->provider(
+                        level,
+                        static_cast<int>(x * texture->tile_size) - static_cast<int>(virtual_texture_tile_border),
+                        static_cast<int>(y * texture->tile_size) - static_cast<int>(virtual_texture_tile_border),
+                        texture->padded_tile_size, texture->padded_tile_size,
+                        tile.pixels.data()
+                    );
+                }
+
+                std::lock_guard<std::mutex> lock{texture->mutex};
+                texture->finished_tiles.push_back(std::move(tile));
+            }
+        }
+
+        // Loader jobs hold a plain pointer to the texture, so they have to be done before it goes away.
+        static void stop_virtual_texture_loaders(VirtualTexture &texture)
+        {
+            {
+                std::lock_guard<std::mutex> lock{texture.mutex};
+                texture.loader_should_stop = true;
+            }
+            wait_for_job_group(texture.loader_jobs);
+            assert(texture.active_loader_jobs == 0);
+        }
+
+        // Expects the texture mutex to be held.
+        static void schedule_virtual_texture_loads(VirtualTexture &texture)
+        {
+            size_t loadable_count{std::min(
+                texture.requested_tiles.size() - texture.next_requested_tile, texture.free_tile_buffers.size()
+            )};
+            while (!texture.loader_should_stop &&
+                   texture.active_loader_jobs < std::min<size_t>(texture.max_loader_jobs, loadable_count)) {
+                ++texture.active_loader_jobs;
+                VirtualTexture *texture_pointer = &texture;
+                schedule_job([texture_pointer] { run_virtual_texture_loader(texture_pointer); }, {}, &texture.loader_jobs, true);
+            }
+        }
+
+        static void upload_virtual_texture_indirection(
+                        VirtualTexture &texture, unsigned int level,
+                        unsigned int x, unsigned int y, unsigned int size
+                    )
+        {
+            unsigned int side{texture.tiles_per_side >> level};
+            const uint32_t *texels = texture.indirection_levels[level].data() + y * side + x;
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(side));
+            glTexSubImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(level),
+                static_cast<GLint>(x), static_cast<GLint>(y),
+                static_cast<GLsizei>(size), static_cast<GLsizei>(size),
+                GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const GLvoid *>(texels)
+            );
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            count_uploaded_bytes(static_cast<size_t>(size) * size * sizeof(uint32_t));
+        }
+
+        // Tiles that are not resident point at the closest resident ancestor.
+        static void refresh_virtual_texture_indirection(VirtualTexture &texture, unsigned int level, unsigned int x, unsigned int y)
+        {
+            for (int current_level = static_cast<int>(level); current_level >= 0; --current_level) {
+                auto l = static_cast<unsigned int>(current_level);
+                unsigned int scale{1u << (level - l)};
+                unsigned int side{texture.tiles_per_side >> l};
+                unsigned int parent_side{side / 2};
+
+                std::vector<uint32_t> &texels = texture.indirection_levels[l];
+                for (unsigned int tile_y = y * scale; tile_y < (y + 1) * scale; ++tile_y) {
+                    for (unsigned int tile_x = x * scale; tile_x < (x + 1) * scale; ++tile_x) {
+                        int32_t slot{texture.tile_slots[l][tile_y * side + tile_x]};
+
+                        uint32_t entry{0};
+                        if (slot >= 0) {
+                            auto slot_x = static_cast<uint32_t>(slot) % texture.atlas_tiles_per_side;
+                            auto slot_y = static_cast<uint32_t>(slot) / texture.atlas_tiles_per_side;
+                            entry = slot_x | (slot_y << 8) | (l << 16) | (0xFFu << 24);
+                        } else if (l + 1 < texture.level_count) {
+                            entry = texture.indirection_levels[l + 1][(tile_y / 2) * parent_side + tile_x / 2];
+                        }
+                        texels[tile_y * side + tile_x] = entry;
+                    }
+                }
+
+                upload_virtual_texture_indirection(texture, l, x * scale, y * scale, scale);
+            }
+        }
+
+        static int32_t allocate_virtual_texture_slot(VirtualTexture &texture)
+        {
+            int32_t victim{-1};
+            for (size_t i = 0; i < texture.slots.size(); ++i) {
+                const VirtualTextureSlot &slot = texture.slots[i];
+                if (!slot.occupied) return static_cast<int32_t>(i);
+                if (slot.pinned || slot.last_used_frame == texture.frame) continue;
+                if (victim == -1 || slot.last_used_frame < texture.slots[static_cast<size_t>(victim)].last_used_frame) {
+                    victim = static_cast<int32_t>(i);
+                }
+            }
+            if (victim == -1) return -1;
+
+            VirtualTextureSlot &slot = texture.slots[static_cast<size_t>(victim)];
+            unsigned int level, x, y;
+            split_virtual_texture_tile_key(slot.tile_key, level, x, y);
+            get_virtual_texture_tile_slot(texture, level, x, y) = virtual_texture_tile_absent;
+            slot.occupied = false;
+            refresh_virtual_texture_indirection(texture, level, x, y);
+
+            return victim;
+        }
+
+        static void commit_virtual_texture_tile(VirtualTexture &texture, const VirtualTextureTileData &tile)
+        {
+            unsigned int level, x, y;
+            split_virtual_texture_tile_key(tile.tile_key, level, x, y);
+
+            int32_t &tile_slot = get_virtual_texture_tile_slot(texture, level, x, y);
+            bind_texture(GL_TEXTURE_2D, texture.indirection_texture.texture_object);
+            int32_t slot_index{tile.loaded ? allocate_virtual_texture_slot(texture) : -1};
+            if (slot_index == -1) {
+                tile_slot = virtual_texture_tile_absent;
+                return;
+            }
+
+            VirtualTextureSlot &slot = texture.slots[static_cast<size_t>(slot_index)];
+            slot.tile_key = tile.tile_key;
+            slot.last_used_frame = texture.frame;
+            slot.occupied = true;
+            slot.pinned = level + 1 == texture.level_count;
+
+            bind_texture(GL_TEXTURE_2D, texture.atlas_texture.texture_object);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexSubImage2D(
+                GL_TEXTURE_2D, 0,
+                static_cast<GLint>((static_cast<unsigned int>(slot_index) % texture.atlas_tiles_per_side) * texture.padded_tile_size),
+                static_cast<GLint>((static_cast<unsigned int>(slot_index) / texture.atlas_tiles_per_side) * texture.padded_tile_size),
+                static_cast<GLsizei>(texture.padded_tile_size), static_cast<GLsizei>(texture.padded_tile_size),
+                GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const GLvoid *>(tile.pixels.data())
+            );
+            count_uploaded_bytes(tile.pixels.size());
+
+            tile_slot = slot_index;
+            bind_texture(GL_TEXTURE_2D, texture.indirection_texture.texture_object);
+            refresh_virtual_texture_indirection(texture, level, x, y);
+        }
+
+        /*
+         * Archives
+         */
+
+        static uint64_t align_archive_offset(uint64_t offset)
+        {
+            return (offset + archive_alignment - 1) / archive_alignment * archive_alignment;
+        }
+
+        static bool map_file(const std::string &path, MappedFile &mapped_file, std::string &error)
+        {
+#ifdef _WIN32
+            HANDLE file = CreateFileA(
+                path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr
+            );
+            if (file == INVALID_HANDLE_VALUE) {
+                error = "Failed to open the file: '" + path + "'";
+                return false;
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+                CloseHandle(file);
+                error = "Failed to map the empty or unreadable file: '" + path + "'";
+                return false;
+            }
+
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (!view) {
+                if (mapping) CloseHandle(mapping);
+                CloseHandle(file);
+                error = "Failed to map the file: '" + path + "'";
+                return false;
+            }
+
+            mapped_file.file = file;
+            mapped_file.mapping = mapping;
+            mapped_file.data = static_cast<const uint8_t *>(view);
+            mapped_file.size = static_cast<size_t>(file_size.QuadPart);
+#else
+            int file = open(path.c_str(), O_RDONLY);
+            if (file < 0) {
+                error = "Failed to open the file: '" + path + "'";
+                return false;
+            }
+
+            struct stat file_status{};
+            if (fstat(file, &file_status) != 0 || file_status.st_size == 0) {
+                close(file);
+                error = "Failed to map the empty or unreadable file: '" + path + "'";
+                return false;
+            }
+
+            auto size = static_cast<size_t>(file_status.st_size);
+            void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (view == MAP_FAILED) {
+                close(file);
+                error = "Failed to map the file: '" + path + "'";
+                return false;
+            }
+
+            mapped_file.file = file;
+            mapped_file.data = static_cast<const uint8_t *>(view);
+            mapped_file.size = size;
+#endif
+
+            return true;
+        }
+
+        static void unmap_file(MappedFile &mapped_file)
+        {
+            if (!mapped_file.data) return;
+
+#ifdef _WIN32
+            UnmapViewOfFile(mapped_file.data);
+            CloseHandle(mapped_file.mapping);
+            CloseHandle(mapped_file.file);
+            mapped_file.mapping = nullptr;
+            mapped_file.file = INVALID_HANDLE_VALUE;
+#else
+            munmap(const_cast<uint8_t *>(mapped_file.data), mapped_file.size);
+            close(mapped_file.file);
+            mapped_file.file = -1;
+#endif
+            mapped_file.data = nullptr;
+            mapped_file.size = 0;
+        }
+
+        // Requested ahead, so the driver copy does not fault on one page after another.
+        static void prefetch_mapped_range(const MappedFile &mapped_file, uint64_t offset, uint64_t size)
+        {
+#ifdef _WIN32
+            (void) mapped_file;
+            (void) offset;
+            (void) size;
+#else
+            auto page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+            uint64_t page_offset{offset / page_size * page_size};
+            madvise(
+                const_cast<uint8_t *>(mapped_file.data) + page_offset,
+                static_cast<size_t>(offset + size - page_offset),
+                MADV_WILLNEED
+            );
+#endif
+        }
+
+        static bool validate_archive(const Archive &archive, std::string &error)
+        {
+            const MappedFile &file = archive.file;
+            if (file.size < sizeof(ArchiveHeader)) {
+                error = "The file is too small to be an archive: '" + archive.path + "'";
+                return false;
+            }
+
+            const auto *header = reinterpret_cast<const ArchiveHeader *>(file.data);
+            if (std::memcmp(header->magic, archive_magic, sizeof(archive_magic)) != 0) {
+                error = "The file is not an archive: '" + archive.path + "'";
+                return false;
+            }
+            if (header->version != archive_version) {
+                error = "Unsupported archive version " + std::to_string(header->version) + ": '" + archive.path + "'";
+                return false;
+            }
+
+            uint64_t table_of_contents_size{static_cast<uint64_t>(header->entry_count) * sizeof(ArchiveEntry)};
+            if (header->table_of_contents_offset % archive_alignment != 0 ||
+                header->table_of_contents_offset > file.size ||
+                table_of_contents_size > file.size - header->table_of_contents_offset) {
+                error = "The table of contents is out of bounds: '" + archive.path + "'";
+                return false;
+            }
+
+            const auto *entries = reinterpret_cast<const ArchiveEntry *>(file.data + header->table_of_contents_offset);
+            for (uint32_t i = 0; i < header->entry_count; ++i) {
+                const ArchiveEntry &entry = entries[i];
+                bool valid{
+                    entry.name[archive_entry_name_size - 1] == '\0' &&
+                    entry.offset % archive_alignment == 0 &&
+                    entry.offset <= file.size && entry.size <= file.size - entry.offset &&
+                    entry.section_count <= archive_max_sections
+                };
+                for (uint32_t section = 0; valid && section < entry.section_count; ++section) {
+                    valid = entry.section_offsets[section] % archive_alignment == 0 &&
+                            entry.section_offsets[section] <= entry.size &&
+                            entry.section_sizes[section] <= entry.size - entry.section_offsets[section];
+                }
+                if (valid && entry.type == ArchiveTexture) {
+                    valid = entry.section_count >= 1 && entry.channels >= 1 && entry.channels <= 4 &&
+                            entry.width >= 1 && entry.height >= 1;
+
+                    // Every section is one level of the mip chain, which ends at 1 x 1.
+                    uint64_t width{entry.width}, height{entry.height};
+                    for (uint32_t level = 0; valid && level < entry.section_count; ++level) {
+                        valid = entry.section_sizes[level] == width * height * entry.channels &&
+                                (level + 1 == entry.section_count || width > 1 || height > 1);
+                        width = std::max<uint64_t>(1, width / 2);
+                        height = std::max<uint64_t>(1, height / 2);
+                    }
+                } else if (valid && entry.type == ArchiveGeometry) {
+                    valid = entry.section_count == 2 &&
+                            entry.geometry_type <= static_cast<uint32_t>(TriangleStrip) &&
+                            entry.section_sizes[0] == static_cast<uint64_t>(entry.vertex_count) * sizeof(Vertex) &&
+                            entry.section_sizes[1] == static_cast<uint64_t>(entry.index_count) * sizeof(unsigned int);
+                } else {
+                    valid = false;
+                }
+                if (i > 0 && std::strncmp(entries[i - 1].name, entry.name, archive_entry_name_size) >= 0) {
+                    valid = false;
+                }
+
+                if (!valid) {
+                    error = "The archive entry " + std::to_string(i) + " is corrupted: '" + archive.path + "'";
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static const ArchiveEntry *find_archive_entry(const Archive &archive, const std::string &name, ArchiveEntryType type)
+        {
+            const ArchiveEntry *begin = archive.entries;
+            const ArchiveEntry *end = archive.entries + archive.header->entry_count;
+            const ArchiveEntry *entry = std::lower_bound(begin, end, name, [](const ArchiveEntry &entry, const std::string &name) {
+                return std::strncmp(entry.name, name.c_str(), archive_entry_name_size) < 0;
+            });
+            if (entry == end || name != entry->name || entry->type != type) {
+                return nullptr;
+            }
+
+            return entry;
+        }
+
+        static void downsample_archive_image(
+                        const uint8_t *source, unsigned int width, unsigned int height, unsigned int channels,
+                        uint8_t *destination
+                    )
+        {
+            unsigned int next_width{std::max(1u, width / 2)};
+            unsigned int next_height{std::max(1u, height / 2)};
+            for (unsigned int y = 0; y < next_height; ++y) {
+                unsigned int y0{std::min(y * 2, height - 1)};
+                unsigned int y1{std::min(y * 2 + 1, height - 1)};
+                for (unsigned int x = 0; x < next_width; ++x) {
+                    unsigned int x0{std::min(x * 2, width - 1)};
+                    unsigned int x1{std::min(x * 2 + 1, width - 1)};
+                    for (unsigned int channel = 0; channel < channels; ++channel) {
+                        unsigned int sum{
+                            static_cast<unsigned int>(source[(static_cast<size_t>(y0) * width + x0) * channels + channel]) +
+                            source[(static_cast<size_t>(y0) * width + x1) * channels + channel] +
+                            source[(static_cast<size_t>(y1) * width + x0) * channels + channel] +
+                            source[(static_cast<size_t>(y1) * width + x1) * channels + channel]
+                        };
+                        destination[(static_cast<size_t>(y) * next_width + x) * channels + channel] =
+                            static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+
+        static ArchiveEntry &add_archive_entry(ArchiveBuilder &builder, const std::string &name, ArchiveEntryType type)
+        {
+            if (name.empty() || name.size() >= archive_entry_name_size) {
+                std::cerr << "Archive entry names must have 1 to " << archive_entry_name_size - 1
+                          << " characters: '" << name << "'" << std::endl;
+                std::exit(-1);
+            }
+            for (const auto &entry : builder.entries) {
+                if (name == entry.name) {
+                    std::cerr << "The archive already has an entry named '" << name << "'" << std::endl;
+                    std::exit(-1);
+                }
+            }
+
+            ArchiveEntry entry{};
+            std::memcpy(entry.name, name.c_str(), name.size());
+            entry.type = type;
+
+            builder.entries.push_back(entry);
+            builder.sections.emplace_back();
+
+            return builder.entries.back();
+        }
+
+        /*
+         * Geometry Files
+         */
+
+        using GeometryFileData = std::vector<uint8_t, MemoryTrackingAllocator<uint8_t, Pools>>;
+
+        static GeometryFileHeader make_geometry_file_header(
+                                      GeometryType type,
+                                      const Vertex *vertices, size_t vertex_count,
+                                      size_t index_count
+                                  )
+        {
+            GeometryFileHeader header{};
+            std::memcpy(header.magic, geometry_file_magic, sizeof(geometry_file_magic));
+            header.version = geometry_file_version;
+            header.geometry_type = static_cast<uint32_t>(type);
+            header.vertex_count = static_cast<uint32_t>(vertex_count);
+            header.index_count = static_cast<uint32_t>(index_count);
+
+            header.vertex_stride = sizeof(Vertex);
+            header.attribute_count = geometry_file_attribute_count;
+            header.attributes[0] = GeometryFileAttribute{position_attribute_location, 3, offsetof(Vertex, x)};
+            header.attributes[1] = GeometryFileAttribute{color_attribute_location, 4, offsetof(Vertex, r)};
+            header.attributes[2] = GeometryFileAttribute{texture_coordinates_attribute_location, 3, offsetof(Vertex, u)};
+
+            glm::vec3 minimum{vertex_count > 0 ? glm::vec3{vertices[0].x, vertices[0].y, vertices[0].z} : glm::vec3{0.0f}};
+            glm::vec3 maximum{minimum};
+            for (size_t i = 1; i < vertex_count; ++i) {
+                glm::vec3 position{vertices[i].x, vertices[i].y, vertices[i].z};
+                minimum = glm::min(minimum, position);
+                maximum = glm::max(maximum, position);
+            }
+            for (int axis = 0; axis < 3; ++axis) {
+                header.bounds_minimum[axis] = minimum[axis];
+                header.bounds_maximum[axis] = maximum[axis];
+            }
+
+            return header;
+        }
+
+        // Files written by a build with a different vertex layout are rejected rather than misread.
+        static bool has_compatible_geometry_file_layout(const GeometryFileHeader &header)
+        {
+            GeometryFileHeader expected = make_geometry_file_header(Triangles, nullptr, 0, 0);
+
+            return header.vertex_stride == expected.vertex_stride &&
+                   header.attribute_count == expected.attribute_count &&
+                   std::memcmp(header.attributes, expected.attributes, sizeof(expected.attributes)) == 0;
+        }
+
+        // Writes the LZ4 block format. Returns 0 when the output does not fit.
+        static size_t compress_lz4_block(const uint8_t *source, size_t size, uint8_t *destination, size_t capacity)
+        {
+            static const size_t minimum_match{4};
+            static const size_t last_literals{5};
+            static const size_t match_find_limit{12};
+            static const unsigned int hash_bits{14};
+
+            size_t output{0};
+            auto put = [&](uint8_t byte) {
+                if (output >= capacity) return false;
+                destination[output++] = byte;
+                return true;
+            };
+            auto put_length = [&](size_t length) {
+                for (; length >= 255; length -= 255) {
+                    if (!put(255)) return false;
+                }
+                return put(static_cast<uint8_t>(length));
+            };
+            auto put_literals = [&](size_t from, size_t count) {
+                if (count > capacity - output) return false;
+                std::memcpy(destination + output, source + from, count);
+                output += count;
+                return true;
+            };
+            auto read_32 = [&](size_t position) {
+                uint32_t value;
+                std::memcpy(&value, source + position, sizeof(value));
+                return value;
+            };
+
+            std::vector<uint32_t> table(static_cast<size_t>(1) << hash_bits, 0);
+            size_t anchor{0};
+            size_t position{0};
+            while (size > match_find_limit && position + match_find_limit <= size) {
+                uint32_t sequence{read_32(position)};
+                uint32_t hash{(sequence * 2654435761u) >> (32 - hash_bits)};
+                size_t candidate{table[hash]};
+                table[hash] = static_cast<uint32_t>(position + 1);
+
+                if (candidate == 0 || position - (candidate - 1) > 65535 || read_32(candidate - 1) != sequence) {
+                    ++position;
+                    continue;
+                }
+
+                size_t match{candidate - 1};
+                size_t length{minimum_match};
+                while (position + length < size - last_literals && source[match + length] == source[position + length]) {
+                    ++length;
+                }
+
+                size_t literal_count{position - anchor};
+                size_t match_length{length - minimum_match};
+                if (!put(static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(match_length, 15)))) return 0;
+                if (literal_count >= 15 && !put_length(literal_count - 15)) return 0;
+                if (!put_literals(anchor, literal_count)) return 0;
+
+                size_t offset{position - match};
+                if (!put(static_cast<uint8_t>(offset & 0xFF)) || !put(static_cast<uint8_t>(offset >> 8))) return 0;
+                if (match_length >= 15 && !put_length(match_length - 15)) return 0;
+
+                position += length;
+                anchor = position;
+            }
+
+            size_t literal_count{size - anchor};
+            if (!put(static_cast<uint8_t>(std::min<size_t>(literal_count, 15) << 4))) return 0;
+            if (literal_count >= 15 && !put_length(literal_count - 15)) return 0;
+            if (!put_literals(anchor, literal_count)) return 0;
+
+            return output;
+        }
+
+        // Every read and write is bounds checked, so a corrupted file fails instead of overrunning the buffers.
+        static bool decompress_lz4_block(const uint8_t *source, size_t source_size, uint8_t *destination, size_t size)
+        {
+            size_t input{0};
+            size_t output{0};
+            auto read_length = [&](size_t &length) {
+                uint8_t byte;
+                do {
+                    if (input >= source_size) return false;
+                    byte = source[input++];
+                    length += byte;
+                } while (byte == 255);
+                return true;
+            };
+
+            while (input < source_size) {
+                uint8_t token{source[input++]};
+
+                size_t literal_count{static_cast<size_t>(token >> 4)};
+                if (literal_count == 15 && !read_length(literal_count)) return false;
+                if (literal_count > source_size - input || literal_count > size - output) return false;
+                std::memcpy(destination + output, source + input, literal_count);
+                input += literal_count;
+                output += literal_count;
+
+                if (input == source_size) break;
+
+                if (source_size - input < 2) return false;
+                size_t offset{static_cast<size_t>(source[input]) | static_cast<size_t>(source[input + 1]) << 8};
+                input += 2;
+                if (offset == 0 || offset > output) return false;
+
+                size_t match_length{static_cast<size_t>(token & 0x0F)};
+                if (match_length == 15 && !read_length(match_length)) return false;
+                match_length += 4;
+                if (match_length > size - output) return false;
+
+                const uint8_t *match = destination + output - offset;
+                if (offset >= match_length) {
+                    std::memcpy(destination + output, match, match_length);
+                } else {
+                    for (size_t i = 0; i < match_length; ++i) {
+                        destination[output + i] = match[i];
+                    }
+                }
+                output += match_length;
+            }
+
+            return output == size;
+        }
+
+        static bool validate_geometry_file(const MappedFile &file, const std::string &path, std::string &error)
+        {
+            if (file.size < sizeof(GeometryFileHeader)) {
+                error = "The file is too small to be a geometry file: '" + path + "'";
+                return false;
+            }
+
+            const auto *header = reinterpret_cast<const GeometryFileHeader *>(file.data);
+            if (std::memcmp(header->magic, geometry_file_magic, sizeof(geometry_file_magic)) != 0) {
+                error = "The file is not a geometry file: '" + path + "'";
+                return false;
+            }
+            if (header->version != geometry_file_version || !has_compatible_geometry_file_layout(*header) ||
+                header->geometry_type > static_cast<uint32_t>(TriangleStrip)) {
+                error = "Unsupported geometry file version or vertex layout: '" + path + "'";
+                return false;
+            }
+
+            uint64_t vertex_data_size{static_cast<uint64_t>(header->vertex_count) * sizeof(Vertex)};
+            uint64_t index_data_size{static_cast<uint64_t>(header->index_count) * sizeof(unsigned int)};
+            // Offsets come from the file, so the checks subtract from them instead of adding to them.
+            bool valid{
+                header->vertex_data_offset % geometry_file_alignment == 0 &&
+                header->index_data_offset % geometry_file_alignment == 0 &&
+                header->vertex_data_offset <= header->index_data_offset &&
+                vertex_data_size <= header->index_data_offset - header->vertex_data_offset
+            };
+
+            if (valid && header->compression == UncompressedGeometryFile) {
+                valid = header->index_data_offset <= file.size && index_data_size <= file.size - header->index_data_offset;
+            } else if (valid && header->compression == LZ4GeometryFile) {
+                // The decompressed stream starts with the vertices and pads them to the alignment only.
+                valid = header->vertex_data_offset == 0 && header->index_data_offset - vertex_data_size < geometry_file_alignment;
+
+                uint64_t stream_size{header->index_data_offset + index_data_size};
+                uint64_t table_size{static_cast<uint64_t>(header->chunk_count) * sizeof(GeometryFileChunk)};
+                valid = valid && header->chunk_table_offset % alignof(GeometryFileChunk) == 0 &&
+                        header->chunk_table_offset <= file.size && table_size <= file.size - header->chunk_table_offset &&
+                        header->chunk_count == (stream_size + geometry_file_chunk_size - 1) / geometry_file_chunk_size;
+
+                const auto *chunks = reinterpret_cast<const GeometryFileChunk *>(file.data + header->chunk_table_offset);
+                for (uint32_t i = 0; valid && i < header->chunk_count; ++i) {
+                    uint64_t expected_size{std::min<uint64_t>(geometry_file_chunk_size, stream_size - static_cast<uint64_t>(i) * geometry_file_chunk_size)};
+                    valid = chunks[i].size == expected_size && chunks[i].compressed_size <= chunks[i].size &&
+                            chunks[i].offset <= file.size && chunks[i].compressed_size <= file.size - chunks[i].offset;
+                }
+            } else {
+                valid = false;
+            }
+
+            if (!valid) {
+                error = "The geometry file is corrupted: '" + path + "'";
+                return false;
+            }
+
+            return true;
+        }
+
+        /*
+         * Geometry Importing
+         */
+
+        static const char *skip_spaces(const char *position, const char *end)
+        {
+            while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) ++position;
+            return position;
+        }
+
+        static const char *skip_line(const char *position, const char *end)
+        {
+            const auto *line_end = static_cast<const char *>(std::memchr(position, '\n', static_cast<size_t>(end - position)));
+            return line_end ? line_end + 1 : end;
+        }
+
+        static std::vector<std::pair<const char *, const char *>> split_into_line_chunks(const char *begin, const char *end)
+        {
+            std::vector<std::pair<const char *, const char *>> chunks;
+            while (begin < end) {
+                const char *chunk_end = begin + std::min(geometry_import_chunk_size, static_cast<size_t>(end - begin));
+                if (chunk_end < end) chunk_end = skip_line(chunk_end, end);
+                chunks.emplace_back(begin, chunk_end);
+                begin = chunk_end;
+            }
+
+            return chunks;
+        }
+
+        static bool parse_integer(const char *&position, const char *end, int64_t &value)
+        {
+            const char *current = skip_spaces(position, end);
+            bool negative{false};
+            if (current < end && (*current == '-' || *current == '+')) negative = *current++ == '-';
+
+            const char *digits_begin = current;
+            int64_t result{0};
+            while (current < end && *current >= '0' && *current <= '9' && current - digits_begin < 18) {
+                result = result * 10 + (*current++ - '0');
+            }
+            if (current == digits_begin) return false;
+
+            value = negative ? -result : result;
+            position = current;
+
+            return true;
+        }
+
+        // Up to 19 significant digits scaled by one exact power of ten stay within an ulp after rounding to float.
+        static bool parse_float(const char *&position, const char *end, float &value)
+        {
+            static const double powers_of_ten[]{
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            const char *current = skip_spaces(position, end);
+            bool negative{false};
+            if (current < end && (*current == '-' || *current == '+')) negative = *current++ == '-';
+
+            uint64_t mantissa{0};
+            int exponent{0};
+            bool has_digits{false};
+            for (; current < end && *current >= '0' && *current <= '9'; ++current) {
+                has_digits = true;
+                if (mantissa < 1000000000000000000ull) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+                } else {
+                    ++exponent;
+                }
+            }
+            if (current < end && *current == '.') {
+                for (++current; current < end && *current >= '0' && *current <= '9'; ++current) {
+                    has_digits = true;
+                    if (mantissa < 1000000000000000000ull) {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+                        --exponent;
+                    }
+                }
+            }
+            if (!has_digits) return false;
+
+            if (current < end && (*current == 'e' || *current == 'E')) {
+                const char *exponent_position = current + 1;
+                int64_t written_exponent;
+                if (exponent_position < end && *exponent_position != ' ' &&
+                    parse_integer(exponent_position, end, written_exponent)) {
+                    exponent += static_cast<int>(std::max<int64_t>(-1000, std::min<int64_t>(1000, written_exponent)));
+                    current = exponent_position;
+                }
+            }
+
+            auto result = static_cast<double>(mantissa);
+            if (mantissa != 0) {
+                int magnitude{std::abs(exponent)};
+                double scale{magnitude <= 22 ? powers_of_ten[magnitude] : std::pow(10.0, magnitude)};
+                result = exponent < 0 ? result / scale : result * scale;
+            }
+
+            value = static_cast<float>(negative ? -result : result);
+            position = current;
+
+            return true;
+        }
+
+        static void parse_obj_chunk(const char *position, const char *end, ObjChunk &chunk)
+        {
+            std::vector<int64_t> face_positions;
+            std::vector<int64_t> face_texture_coordinates;
+
+            while (position < end) {
+                position = skip_spaces(position, end);
+                const char *line_end = skip_line(position, end);
+
+                if (line_end - position > 2 && position[0] == 'v' && position[1] == ' ') {
+                    position += 2;
+                    float values[6]{0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+                    int count{0};
+                    while (count < 6 && parse_float(position, line_end, values[count])) ++count;
+                    if (count < 3) {
+                        chunk.failed = true;
+                        return;
+                    }
+                    // Only six values are x y z r g b; a fourth value on its own is the weight w, not red.
+                    if (count != 6) std::fill(values + 3, values + 6, 1.0f);
+                    chunk.positions.insert(chunk.positions.end(), values, values + 3);
+                    chunk.colors.insert(chunk.colors.end(), values + 3, values + 6);
+                    chunk.has_colors = chunk.has_colors || count == 6;
+                } else if (line_end - position > 3 && position[0] == 'v' && position[1] == 't' && position[2] == ' ') {
+                    position += 3;
+                    float u{0.0f}, v{0.0f};
+                    if (!parse_float(position, line_end, u)) {
+                        chunk.failed = true;
+                        return;
+                    }
+                    parse_float(position, line_end, v);
+                    chunk.texture_coordinates.push_back(u);
+                    chunk.texture_coordinates.push_back(v);
+                } else if (line_end - position > 2 && position[0] == 'f' && position[1] == ' ') {
+                    position += 2;
+                    face_positions.clear();
+                    face_texture_coordinates.clear();
+
+                    auto local_positions = static_cast<int64_t>(chunk.positions.size() / 3);
+                    auto local_texture_coordinates = static_cast<int64_t>(chunk.texture_coordinates.size() / 2);
+                    auto resolve = [](int64_t index, int64_t local_count) {
+                        return index > 0 ? index - 1 : obj_relative_index_bias + local_count + index;
+                    };
+
+                    int64_t index;
+                    while (parse_integer(position, line_end, index)) {
+                        if (index == 0) {
+                            chunk.failed = true;
+                            return;
+                        }
+                        face_positions.push_back(resolve(index, local_positions));
+
+                        // Corners are v, v/vt, v//vn or v/vt/vn; normals are not part of the vertex format.
+                        int64_t texture_coordinate{-1};
+                        if (position < line_end && *position == '/') {
+                            ++position;
+                            if (position < line_end && *position != '/' && parse_integer(position, line_end, index)) {
+                                texture_coordinate = resolve(index, local_texture_coordinates);
+                            }
+                            if (position < line_end && *position == '/') {
+                                ++position;
+                                parse_integer(position, line_end, index);
+                            }
+                        }
+                        face_texture_coordinates.push_back(texture_coordinate);
+                    }
+
+                    for (size_t i = 2; i < face_positions.size(); ++i) {
+                        for (size_t corner : {static_cast<size_t>(0), i - 1, i}) {
+                            chunk.position_indices.push_back(face_positions[corner]);
+                            chunk.texture_coordinate_indices.push_back(face_texture_coordinates[corner]);
+                        }
+                    }
+                }
+
+                position = line_end;
+            }
+        }
+
+        static size_t get_ply_type_size(PlyType type)
+        {
+            switch (type) {
+                case PlyInt8:
+                case PlyUInt8:
+                    return 1;
+                case PlyInt16:
+                case PlyUInt16:
+                    return 2;
+                case PlyInt32:
+                case PlyUInt32:
+                case PlyFloat32:
+                    return 4;
+                case PlyFloat64:
+                    return 8;
+            }
+
+            return 0;
+        }
+
+        static bool parse_ply_type(const std::string &name, PlyType &type)
+        {
+            static const std::pair<const char *, PlyType> names[]{
+                {"char", PlyInt8}, {"int8", PlyInt8}, {"uchar", PlyUInt8}, {"uint8", PlyUInt8},
+                {"short", PlyInt16}, {"int16", PlyInt16}, {"ushort", PlyUInt16}, {"uint16", PlyUInt16},
+                {"int", PlyInt32}, {"int32", PlyInt32}, {"uint", PlyUInt32}, {"uint32", PlyUInt32},
+                {"float", PlyFloat32}, {"float32", PlyFloat32}, {"double", PlyFloat64}, {"float64", PlyFloat64}
+            };
+            for (const auto &entry : names) {
+                if (name == entry.first) {
+                    type = entry.second;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        static int get_ply_vertex_attribute(const std::string &name)
+        {
+            static const std::pair<const char *, PlyVertexAttribute> names[]{
+                {"x", PlyX}, {"y", PlyY}, {"z", PlyZ},
+                {"red", PlyRed}, {"green", PlyGreen}, {"blue", PlyBlue}, {"alpha", PlyAlpha},
+                {"r", PlyRed}, {"g", PlyGreen}, {"b", PlyBlue}, {"a", PlyAlpha},
+                {"u", PlyU}, {"v", PlyV}, {"s", PlyU}, {"t", PlyV}, {"texture_u", PlyU}, {"texture_v", PlyV}
+            };
+            for (const auto &entry : names) {
+                if (name == entry.first) return entry.second;
+            }
+
+            return PlyIgnored;
+        }
+
+        static bool read_ply_header(
+                        const char *&position, const char *end,
+                        PlyFormat &format, std::vector<PlyElement> &elements, std::string &error
+                    )
+        {
+            bool has_format{false};
+            for (bool first_line{true}; ; first_line = false) {
+                if (position >= end) {
+                    error = "The PLY header has no end";
+                    return false;
+                }
+
+                const char *line_end = skip_line(position, end);
+                std::vector<std::string> words;
+                for (const char *word = skip_spaces(position, line_end); word < line_end && *word != '\n'; ) {
+                    const char *word_end = word;
+                    while (word_end < line_end && *word_end != ' ' && *word_end != '\t' && *word_end != '\r' && *word_end != '\n') {
+                        ++word_end;
+                    }
+                    words.emplace_back(word, word_end);
+                    word = skip_spaces(word_end, line_end);
+                }
+                position = line_end;
+
+                if (first_line) {
+                    if (words.size() != 1 || words[0] != "ply") {
+                        error = "The file is not a PLY file";
+                        return false;
+                    }
+                } else if (words.empty() || words[0] == "comment" || words[0] == "obj_info") {
+                    continue;
+                } else if (words[0] == "format" && words.size() >= 2) {
+                    has_format = true;
+                    if (words[1] == "ascii") {
+                        format = PlyAscii;
+                    } else if (words[1] == "binary_little_endian") {
+                        format = PlyBinaryLittleEndian;
+                    } else if (words[1] == "binary_big_endian") {
+                        format = PlyBinaryBigEndian;
+                    } else {
+                        error = "Unknown PLY format '" + words[1] + "'";
+                        return false;
+                    }
+                } else if (words[0] == "element" && words.size() == 3) {
+                    elements.emplace_back();
+                    elements.back().name = words[1];
+                    elements.back().count = std::strtoull(words[2].c_str(), nullptr, 10);
+                } else if (words[0] == "property" && !elements.empty()) {
+                    PlyProperty property;
+                    bool valid;
+                    if (words.size() == 5 && words[1] == "list") {
+                        property.is_list = true;
+                        property.name = words[4];
+                        valid = parse_ply_type(words[2], property.count_type) && parse_ply_type(words[3], property.type);
+                    } else {
+                        property.name = words.size() == 3 ? words[2] : std::string{};
+                        valid = words.size() == 3 && parse_ply_type(words[1], property.type);
+                    }
+                    if (!valid) {
+                        error = "Unsupported PLY property declaration";
+                        return false;
+                    }
+                    if (elements.back().name == "vertex" && !property.is_list) {
+                        property.attribute = get_ply_vertex_attribute(property.name);
+                    }
+                    elements.back().properties.push_back(property);
+                } else if (words[0] == "end_header") {
+                    break;
+                } else {
+                    error = "Unsupported PLY header line '" + words[0] + "'";
+                    return false;
+                }
+            }
+
+            if (!has_format) {
+                error = "The PLY header has no format";
+                return false;
+            }
+
+            // Every row takes at least a byte, which bounds the counts before anything is allocated for them.
+            for (const auto &element : elements) {
+                if (element.count > static_cast<size_t>(end - position)) {
+                    error = "The PLY element '" + element.name + "' has more rows than the file has bytes";
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static double read_ply_binary_value(const uint8_t *bytes, PlyType type, bool big_endian)
+        {
+            uint8_t value[8];
+            size_t size{get_ply_type_size(type)};
+            for (size_t i = 0; i < size; ++i) {
+                value[i] = bytes[big_endian ? size - 1 - i : i];
+            }
+
+            switch (type) {
+                case PlyInt8: { int8_t result; std::memcpy(&result, value, 1); return result; }
+                case PlyUInt8: return value[0];
+                case PlyInt16: { int16_t result; std::memcpy(&result, value, 2); return result; }
+                case PlyUInt16: { uint16_t result; std::memcpy(&result, value, 2); return result; }
+                case PlyInt32: { int32_t result; std::memcpy(&result, value, 4); return result; }
+                case PlyUInt32: { uint32_t result; std::memcpy(&result, value, 4); return result; }
+                case PlyFloat32: { float result; std::memcpy(&result, value, 4); return result; }
+                case PlyFloat64: { double result; std::memcpy(&result, value, 8); return result; }
+            }
+
+            return 0.0;
+        }
+
+        static void set_ply_vertex_attribute(Vertex &vertex, const PlyProperty &property, double value)
+        {
+            auto component = static_cast<float>(value);
+            if (property.attribute >= PlyRed && property.attribute <= PlyAlpha &&
+                property.type != PlyFloat32 && property.type != PlyFloat64) {
+                component /= property.type == PlyUInt16 ? 65535.0f : 255.0f;
+            }
+
+            switch (property.attribute) {
+                case PlyX: vertex.x = component; break;
+                case PlyY: vertex.y = component; break;
+                case PlyZ: vertex.z = component; break;
+                case PlyRed: vertex.r = component; break;
+                case PlyGreen: vertex.g = component; break;
+                case PlyBlue: vertex.b = component; break;
+                case PlyAlpha: vertex.a = component; break;
+                case PlyU: vertex.u = component; break;
+                case PlyV: vertex.v = component; break;
+                default: break;
+            }
+        }
+
+        static bool is_ply_face_indices_property(const PlyElement &element, const PlyProperty &property)
+        {
+            return element.name == "face" && property.is_list &&
+                   (property.name == "vertex_indices" || property.name == "vertex_index");
+        }
+
+        static bool append_ply_face(const int64_t *face, size_t count, size_t vertex_count, std::vector<unsigned int> &indices)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                if (face[i] < 0 || static_cast<size_t>(face[i]) >= vertex_count) return false;
+            }
+            for (size_t i = 2; i < count; ++i) {
+                indices.push_back(static_cast<unsigned int>(face[0]));
+                indices.push_back(static_cast<unsigned int>(face[i - 1]));
+                indices.push_back(static_cast<unsigned int>(face[i]));
+            }
+
+            return true;
+        }
+
+        static std::vector<unsigned int> join_index_chunks(const std::vector<std::vector<unsigned int>> &chunks)
+        {
+            std::vector<size_t> offsets(chunks.size() + 1, 0);
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                offsets[i + 1] = offsets[i] + chunks[i].size();
+            }
+
+            std::vector<unsigned int> indices(offsets.back());
+            run_parallel_tasks(chunks.size(), [&](size_t i) {
+                std::copy(chunks[i].begin(), chunks[i].end(), indices.begin() + static_cast<std::ptrdiff_t>(offsets[i]));
+            });
+
+            return indices;
+        }
+
+        static bool read_ply_ascii_body(
+                        const char *begin, const char *end, const std::vector<PlyElement> &elements,
+                        GeometryData &geometry_data
+                    )
+        {
+            auto chunks = split_into_line_chunks(begin, end);
+
+            // Lines map to elements in order, so each chunk first needs the number of the line it starts at.
+            std::vector<size_t> first_lines(chunks.size() + 1, 0);
+            run_parallel_tasks(chunks.size(), [&](size_t i) {
+                first_lines[i + 1] = static_cast<size_t>(std::count(chunks[i].first, chunks[i].second, '\n'));
+            });
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                first_lines[i + 1] += first_lines[i];
+            }
+
+            std::vector<size_t> first_element_lines{0};
+            for (const auto &element : elements) {
+                first_element_lines.push_back(first_element_lines.back() + element.count);
+            }
+
+            std::vector<std::vector<unsigned int>> index_chunks(chunks.size());
+            std::atomic<bool> failed{false};
+            run_parallel_tasks(chunks.size(), [&](size_t chunk) {
+                std::vector<int64_t> face;
+                size_t line{first_lines[chunk]};
+                for (const char *position = chunks[chunk].first; position < chunks[chunk].second; ++line) {
+                    const char *line_end = skip_line(position, chunks[chunk].second);
+                    auto element_index = static_cast<size_t>(
+                        std::upper_bound(first_element_lines.begin(), first_element_lines.end(), line) -
+                        first_element_lines.begin() - 1
+                    );
+                    if (element_index >= elements.size()) break;
+
+                    const PlyElement &element = elements[element_index];
+                    size_t row{line - first_element_lines[element_index]};
+                    Vertex *vertex{element.name == "vertex" ? &geometry_data.first[row] : nullptr};
+
+                    bool valid{true};
+                    for (const auto &property : element.properties) {
+                        int64_t count{1};
+                        if (property.is_list && !parse_integer(position, line_end, count)) {
+                            valid = false;
+                            break;
+                        }
+
+                        face.clear();
+                        for (int64_t i = 0; i < count && valid; ++i) {
+                            if (is_ply_face_indices_property(element, property)) {
+                                int64_t index;
+                                valid = parse_integer(position, line_end, index);
+                                face.push_back(index);
+                            } else {
+                                float value;
+                                valid = parse_float(position, line_end, value);
+                                if (valid && vertex) set_ply_vertex_attribute(*vertex, property, value);
+                            }
+                        }
+                        if (valid && is_ply_face_indices_property(element, property)) {
+                            valid = append_ply_face(face.data(), face.size(), geometry_data.first.size(), index_chunks[chunk]);
+                        }
+                        if (!valid) break;
+                    }
+                    if (!valid) {
+                        failed = true;
+                        return;
+                    }
+
+                    position = line_end;
+                }
+            });
+
+            geometry_data.second = join_index_chunks(index_chunks);
+
+            return !failed && first_lines.back() + (end > begin && end[-1] != '\n' ? 1 : 0) >= first_element_lines.back();
+        }
+
+        static bool read_ply_binary_body(
+                        const uint8_t *position, const uint8_t *end, const std::vector<PlyElement> &elements,
+                        bool big_endian, GeometryData &geometry_data
+                    )
+        {
+            static const size_t rows_per_block{65536};
+
+            for (const auto &element : elements) {
+                size_t row_size{0};
+                bool fixed_size{true};
+                for (const auto &property : element.properties) {
+                    fixed_size = fixed_size && !property.is_list;
+                    row_size += get_ply_type_size(property.type);
+                }
+
+                // Rows of variable size are walked once to find where each block starts; the blocks decode in parallel.
+                std::vector<const uint8_t *> block_starts;
+                for (size_t row = 0; row < element.count; ++row) {
+                    if (row % rows_per_block == 0) block_starts.push_back(position);
+                    if (fixed_size) {
+                        if (row_size != 0 && element.count - row > static_cast<size_t>(end - position) / row_size) return false;
+                        position += row_size * std::min(rows_per_block, element.count - row);
+                        row += std::min(rows_per_block, element.count - row) - 1;
+                        continue;
+                    }
+                    for (const auto &property : element.properties) {
+                        size_t count{1};
+                        if (property.is_list) {
+                            if (get_ply_type_size(property.count_type) > static_cast<size_t>(end - position)) return false;
+                            double written_count{read_ply_binary_value(position, property.count_type, big_endian)};
+                            if (written_count < 0.0) return false;
+                            count = static_cast<size_t>(written_count);
+                            position += get_ply_type_size(property.count_type);
+                        }
+                        if (count > static_cast<size_t>(end - position) / get_ply_type_size(property.type)) return false;
+                        position += count * get_ply_type_size(property.type);
+                    }
+                }
+                block_starts.push_back(position);
+
+                bool is_vertex{element.name == "vertex"};
+                bool is_face{element.name == "face"};
+                if (!is_vertex && !is_face) continue;
+
+                size_t block_count{block_starts.size() - 1};
+                std::vector<std::vector<unsigned int>> index_chunks(block_count);
+                std::atomic<bool> failed{false};
+                run_parallel_tasks(block_count, [&](size_t block) {
+                    std::vector<int64_t> face;
+                    const uint8_t *current = block_starts[block];
+                    size_t first_row{block * rows_per_block};
+                    size_t last_row{std::min(element.count, first_row + rows_per_block)};
+                    for (size_t row = first_row; row < last_row; ++row) {
+                        for (const auto &property : element.properties) {
+                            size_t count{1};
+                            if (property.is_list) {
+                                count = static_cast<size_t>(read_ply_binary_value(current, property.count_type, big_endian));
+                                current += get_ply_type_size(property.count_type);
+                            }
+
+                            size_t value_size{get_ply_type_size(property.type)};
+                            if (is_vertex && property.attribute != PlyIgnored) {
+                                set_ply_vertex_attribute(
+                                    geometry_data.first[row], property, read_ply_binary_value(current, property.type, big_endian)
+                                );
+                            } else if (is_face && is_ply_face_indices_property(element, property)) {
+                                face.clear();
+                                for (size_t i = 0; i < count; ++i) {
+                                    face.push_back(static_cast<int64_t>(
+                                        read_ply_binary_value(current + i * value_size, property.type, big_endian)
+                                    ));
+                                }
+                                if (!append_ply_face(face.data(), face.size(), geometry_data.first.size(), index_chunks[block])) {
+                                    failed = true;
+                                    return;
+                                }
+                            }
+                            current += count * value_size;
+                        }
+                    }
+                });
+                if (failed) return false;
+
+                if (is_face) {
+                    geometry_data.second = join_index_chunks(index_chunks);
+                }
+            }
+
+            return true;
+        }
+
+        /*
+         * Particles
+         */
+
+        static float get_particle_random_number(ParticleSystem &system)
+        {
+            // xorshift64*, which is plenty for spreading particles and much cheaper than <random>.
+            system.random_state ^= system.random_state >> 12;
+            system.random_state ^= system.random_state << 25;
+            system.random_state ^= system.random_state >> 27;
+            uint64_t value{system.random_state * 0x2545F4914F6CDD1Dull};
+
+            return static_cast<float>(value >> 40) / static_cast<float>(1u << 24);
+        }
+
+        static float spread_particle_value(ParticleSystem &system, float value, float spread)
+        {
+            return value + (get_particle_random_number(system) * 2.0f - 1.0f) * spread;
+        }
+
+        static uint32_t pack_particle_color(const glm::vec4 &color)
+        {
+            auto to_byte = [](float value) {
+                return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+            };
+
+            return to_byte(color.x) | to_byte(color.y) << 8 | to_byte(color.z) << 16 | to_byte(color.w) << 24;
+        }
+
+        struct ParticleStepParameters
+        {
+            float dt;
+            float damping;
+            glm::vec3 gravity;
+            const ParticleAttractor *attractors;
+            size_t attractor_count;
+            float softening;
+        };
+
+        // Kernels return where they stopped; the scalar kernel finishes the rest.
+        static void step_particles_scalar(ParticleSystem &system, const ParticleStepParameters &parameters, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) {
+                float acceleration_x{parameters.gravity.x};
+                float acceleration_y{parameters.gravity.y};
+                float acceleration_z{parameters.gravity.z};
+                for (size_t j = 0; j < parameters.attractor_count; ++j) {
+                    const ParticleAttractor &attractor = parameters.attractors[j];
+                    float dx{attractor.position.x - system.positions_x[i]};
+                    float dy{attractor.position.y - system.positions_y[i]};
+                    float dz{attractor.position.z - system.positions_z[i]};
+                    float inverse_distance{1.0f / std::sqrt(dx * dx + dy * dy + dz * dz + parameters.softening)};
+                    float scale{attractor.strength * inverse_distance * inverse_distance * inverse_distance};
+                    acceleration_x += dx * scale;
+                    acceleration_y += dy * scale;
+                    acceleration_z += dz * scale;
+                }
+
+                system.velocities_x[i] = (system.velocities_x[i] + acceleration_x * parameters.dt) * parameters.damping;
+                system.velocities_y[i] = (system.velocities_y[i] + acceleration_y * parameters.dt) * parameters.damping;
+                system.velocities_z[i] = (system.velocities_z[i] + acceleration_z * parameters.dt) * parameters.damping;
+                system.positions_x[i] += system.velocities_x[i] * parameters.dt;
+                system.positions_y[i] += system.velocities_y[i] * parameters.dt;
+                system.positions_z[i] += system.velocities_z[i] * parameters.dt;
+                system.ages[i] += parameters.dt;
+            }
+        }
+
+#if defined(ASR_PIXEL_KERNELS_SSE2)
+        static size_t step_particles_sse2(ParticleSystem &system, const ParticleStepParameters &parameters, size_t begin, size_t end)
+        {
+            const __m128 dt = _mm_set1_ps(parameters.dt);
+            const __m128 damping = _mm_set1_ps(parameters.damping);
+            const __m128 softening = _mm_set1_ps(parameters.softening);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 three = _mm_set1_ps(3.0f);
+
+            size_t i{begin};
+            for (; i + 4 <= end; i += 4) {
+                __m128 position_x = _mm_loadu_ps(&system.positions_x[i]);
+                __m128 position_y = _mm_loadu_ps(&system.positions_y[i]);
+                __m128 position_z = _mm_loadu_ps(&system.positions_z[i]);
+                __m128 acceleration_x = _mm_set1_ps(parameters.gravity.x);
+                __m128 acceleration_y = _mm_set1_ps(parameters.gravity.y);
+                __m128 acceleration_z = _mm_set1_ps(parameters.gravity.z);
+                for (size_t j = 0; j < parameters.attractor_count; ++j) {
+                    const ParticleAttractor &attractor = parameters.attractors[j];
+                    __m128 dx = _mm_sub_ps(_mm_set1_ps(attractor.position.x), position_x);
+                    __m128 dy = _mm_sub_ps(_mm_set1_ps(attractor.position.y), position_y);
+                    __m128 dz = _mm_sub_ps(_mm_set1_ps(attractor.position.z), position_z);
+                    __m128 distance_squared = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                        _mm_add_ps(_mm_mul_ps(dz, dz), softening)
+                    );
+
+                    __m128 inverse_distance = _mm_rsqrt_ps(distance_squared);
+                    inverse_distance = _mm_mul_ps(
+                        _mm_mul_ps(half, inverse_distance),
+                        _mm_sub_ps(three, _mm_mul_ps(distance_squared, _mm_mul_ps(inverse_distance, inverse_distance)))
+                    );
+                    __m128 scale = _mm_mul_ps(
+                        _mm_set1_ps(attractor.strength),
+                        _mm_mul_ps(inverse_distance, _mm_mul_ps(inverse_distance, inverse_distance))
+                    );
+                    acceleration_x = _mm_add_ps(acceleration_x, _mm_mul_ps(dx, scale));
+                    acceleration_y = _mm_add_ps(acceleration_y, _mm_mul_ps(dy, scale));
+                    acceleration_z = _mm_add_ps(acceleration_z, _mm_mul_ps(dz, scale));
+                }
+
+                __m128 velocity_x = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&system.velocities_x[i]), _mm_mul_ps(acceleration_x, dt)), damping);
+                __m128 velocity_y = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&system.velocities_y[i]), _mm_mul_ps(acceleration_y, dt)), damping);
+                __m128 velocity_z = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&system.velocities_z[i]), _mm_mul_ps(acceleration_z, dt)), damping);
+                _mm_storeu_ps(&system.velocities_x[i], velocity_x);
+                _mm_storeu_ps(&system.velocities_y[i], velocity_y);
+                _mm_storeu_ps(&system.velocities_z[i], velocity_z);
+                _mm_storeu_ps(&system.positions_x[i], _mm_add_ps(position_x, _mm_mul_ps(velocity_x, dt)));
+                _mm_storeu_ps(&system.positions_y[i], _mm_add_ps(position_y, _mm_mul_ps(velocity_y, dt)));
+                _mm_storeu_ps(&system.positions_z[i], _mm_add_ps(position_z, _mm_mul_ps(velocity_z, dt)));
+                _mm_storeu_ps(&system.ages[i], _mm_add_ps(_mm_loadu_ps(&system.ages[i]), dt));
+            }
+
+            return i;
+        }
+#endif
+
+#ifdef ASR_PIXEL_KERNELS_AVX2
+        ASR_TARGET_AVX2 static size_t step_particles_avx2(ParticleSystem &system, const ParticleStepParameters &parameters, size_t begin, size_t end)
+        {
+            const __m256 dt = _mm256_set1_ps(parameters.dt);
+            const __m256 damping = _mm256_set1_ps(parameters.damping);
+            const __m256 softening = _mm256_set1_ps(parameters.softening);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 three = _mm256_set1_ps(3.0f);
+
+            size_t i{begin};
+            for (; i + 8 <= end; i += 8) {
+                __m256 position_x = _mm256_loadu_ps(&system.positions_x[i]);
+                __m256 position_y = _mm256_loadu_ps(&system.positions_y[i]);
+                __m256 position_z = _mm256_loadu_ps(&system.positions_z[i]);
+                __m256 acceleration_x = _mm256_set1_ps(parameters.gravity.x);
+                __m256 acceleration_y = _mm256_set1_ps(parameters.gravity.y);
+                __m256 acceleration_z = _mm256_set1_ps(parameters.gravity.z);
+                for (size_t j = 0; j < parameters.attractor_count; ++j) {
+                    const ParticleAttractor &attractor = parameters.attractors[j];
+                    __m256 dx = _mm256_sub_ps(_mm256_set1_ps(attractor.position.x), position_x);
+                    __m256 dy = _mm256_sub_ps(_mm256_set1_ps(attractor.position.y), position_y);
+                    __m256 dz = _mm256_sub_ps(_mm256_set1_ps(attractor.position.z), position_z);
+                    __m256 distance_squared = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                        _mm256_add_ps(_mm256_mul_ps(dz, dz), softening)
+                    );
+
+                    __m256 inverse_distance = _mm256_rsqrt_ps(distance_squared);
+                    inverse_distance = _mm256_mul_ps(
+                        _mm256_mul_ps(half, inverse_distance),
+                        _mm256_sub_ps(three, _mm256_mul_ps(distance_squared, _mm256_mul_ps(inverse_distance, inverse_distance)))
+                    );
+                    __m256 scale = _mm256_mul_ps(
+                        _mm256_set1_ps(attractor.strength),
+                        _mm256_mul_ps(inverse_distance, _mm256_mul_ps(inverse_distance, inverse_distance))
+                    );
+                    acceleration_x = _mm256_add_ps(acceleration_x, _mm256_mul_ps(dx, scale));
+                    acceleration_y = _mm256_add_ps(acceleration_y, _mm256_mul_ps(dy, scale));
+                    acceleration_z = _mm256_add_ps(acceleration_z, _mm256_mul_ps(dz, scale));
+                }
+
+                __m256 velocity_x = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&system.velocities_x[i]), _mm256_mul_ps(acceleration_x, dt)), damping);
+                __m256 velocity_y = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&system.velocities_y[i]), _mm256_mul_ps(acceleration_y, dt)), damping);
+                __m256 velocity_z = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&system.velocities_z[i]), _mm256_mul_ps(acceleration_z, dt)), damping);
+                _mm256_storeu_ps(&system.velocities_x[i], velocity_x);
+                _mm256_storeu_ps(&system.velocities_y[i], velocity_y);
+                _mm256_storeu_ps(&system.velocities_z[i], velocity_z);
+                _mm256_storeu_ps(&system.positions_x[i], _mm256_add_ps(position_x, _mm256_mul_ps(velocity_x, dt)));
+                _mm256_storeu_ps(&system.positions_y[i], _mm256_add_ps(position_y, _mm256_mul_ps(velocity_y, dt)));
+                _mm256_storeu_ps(&system.positions_z[i], _mm256_add_ps(position_z, _mm256_mul_ps(velocity_z, dt)));
+                _mm256_storeu_ps(&system.ages[i], _mm256_add_ps(_mm256_loadu_ps(&system.ages[i]), dt));
+            }
+
+            return i;
+        }
+#endif
+
+#ifdef ASR_PIXEL_KERNELS_NEON
+        static size_t step_particles_neon(ParticleSystem &system, const ParticleStepParameters &parameters, size_t begin, size_t end)
+        {
+            const float32x4_t dt = vdupq_n_f32(parameters.dt);
+            const float32x4_t damping = vdupq_n_f32(parameters.damping);
+            const float32x4_t softening = vdupq_n_f32(parameters.softening);
+
+            size_t i{begin};
+            for (; i + 4 <= end; i += 4) {
+                float32x4_t position_x = vld1q_f32(&system.positions_x[i]);
+                float32x4_t position_y = vld1q_f32(&system.positions_y[i]);
+                float32x4_t position_z = vld1q_f32(&system.positions_z[i]);
+                float32x4_t acceleration_x = vdupq_n_f32(parameters.gravity.x);
+                float32x4_t acceleration_y = vdupq_n_f32(parameters.gravity.y);
+                float32x4_t acceleration_z = vdupq_n_f32(parameters.gravity.z);
+                for (size_t j = 0; j < parameters.attractor_count; ++j) {
+                    const ParticleAttractor &attractor = parameters.attractors[j];
+                    float32x4_t dx = vsubq_f32(vdupq_n_f32(attractor.position.x), position_x);
+                    float32x4_t dy = vsubq_f32(vdupq_n_f32(attractor.position.y), position_y);
+                    float32x4_t dz = vsubq_f32(vdupq_n_f32(attractor.position.z), position_z);
+                    float32x4_t distance_squared = vaddq_f32(
+                        vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)),
+                        vaddq_f32(vmulq_f32(dz, dz), softening)
+                    );
+
+                    float32x4_t inverse_distance = vrsqrteq_f32(distance_squared);
+                    inverse_distance = vmulq_f32(
+                        inverse_distance,
+                        vrsqrtsq_f32(vmulq_f32(distance_squared, inverse_distance), inverse_distance)
+                    );
+                    float32x4_t scale = vmulq_f32(
+                        vdupq_n_f32(attractor.strength),
+                        vmulq_f32(inverse_distance, vmulq_f32(inverse_distance, inverse_distance))
+                    );
+                    acceleration_x = vaddq_f32(acceleration_x, vmulq_f32(dx, scale));
+                    acceleration_y = vaddq_f32(acceleration_y, vmulq_f32(dy, scale));
+                    acceleration_z = vaddq_f32(acceleration_z, vmulq_f32(dz, scale));
+                }
+
+                float32x4_t velocity_x = vmulq_f32(vaddq_f32(vld1q_f32(&system.velocities_x[i]), vmulq_f32(acceleration_x, dt)), damping);
+                float32x4_t velocity_y = vmulq_f32(vaddq_f32(vld1q_f32(&system.velocities_y[i]), vmulq_f32(acceleration_y, dt)), damping);
+                float32x4_t velocity_z = vmulq_f32(vaddq_f32(vld1q_f32(&system.velocities_z[i]), vmulq_f32(acceleration_z, dt)), damping);
+                vst1q_f32(&system.velocities_x[i], velocity_x);
+                vst1q_f32(&system.velocities_y[i], velocity_y);
+                vst1q_f32(&system.velocities_z[i], velocity_z);
+                vst1q_f32(&system.positions_x[i], vaddq_f32(position_x, vmulq_f32(velocity_x, dt)));
+                vst1q_f32(&system.positions_y[i], vaddq_f32(position_y, vmulq_f32(velocity_y, dt)));
+                vst1q_f32(&system.positions_z[i], vaddq_f32(position_z, vmulq_f32(velocity_z, dt)));
+                vst1q_f32(&system.ages[i], vaddq_f32(vld1q_f32(&system.ages[i]), dt));
+            }
+
+            return i;
+        }
+#endif
+
+        static void step_particles(ParticleSystem &system, const ParticleStepParameters &parameters, size_t begin, size_t end)
+        {
+#ifdef ASR_PIXEL_KERNELS_AVX2
+            if (is_avx2_supported()) begin = step_particles_avx2(system, parameters, begin, end);
+#endif
+#if defined(ASR_PIXEL_KERNELS_SSE2)
+            begin = step_particles_sse2(system, parameters, begin, end);
+#elif defined(ASR_PIXEL_KERNELS_NEON)
+            begin = step_particles_neon(system, parameters, begin, end);
+#endif
+            step_particles_scalar(system, parameters, begin, end);
+        }
+
+        static void write_particle_vertices(const ParticleSystem &system, ParticleVertex *vertices, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) {
+                ParticleVertex &vertex = vertices[i];
+                vertex.x = system.positions_x[i];
+                vertex.y = system.positions_y[i];
+                vertex.z = system.positions_z[i];
+                vertex.size = system.sizes[i];
+                vertex.age = system.ages[i] / system.lifetimes[i];
+                std::memcpy(&vertex.r, &system.colors[i], sizeof(uint32_t));
+            }
+        }
+
+        static void run_particle_chunks(const ParticleSystem &system, const std::function<void(size_t, size_t)> &function)
+        {
+            if (!system.parallel || system.count < parallel_particle_threshold) {
+                function(0, system.count);
+                return;
+            }
+
+            parallel_for(0, system.count, function, particle_chunk_size);
+        }
+
+        static void move_particle(ParticleSystem &system, size_t from, size_t to)
+        {
+            system.positions_x[to] = system.positions_x[from];
+            system.positions_y[to] = system.positions_y[from];
+            system.positions_z[to] = system.positions_z[from];
+            system.velocities_x[to] = system.velocities_x[from];
+            system.velocities_y[to] = system.velocities_y[from];
+            system.velocities_z[to] = system.velocities_z[from];
+            system.ages[to] = system.ages[from];
+            system.lifetimes[to] = system.lifetimes[from];
+            system.sizes[to] = system.sizes[from];
+            system.colors[to] = system.colors[from];
+        }
+
+        /*
+         * Resource Loader Thread
+         */
+
+        static void run_resource_loader()
+        {
+            SDL_GL_MakeCurrent(data::window, data::resource_loader_gl_context);
+#ifdef ASR_ENABLE_TRACING
+            get_thread_trace_buffer()->thread_name = "resource loader";
+#endif
+
+            for (;;) {
+                ResourceUploadJob job;
+                {
+                    std::unique_lock<std::mutex> lock{data::resource_loader_mutex};
+                    data::resource_loader_condition.wait(lock, [] {
+                        return data::resource_loader_should_stop || !data::pending_resource_uploads.empty();
+                    });
+                    if (data::resource_loader_should_stop) break;
+
+                    job = std::move(data::pending_resource_uploads.front());
+                    data::pending_resource_uploads.pop_front();
+                }
+
+                job.upload();
+                job.upload = nullptr;
+
+                data::background_uploaded_bytes += data::current_frame_statistics.uploaded_bytes;
+                data::current_frame_statistics = FrameStatistics{};
+
+                // Contexts without sync objects finish the upload here, which still keeps the stall off the render thread.
+                if (GLEW_ARB_sync) {
+                    job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                    glFlush();
+                } else {
+                    glFinish();
+                }
+
+                std::lock_guard<std::mutex> lock{data::resource_loader_mutex};
+                data::finished_resource_uploads.push_back(std::move(job));
+            }
+
+            SDL_GL_MakeCurrent(data::window, nullptr);
+        }
+
+        static void start_resource_loader()
+        {
+            if (data::resource_loader_thread.joinable()) return;
+
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+            data::resource_loader_gl_context = SDL_GL_CreateContext(data::window);
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+            if (data::resource_loader_gl_context == nullptr) {
+                std::cerr << "Failed to create a shared OpenGL context for the resource loader: "
+                          << SDL_GetError() << std::endl;
+                std::exit(-1);
+            }
+            SDL_GL_MakeCurrent(data::window, data::gl_context);
+
+            data::resource_loader_should_stop = false;
+            data::resource_loader_thread = std::thread{run_resource_loader};
+        }
+
+        static void enqueue_resource_upload(ResourceUploadJob job)
+        {
+            start_resource_loader();
+
+            {
+                std::lock_guard<std::mutex> lock{data::resource_loader_mutex};
+                data::pending_resource_uploads.push_back(std::move(job));
+            }
+            data::resource_loader_condition.notify_one();
+        }
+
+        static void stop_resource_loader()
+        {
+            if (!data::resource_loader_thread.joinable()) return;
+
+            {
+                std::lock_guard<std::mutex> lock{data::resource_loader_mutex};
+                data::resource_loader_should_stop = true;
+            }
+            data::resource_loader_condition.notify_all();
+            data::resource_loader_thread.join();
+
+            SDL_GL_DeleteContext(data::resource_loader_gl_context);
+            data::resource_loader_gl_context = nullptr;
+
+            for (auto *jobs : {&data::finished_resource_uploads, &data::fenced_resource_uploads}) {
+                for (auto &job : *jobs) {
+                    if (job.fence != nullptr) glDeleteSync(job.fence);
+                }
+                jobs->clear();
+            }
+            data::pending_resource_uploads.clear();
+        }
+
+        /*
+         * Asynchronous Loading
+         */
+
+        static bool try_read_text_file(const std::string &path, std::string &text, std::string &error)
+        {
+            std::ifstream file_stream{path};
+            if (!file_stream.is_open()) {
+                error = "Failed to open the file: '" + path + "'";
+                return false;
+            }
+
+            std::stringstream string_stream;
+            string_stream << file_stream.rdbuf();
+            text = string_stream.str();
+
+            return true;
+        }
+
+        static bool try_read_image_file(const std::string &path, unsigned int conversions, Image &image, std::string &error)
+        {
+            int image_width, image_height;
+            int bytes_per_pixel;
+
+            auto image_data = static_cast<uint8_t *>(stbi_load(path.c_str(), &image_width, &image_height, &bytes_per_pixel, 0));
+            if (!image_data) {
+                error = "Failed to open the file: '" + path + "'";
+                return false;
+            }
+            if (bytes_per_pixel < 1 || bytes_per_pixel > 4) {
+                stbi_image_free(image_data);
+                error = "Invalid image file format (only 1 to 4 channels are supported): '" + path + "'";
+                return false;
+            }
+
+            auto width = static_cast<unsigned int>(image_width);
+            auto height = static_cast<unsigned int>(image_height);
+            auto channels = static_cast<unsigned int>(bytes_per_pixel);
+            unsigned int converted_channels{get_converted_channel_count(channels, conversions)};
+
+            PixelData result;
+            resize_uninitialized(result, static_cast<size_t>(width) * height * converted_channels);
+            convert_pixels(image_data, result.data(), width, height, channels, conversions);
+            stbi_image_free(image_data);
+
+            image = Image{
+                std::move(result),
+                width,
+                height,
+                converted_channels,
+                (conversions & SwizzleToBGRA) != 0 && converted_channels >= 3
+            };
+
+            return true;
+        }
+
+        // Orders the pending heap: higher priorities first, then requests in the order they were made.
+        static bool is_async_load_later(const AsyncLoadJob &a, const AsyncLoadJob &b)
+        {
+            return a.priority != b.priority ? a.priority < b.priority : a.sequence > b.sequence;
+        }
+
+        // Every request schedules one job, which takes whichever pending request should go first.
+        static void run_async_loader()
+        {
+            AsyncLoadJob job;
+            {
+                std::lock_guard<std::mutex> lock{data::async_load_mutex};
+                if (data::async_loaders_should_stop || data::pending_async_loads.empty()) return;
+
+                std::pop_heap(data::pending_async_loads.begin(), data::pending_async_loads.end(), is_async_load_later);
+                job = std::move(data::pending_async_loads.back());
+                data::pending_async_loads.pop_back();
+            }
+
+            if (!job.is_cancelled()) {
+                ASR_TRACE_SCOPE("async_load");
+                job.load();
+            }
+            job.load = nullptr;
+
+            std::lock_guard<std::mutex> lock{data::async_load_mutex};
+            data::completed_async_loads.push_back(std::move(job));
+        }
+
+        static void enqueue_async_load(AsyncLoadJob job)
+        {
+            {
+                std::lock_guard<std::mutex> lock{data::async_load_mutex};
+                job.sequence = data::async_load_sequence++;
+                data::pending_async_loads.push_back(std::move(job));
+                std::push_heap(data::pending_async_loads.begin(), data::pending_async_loads.end(), is_async_load_later);
+            }
+            schedule_job(run_async_loader, {}, &data::async_load_jobs, true);
+        }
+
+        static void stop_async_loaders()
+        {
+            data::async_loaders_should_stop = true;
+            wait_for_job_group(data::async_load_jobs);
+            data::async_loaders_should_stop = false;
+
+            std::lock_guard<std::mutex> lock{data::async_load_mutex};
+            data::pending_async_loads.clear();
+            data::completed_async_loads.clear();
+        }
+
+        static void deliver_completed_loads()
+        {
+            {
+                std::lock_guard<std::mutex> lock{data::async_load_mutex};
+                if (data::completed_async_loads.empty()) return;
+            }
+
+            for (;;) {
+                AsyncLoadJob job;
+                {
+                    std::lock_guard<std::mutex> lock{data::async_load_mutex};
+                    if (data::completed_async_loads.empty()) break;
+
+                    job = std::move(data::completed_async_loads.front());
+                    data::completed_async_loads.pop_front();
+                }
+                job.complete();
+            }
+        }
+
+        static const Texture &get_placeholder_texture()
+        {
+            if (data::placeholder_texture.texture_object == 0) {
+                static const uint8_t pixels[] = {
+                    96, 96, 96, 255,   160, 160, 160, 255,
+                    160, 160, 160, 255,   96, 96, 96, 255
+                };
+
+                Texture &texture = data::placeholder_texture;
+                texture.width = 2;
+                texture.height = 2;
+                texture.channels = 4;
+                texture.wrap_mode_u = Repeat;
+                texture.wrap_mode_v = Repeat;
+                texture.minification_filter = Nearest;
+                texture.magnification_filter = Nearest;
+
+                glGenTextures(1, &texture.texture_object);
+                bind_texture(GL_TEXTURE_2D, texture.texture_object);
+                apply_texture_parameters(texture);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+                bind_texture(GL_TEXTURE_2D, 0);
+
+                texture.memory_size = calculate_texture_memory_size(2, 2, 4, false);
+                account_memory(Textures, texture.memory_owner, static_cast<int64_t>(texture.memory_size));
+            }
+
+            return data::placeholder_texture;
+        }
+
+        static void destroy_placeholder_texture()
+        {
+            Texture &texture = data::placeholder_texture;
+            if (texture.texture_object == 0) return;
+
+            for (auto &current_texture : data::current_textures) {
+                if (current_texture == &texture) current_texture = nullptr;
+            }
+            if (data::current_texture == &texture) data::current_texture = nullptr;
+
+            forget_deleted_texture(texture.texture_object);
+            glDeleteTextures(1, &texture.texture_object);
+            texture.texture_object = 0;
+
+            account_memory(Textures, texture.memory_owner, -static_cast<int64_t>(texture.memory_size));
+            texture.memory_size = 0;
+        }
+    }
+
+    /*
+     * Tracing
+     */
+
+    static void set_trace_thread_name([[maybe_unused]] const std::string &name)
+    {
+#ifdef ASR_ENABLE_TRACING
+        TraceBuffer *buffer = utilities::get_thread_trace_buffer();
+
+        std::lock_guard<std::mutex> lock{data::trace_buffers_mutex};
+        buffer->thread_name = name;
+#endif
+    }
+
+    static void clear_trace_events()
+    {
+#ifdef ASR_ENABLE_TRACING
+        std::lock_guard<std::mutex> lock{data::trace_buffers_mutex};
+        for (auto &buffer : data::trace_buffers) {
+            buffer->count = 0;
+            buffer->dropped_count = 0;
+        }
+        data::gpu_trace_buffer.count = 0;
+        data::gpu_trace_buffer.dropped_count = 0;
+#endif
+    }
+
+    static bool write_trace_file([[maybe_unused]] const std::string &path)
+    {
+#ifdef ASR_ENABLE_TRACING
+        std::ofstream file_stream{path};
+        if (!file_stream.is_open()) {
+            std::cerr << "Failed to open the file: '" << path << "'" << std::endl;
+            return false;
+        }
+
+        file_stream << R"({"displayTimeUnit":"ms","traceEvents":[)" << std::endl;
+
+        bool first_event{true};
+        data::gpu_trace_buffer.thread_name = "GPU";
+        utilities::write_trace_buffer(file_stream, data::gpu_trace_buffer, first_event);
+
+        size_t dropped_count{data::gpu_trace_buffer.dropped_count};
+        {
+            std::lock_guard<std::mutex> lock{data::trace_buffers_mutex};
+            for (const auto &buffer : data::trace_buffers) {
+                utilities::write_trace_buffer(file_stream, *buffer, first_event);
+                dropped_count += buffer->dropped_count;
+            }
+        }
+
+        file_stream << std::endl << "]}" << std::endl;
+
+        if (dropped_count > 0) {
+            std::cerr << "Trace buffers overflowed, " << dropped_count << " events were dropped" << std::endl;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*
+     * Job System
+     *
+     * Jobs run on a pool of worker threads, one per core besides the one the application runs on. A job
+     * starts once all of its dependencies have finished. Jobs added to the frame group are waited for at
+     * the start of finish_frame_rendering(), so work for a frame can be fired and forgotten. File reads and
+     * other long loads go on the background queue instead, which waits on the application's thread never take from.
+     */
+
+    static JobHandle schedule_job(
+                         std::function<void()> function,
+                         const std::vector<JobHandle> &dependencies = {},
+                         JobGroup *group = nullptr
+                     )
+    {
+        assert(function);
+
+        return utilities::schedule_job(std::move(function), dependencies, group);
+    }
+
+    // For jobs that may block or run for several frames. Only idle workers run them.
+    static JobHandle schedule_background_job(
+                         std::function<void()> function,
+                         const std::vector<JobHandle> &dependencies = {},
+                         JobGroup *group = nullptr
+                     )
+    {
+        assert(function);
+
+        return utilities::schedule_job(std::move(function), dependencies, group, true);
+    }
+
+    static bool is_job_finished(const JobHandle &job)
+    {
+        return job->finished;
+    }
+
+    static void wait_for_job(const JobHandle &job)
+    {
+        utilities::wait_for_job(job);
+    }
+
+    static void wait_for_job_group(JobGroup &group)
+    {
+        utilities::wait_for_job_group(group);
+    }
+
+    static JobGroup &get_frame_job_group()
+    {
+        return data::frame_job_group;
+    }
+
+    static void parallel_for(
+                    size_t begin, size_t end,
+                    const std::function<void(size_t, size_t)> &function,
+                    size_t grain_size = 0
+                )
+    {
+        utilities::parallel_for(begin, end, function, grain_size);
+    }
+
+    static size_t get_job_worker_count()
+    {
+        return utilities::get_job_worker_count();
+    }
+
+    // Programs that schedule jobs without a window call it before they return.
+    static void stop_job_system()
+    {
+        utilities::stop_job_system();
+    }
+
+    /*
+     * Window Handling
+     */
+
+    static void create_window(unsigned int width, unsigned int height)
+    {
+        SDL_Init(SDL_INIT_VIDEO);
+
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+        SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
+        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 2);
+
+        data::window_width = width;
+        data::window_height = height;
+
+        unsigned int flags{SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI};
+        if (data::window_width == data::fullscreen || data::window_height == data::fullscreen) {
+            flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+        }
+        data::window =
+            SDL_CreateWindow(
+                "ASR: Version 3.0",
+                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                static_cast<int>(data::window_width),
+                static_cast<int>(data::window_height),
+                flags
+            );
+        SDL_GL_GetDrawableSize(
+            data::window,
+            reinterpret_cast<int *>(&data::window_width),
+            reinterpret_cast<int *>(&data::window_height)
+        );
+
+        data::gl_context = SDL_GL_CreateContext(data::window);
+        SDL_GL_MakeCurrent(data::window, data::gl_context);
+
+        if (glewInit() != GLEW_OK) {
             std::cerr << "Failed to initialize the OpenGL loader." << std::endl;
             std::exit(-1);
         }
 
-        if (SDL_GL_SetSwapInterval(-1) < 0) {
-            SDL_GL_SetSwapInterval(1);
+        if (SDL_GL_SetSwapInterval(-1) < 0) {
+            SDL_GL_SetSwapInterval(1);
+        }
+
+        utilities::create_uniform_buffers();
+
+        set_trace_thread_name("render");
+
+        data::key_down_event_handler = [&](int key) { if (key == SDLK_ESCAPE) { std::exit(0); }};
+        data::keys_down_event_handler = [&](const uint8_t *keys) { };
+    }
+
+    static void create_window()
+    {
+        create_window(data::fullscreen, data::fullscreen);
+    }
+
+    static void set_key_down_event_handler(std::function<void(int)> event_handler)
+    {
+        data::key_down_event_handler = std::move(event_handler);
+    }
+
+    static void set_keys_down_event_handler(std::function<void(const uint8_t *)> event_handler)
+    {
+        data::keys_down_event_handler = std::move(event_handler);
+    }
+
+    static void process_window_events(bool *should_stop)
+    {
+        ASR_TRACE_SCOPE("process_window_events");
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                *should_stop = true;
+            } else if (event.type == SDL_KEYDOWN) {
+                data::key_down_event_handler(event.key.keysym.sym);
+            }
+            data::keys_down_event_handler(SDL_GetKeyboardState(nullptr));
+
+            data::mouse_state = SDL_GetMouseState(&data::mouse_x, &data::mouse_y);
+        }
+    }
+
+    static void destroy_window()
+    {
+        utilities::wait_for_job_group(data::frame_job_group);
+        utilities::stop_async_loaders();
+        utilities::stop_job_system();
+        utilities::stop_resource_loader();
+        utilities::stop_texture_stream_copier();
+        utilities::destroy_placeholder_texture();
+        utilities::destroy_transparency_targets();
+        utilities::destroy_uniform_buffers();
+
+        SDL_GL_DeleteContext(data::gl_context);
+
+        SDL_DestroyWindow(data::window);
+        data::window = nullptr;
+
+        SDL_Quit();
+    }
+
+    /*
+     * Shader Handling
+     */
+
+    static ShaderProgram generate_shader_program(const char *vertex_shader_source, const char *fragment_shader_source)
+    {
+        ShaderProgram program;
+        GLint status;
+
+        GLuint vertex_shader_object = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex_shader_object, 1, static_cast<const GLchar **>(&vertex_shader_source), nullptr);
+        glCompileShader(vertex_shader_object);
+        glGetShaderiv(vertex_shader_object, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE) {
+            GLint info_log_length;
+            glGetShaderiv(vertex_shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
+            if (info_log_length > 0) {
+                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+
+                glGetShaderInfoLog(vertex_shader_object, info_log_length, nullptr, info_log);
+                std::cerr << "Failed to compile a vertex shader" << std::endl
+                          << "Compilation log:\n" << info_log << std::endl << std::endl;
+
+                delete[] info_log;
+            }
+        }
+
+        GLuint fragment_shader_object = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment_shader_object, 1, static_cast<const GLchar **>(&fragment_shader_source), nullptr);
+        glCompileShader(fragment_shader_object);
+        glGetShaderiv(fragment_shader_object, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE) {
+            GLint info_log_length;
+            glGetShaderiv(fragment_shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
+            if (info_log_length > 0) {
+                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+
+                glGetShaderInfoLog(fragment_shader_object, info_log_length, nullptr, info_log);
+                std::cerr << "Failed to compile a fragment shader" << std::endl
+                          << "Compilation log:\n" << info_log << std::endl;
+
+                delete[] info_log;
+            }
+        }
+
+        program.program_object = glCreateProgram();
+        glAttachShader(program.program_object, vertex_shader_object);
+        glAttachShader(program.program_object, fragment_shader_object);
+        glBindAttribLocation(program.program_object, position_attribute_location, "position");
+        glBindAttribLocation(program.program_object, color_attribute_location, "color");
+        glBindAttribLocation(program.program_object, texture_coordinates_attribute_location, "texture_coordinates");
+        glLinkProgram(program.program_object);
+        glGetProgramiv(program.program_object, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE) {
+            GLint info_log_length;
+            glGetProgramiv(program.program_object, GL_INFO_LOG_LENGTH, &info_log_length);
+            if (info_log_length > 0) {
+                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+
+                glGetProgramInfoLog(program.program_object, info_log_length, nullptr, info_log);
+                std::cerr << "Failed to link a shader program" << std::endl
+                          << "Linker log:\n" << info_log << std::endl;
+
+                delete[] info_log;
+            }
+        }
+
+        glDetachShader(program.program_object, vertex_shader_object);
+        glDetachShader(program.program_object, fragment_shader_object);
+        glDeleteShader(vertex_shader_object);
+        glDeleteShader(fragment_shader_object);
+
+        for (unsigned int i = 0; i < builtin_uniform_count; ++i) {
+            GLint location{glGetUniformLocation(program.program_object, builtin_uniform_names[i])};
+            if (location != -1) {
+                program.builtin_uniforms[program.active_builtin_uniform_count++] = BuiltinUniformBinding{static_cast<BuiltinUniform>(i), location};
+            }
+        }
+
+        if (data::uniform_buffers_supported) {
+            GLuint frame_block_index{glGetUniformBlockIndex(program.program_object, "FrameUniforms")};
+            if (frame_block_index != GL_INVALID_INDEX) {
+                glUniformBlockBinding(program.program_object, frame_block_index, frame_uniform_block_binding);
+                program.uses_frame_uniform_block = true;
+            }
+
+            GLuint view_block_index{glGetUniformBlockIndex(program.program_object, "ViewUniforms")};
+            if (view_block_index != GL_INVALID_INDEX) {
+                glUniformBlockBinding(program.program_object, view_block_index, view_uniform_block_binding);
+                program.uses_view_uniform_block = true;
+            }
+        }
+
+        return program;
+    }
+
+    static void set_shader_program_current(ShaderProgram *program)
+    {
+        data::current_shader_variants = nullptr;
+        data::current_shader_program = program != nullptr ? program : &data::shader_program;
+    }
+
+    static void create_shader_program(const char *vertex_shader_source, const char *fragment_shader_source)
+    {
+        data::shader_program = generate_shader_program(vertex_shader_source, fragment_shader_source);
+        data::current_shader_variants = nullptr;
+        data::current_shader_program = &data::shader_program;
+    }
+
+    static ShaderVariants generate_shader_variants(const char *vertex_shader_source, const char *fragment_shader_source)
+    {
+        ShaderVariants variants;
+        variants.vertex_shader_source = vertex_shader_source;
+        variants.fragment_shader_source = fragment_shader_source;
+
+        return variants;
+    }
+
+    static ShaderProgram &get_shader_variant(ShaderVariants &variants)
+    {
+        uint32_t key{utilities::get_shader_variant_key()};
+        if (key == variants.last_key) return *variants.last_program;
+
+        auto variant = variants.programs.find(key);
+        if (variant == variants.programs.end()) {
+            std::string vertex_shader_source{utilities::insert_shader_variant_defines(variants.vertex_shader_source, key)};
+            std::string fragment_shader_source{utilities::insert_shader_variant_defines(variants.fragment_shader_source, key)};
+            variant = variants.programs.emplace(
+                key, generate_shader_program(vertex_shader_source.c_str(), fragment_shader_source.c_str())
+            ).first;
+        }
+        variants.last_key = key;
+        variants.last_program = &variant->second;
+
+        return variant->second;
+    }
+
+    static void set_shader_variants_current(ShaderVariants *variants)
+    {
+        data::current_shader_variants = variants;
+        if (variants == nullptr) {
+            data::current_shader_program = &data::shader_program;
+        }
+    }
+
+    static void destroy_shader_variants(ShaderVariants &variants)
+    {
+        for (auto &[key, program] : variants.programs) {
+            if (data::current_shader_program == &program) {
+                data::current_shader_program = &data::shader_program;
+            }
+            utilities::forget_deleted_program(program.program_object);
+            glDeleteProgram(program.program_object);
+        }
+        variants.programs.clear();
+        variants.last_key = no_shader_variant;
+        variants.last_program = nullptr;
+
+        if (data::current_shader_variants == &variants) {
+            data::current_shader_variants = nullptr;
+        }
+    }
+
+    // Programs that are linked again, shader variants included, need an interface of their own.
+    template<typename Interface>
+    static ShaderInterface<Interface> generate_shader_interface(const ShaderProgram &program)
+    {
+        ShaderInterface<Interface> interface;
+        interface.program_object = program.program_object;
+        utilities::bind_shader_interface_uniforms(
+            interface, std::make_index_sequence<ShaderInterface<Interface>::uniform_count>{}
+        );
+
+        return interface;
+    }
+
+    template<typename Interface>
+    static void set_shader_interface_uniforms(const ShaderInterface<Interface> &interface, const Interface &values)
+    {
+        utilities::use_program(interface.program_object);
+        for (size_t i = 0; i < interface.active_uniform_count; ++i) {
+            interface.uniforms[i].upload(interface.uniforms[i].location, values);
+        }
+    }
+
+    static void enable_vertex_colors()
+    {
+        data::vertex_colors_enabled = true;
+    }
+
+    static void disable_vertex_colors()
+    {
+        data::vertex_colors_enabled = false;
+    }
+
+    static void destroy_shader_program(ShaderProgram &program)
+    {
+        utilities::forget_deleted_program(program.program_object);
+        glDeleteProgram(program.program_object);
+        program = ShaderProgram{};
+
+        if (data::current_shader_program == &program) {
+            data::current_shader_program = &data::shader_program;
+        }
+    }
+
+    static void destroy_shader_program()
+    {
+        destroy_shader_program(*data::current_shader_program);
+    }
+
+    static bool is_uniform_block_supported()
+    {
+        return data::uniform_buffers_supported;
+    }
+
+    /*
+     * Geometry Handling
+     */
+
+    static Geometry generate_geometry(
+                        GeometryType type,
+                        const Vertex *vertices, size_t vertex_count,
+                        const unsigned int *indices, size_t index_count
+                    )
+    {
+        Geometry geometry{};
+
+        geometry.vertex_count = static_cast<unsigned int>(index_count);
+        geometry.type = type;
+        geometry.memory_owner = utilities::get_current_memory_owner();
+
+        utilities::upload_geometry_buffers(geometry, vertices, vertex_count, indices, index_count);
+        utilities::configure_vertex_array(geometry);
+
+        return geometry;
+    }
+
+    static Geometry generate_geometry(GeometryType type, std::vector<Vertex> vertices, std::vector<unsigned int> indices)
+    {
+        return generate_geometry(type, vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+
+    // The geometry renders as its first view; the others are drawn with render_current_geometry_view().
+    static Geometry generate_geometry(const std::vector<Vertex> &vertices, const std::vector<GeometryViewData> &views)
+    {
+        assert(!views.empty());
+
+        size_t index_count{0};
+        for (const auto &[type, view_indices] : views) index_count += view_indices.size();
+
+        std::vector<unsigned int> indices;
+        indices.reserve(index_count);
+        std::vector<GeometryView> geometry_views;
+        geometry_views.reserve(views.size());
+        for (const auto &[type, view_indices] : views) {
+            geometry_views.push_back(GeometryView{
+                type, static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(view_indices.size())
+            });
+            indices.insert(indices.end(), view_indices.begin(), view_indices.end());
+        }
+
+        Geometry geometry{generate_geometry(views.front().first, vertices.data(), vertices.size(), indices.data(), indices.size())};
+        geometry.vertex_count = geometry_views.front().index_count;
+        geometry.views = std::move(geometry_views);
+
+        return geometry;
+    }
+
+    static bool is_primitive_restart_supported()
+    {
+        return GLEW_VERSION_3_1 || GLEW_ARB_ES3_compatibility;
+    }
+
+    // The triangles must be wound consistently.
+    static std::vector<unsigned int> convert_triangles_to_strips(const std::vector<unsigned int> &triangle_indices, bool use_primitive_restart)
+    {
+        return utilities::stripify_triangles(triangle_indices.data(), triangle_indices.size(), use_primitive_restart);
+    }
+
+    // Meshes that strip badly stay a Triangles list, so check the type of the result.
+    static Geometry generate_strip_geometry(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &triangle_indices)
+    {
+        std::vector<unsigned int> strip_indices{convert_triangles_to_strips(triangle_indices, is_primitive_restart_supported())};
+        if (strip_indices.size() >= triangle_indices.size()) {
+            return generate_geometry(Triangles, vertices.data(), vertices.size(), triangle_indices.data(), triangle_indices.size());
+        }
+
+        return generate_geometry(TriangleStrip, vertices.data(), vertices.size(), strip_indices.data(), strip_indices.size());
+    }
+
+    static void set_geometry_current(Geometry *geometry)
+    {
+        data::current_geometry = geometry;
+        if (geometry != nullptr) {
+            utilities::bind_vertex_array(static_cast<GLuint>(geometry->vertex_array_object));
+        } else {
+            utilities::bind_vertex_array(0);
+        }
+    }
+
+    static void destroy_geometry(Geometry &geometry)
+    {
+        GLuint vertex_array_object{static_cast<GLuint>(geometry.vertex_array_object)};
+        GLuint vertex_buffer_object{static_cast<GLuint>(geometry.vertex_buffer_object)};
+        GLuint index_buffer_object{static_cast<GLuint>(geometry.index_buffer_object)};
+
+        utilities::bind_vertex_array(0);
+#ifdef __APPLE__
+        glDeleteVertexArraysAPPLE(1, &vertex_array_object);
+#else
+        glDeleteVertexArrays(1, &vertex_array_object);
+#endif
+        geometry.vertex_array_object = 0;
+
+        utilities::forget_deleted_buffer(vertex_buffer_object);
+        glDeleteBuffers(1, &vertex_buffer_object);
+        geometry.vertex_buffer_object = 0;
+
+        glDeleteBuffers(1, &index_buffer_object);
+        geometry.index_buffer_object = 0;
+
+        utilities::account_memory(
+            Buffers, geometry.memory_owner,
+            -static_cast<int64_t>(geometry.vertex_buffer_size + geometry.index_buffer_size)
+        );
+        geometry.vertex_buffer_size = 0;
+        geometry.index_buffer_size = 0;
+        geometry.views.clear();
+    }
+
+    /*
+     * Shape Generation
+     */
+
+    // The results may overwrite the angles.
+    static void compute_sines_and_cosines(const float *angles, float *sines, float *cosines, size_t count)
+    {
+        utilities::compute_sines_and_cosines(angles, sines, cosines, count);
+    }
+
+    static GeometryData generate_circle_geometry_data(float radius, unsigned int segment_count, GeometryType type = Triangles)
+    {
+        assert(segment_count >= 3);
+        assert(type == Triangles || type == Lines || type == Points);
+
+        utilities::TrigonometryTable rim = utilities::make_trigonometry_table(
+            segment_count + 1, 0.0f, two_pi / static_cast<float>(segment_count)
+        );
+
+        GeometryData geometry_data;
+        auto &[vertices, indices] = geometry_data;
+        vertices.reserve(segment_count + 2);
+        vertices.push_back(Vertex{
+            0.0f, 0.0f, 0.0f,
+            1.0f, 1.0f, 1.0f, 1.0f,
+            0.5f, 0.5f
+        });
+        for (unsigned int i = 0; i <= segment_count; ++i) {
+            float cosine{rim.cosines[i]};
+            float sine{rim.sines[i]};
+            vertices.push_back(Vertex{
+                cosine * radius, sine * radius, 0.0f,
+                1.0f, 1.0f, 1.0f, 1.0f,
+                0.5f + cosine * 0.5f, 0.5f - sine * 0.5f
+            });
+        }
+
+        if (type == Points) {
+            indices.resize(vertices.size());
+            for (unsigned int i = 0; i < indices.size(); ++i) {
+                indices[i] = i;
+            }
+        } else {
+            indices.reserve(static_cast<size_t>(segment_count) * (type == Lines ? 4 : 3));
+            for (unsigned int i = 1; i <= segment_count; ++i) {
+                indices.push_back(0);
+                indices.push_back(i);
+                if (type == Lines) indices.push_back(i);
+                indices.push_back(i + 1);
+            }
+        }
+
+        return geometry_data;
+    }
+
+    static GeometryData generate_sphere_geometry_data(
+                            float radius,
+                            unsigned int width_segment_count,
+                            unsigned int height_segment_count,
+                            GeometryType type = Triangles
+                        )
+    {
+        assert(width_segment_count >= 3 && height_segment_count >= 2);
+        assert(type == Triangles || type == Lines || type == Points);
+
+        utilities::TrigonometryTable segments = utilities::make_trigonometry_table(
+            width_segment_count + 1, 0.0f, two_pi / static_cast<float>(width_segment_count)
+        );
+        utilities::TrigonometryTable rings = utilities::make_trigonometry_table(
+            height_segment_count + 1, 0.0f, pi / static_cast<float>(height_segment_count)
+        );
+
+        size_t ring_size{static_cast<size_t>(width_segment_count) + 1};
+        size_t vertex_count{ring_size * (height_segment_count + 1)};
+        // The first and the last ring only have the triangles that do not collapse into the poles.
+        size_t triangle_count{static_cast<size_t>(width_segment_count) * (2 * height_segment_count - 2)};
+
+        GeometryData geometry_data;
+        auto &[vertices, indices] = geometry_data;
+        vertices.resize(vertex_count);
+        if (type == Points) {
+            indices.resize(vertex_count);
+        } else {
+            indices.resize(triangle_count * (type == Lines ? 6 : 3));
+        }
+
+        auto generate_rings = [&](size_t first_ring, size_t last_ring) {
+            for (size_t ring = first_ring; ring < last_ring; ++ring) {
+                float v{static_cast<float>(ring) / static_cast<float>(height_segment_count)};
+                float y{rings.cosines[ring] * radius};
+                float ring_radius{rings.sines[ring] * radius};
+
+                Vertex *ring_vertices = vertices.data() + ring * ring_size;
+                for (size_t segment = 0; segment < ring_size; ++segment) {
+                    float u{static_cast<float>(segment) / static_cast<float>(width_segment_count)};
+                    ring_vertices[segment] = Vertex{
+                        segments.cosines[segment] * ring_radius, y, segments.sines[segment] * ring_radius,
+                        1.0f, 1.0f, 1.0f, 1.0f,
+                        1.0f - u, v
+                    };
+                }
+
+                if (type == Points) {
+                    for (size_t i = ring * ring_size; i < (ring + 1) * ring_size; ++i) {
+                        indices[i] = static_cast<unsigned int>(i);
+                    }
+                    continue;
+                }
+                if (ring == height_segment_count) continue;
+
+                size_t triangles_before{width_segment_count * (ring == 0 ? 0 : 2 * ring - 1)};
+                unsigned int *ring_indices = indices.data() + triangles_before * (type == Lines ? 6 : 3);
+                for (unsigned int segment = 0; segment < width_segment_count; ++segment) {
+                    auto index_a = static_cast<unsigned int>(ring * ring_size + segment);
+                    unsigned int index_b{index_a + 1};
+                    auto index_c = static_cast<unsigned int>(index_a + ring_size);
+                    unsigned int index_d{index_c + 1};
+
+                    if (ring != 0) {
+                        if (type == Lines) {
+                            for (unsigned int index : {index_a, index_b, index_b, index_c, index_c, index_a}) *ring_indices++ = index;
+                        } else {
+                            for (unsigned int index : {index_a, index_b, index_c}) *ring_indices++ = index;
+                        }
+                    }
+                    if (ring != height_segment_count - 1) {
+                        if (type == Lines) {
+                            for (unsigned int index : {index_b, index_d, index_d, index_c, index_c, index_b}) *ring_indices++ = index;
+                        } else {
+                            for (unsigned int index : {index_b, index_d, index_c}) *ring_indices++ = index;
+                        }
+                    }
+                }
+            }
+        };
+        if (vertex_count >= parallel_shape_generation_threshold) {
+            utilities::parallel_for(0, height_segment_count + 1, generate_rings);
+        } else {
+            generate_rings(0, height_segment_count + 1);
+        }
+
+        return geometry_data;
+    }
+
+    // Seam triangles get u past 1, so the texture needs the Repeat wrap mode in u.
+    static GeometryData generate_icosphere_geometry_data(
+                            float radius,
+                            unsigned int subdivision_count,
+                            GeometryType type = Triangles,
+                            SphereTextureMapping mapping = SeamlessEquirectangularMapping
+                        )
+    {
+        assert(mapping != CubeFaceMapping);
+        assert(subdivision_count <= 10);
+
+        // Two rings of five vertices at a latitude of atan(1 / 2), the lower one turned by half a step.
+        std::vector<glm::vec3> positions;
+        positions.reserve(10 * (size_t{1} << (2 * subdivision_count)) + 2);
+        float ring_y{1.0f / std::sqrt(5.0f)};
+        float ring_radius{2.0f / std::sqrt(5.0f)};
+        positions.emplace_back(0.0f, 1.0f, 0.0f);
+        for (unsigned int i = 0; i < 10; ++i) {
+            float theta{static_cast<float>(i) * (two_pi / 10.0f)};
+            positions.emplace_back(ring_radius * std::cos(theta), i % 2 == 0 ? ring_y : -ring_y, ring_radius * std::sin(theta));
+        }
+        positions.emplace_back(0.0f, -1.0f, 0.0f);
+
+        std::vector<unsigned int> triangles;
+        for (unsigned int i = 0; i < 5; ++i) {
+            unsigned int upper{1 + 2 * i};
+            unsigned int lower{2 + 2 * i};
+            unsigned int next_upper{1 + (2 * i + 2) % 10};
+            unsigned int next_lower{2 + (2 * i + 2) % 10};
+            for (unsigned int index : {
+                     0u, next_upper, upper,
+                     upper, next_upper, lower,
+                     lower, next_upper, next_lower,
+                     11u, lower, next_lower
+                 }) {
+                triangles.push_back(index);
+            }
+        }
+
+        std::unordered_map<uint64_t, unsigned int> midpoints;
+        std::vector<unsigned int> subdivided_triangles;
+        for (unsigned int level = 0; level < subdivision_count; ++level) {
+            midpoints.clear();
+            midpoints.reserve(triangles.size() / 2);
+            subdivided_triangles.clear();
+            subdivided_triangles.reserve(triangles.size() * 4);
+            for (size_t i = 0; i < triangles.size(); i += 3) {
+                unsigned int a{triangles[i]}, b{triangles[i + 1]}, c{triangles[i + 2]};
+                unsigned int ab{utilities::get_edge_midpoint(positions, midpoints, a, b)};
+                unsigned int bc{utilities::get_edge_midpoint(positions, midpoints, b, c)};
+                unsigned int ca{utilities::get_edge_midpoint(positions, midpoints, c, a)};
+                for (unsigned int index : {a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca}) {
+                    subdivided_triangles.push_back(index);
+                }
+            }
+            triangles.swap(subdivided_triangles);
+        }
+
+        std::vector<Vertex> vertices{utilities::map_sphere_positions_to_equirectangular_vertices(
+            positions, triangles, radius, mapping == SeamlessEquirectangularMapping
+        )};
+
+        return utilities::make_triangle_mesh_geometry_data(std::move(vertices), triangles, type);
+    }
+
+    // An even segment count puts a vertex on each pole, which the equirectangular mappings need.
+    static GeometryData generate_cube_sphere_geometry_data(
+                            float radius,
+                            unsigned int segment_count,
+                            GeometryType type = Triangles,
+                            SphereTextureMapping mapping = SeamlessEquirectangularMapping
+                        )
+    {
+        assert(segment_count >= 1 && segment_count <= 4096);
+
+        // Face normals with two axes whose cross product is the normal, so the quads wind outwards.
+        static const int faces[6][3][3]{
+            {{ 1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+            {{ 0, 1, 0}, {0, 0, 1}, {1, 0, 0}}, {{ 0,-1, 0}, {1, 0, 0}, {0, 0, 1}},
+            {{ 0, 0, 1}, {1, 0, 0}, {0, 1, 0}}, {{ 0, 0,-1}, {0, 1, 0}, {1, 0, 0}}
+        };
+
+        auto n = static_cast<int>(segment_count);
+        auto warp = [n](int coordinate) {
+            return std::tan(static_cast<float>(coordinate) / static_cast<float>(n) * quarter_pi);
+        };
+
+        size_t face_vertex_count{static_cast<size_t>(segment_count + 1) * (segment_count + 1)};
+        std::vector<glm::vec3> face_positions(face_vertex_count);
+        std::vector<glm::vec3> positions;
+        std::vector<Vertex> face_vertices;
+        std::vector<unsigned int> triangles;
+        triangles.reserve(static_cast<size_t>(segment_count) * segment_count * 36);
+        if (mapping == CubeFaceMapping) {
+            face_vertices.reserve(face_vertex_count * 6);
+        } else {
+            positions.reserve(static_cast<size_t>(segment_count) * segment_count * 6 + 2);
+        }
+
+        // Integer lattice coordinates identify the vertices that neighbouring faces share.
+        std::unordered_map<uint64_t, unsigned int> lattice_indices;
+        lattice_indices.reserve(mapping == CubeFaceMapping ? 0 : positions.capacity());
+        std::vector<unsigned int> face_indices(face_vertex_count);
+        for (const auto &face : faces) {
+            const int *normal = face[0], *s_axis = face[1], *t_axis = face[2];
+            for (int j = 0; j <= n; ++j) {
+                for (int i = 0; i <= n; ++i) {
+                    int lattice[3];
+                    for (unsigned int axis = 0; axis < 3; ++axis) {
+                        lattice[axis] = normal[axis] * n + s_axis[axis] * (2 * i - n) + t_axis[axis] * (2 * j - n);
+                    }
+                    glm::vec3 position{glm::normalize(glm::vec3{warp(lattice[0]), warp(lattice[1]), warp(lattice[2])})};
+
+                    face_positions[static_cast<size_t>(j) * (segment_count + 1) + i] = position;
+                    unsigned int &index = face_indices[static_cast<size_t>(j) * (segment_count + 1) + i];
+                    if (mapping == CubeFaceMapping) {
+                        index = static_cast<unsigned int>(face_vertices.size());
+                        face_vertices.push_back(Vertex{
+                            position.x * radius, position.y * radius, position.z * radius,
+                            1.0f, 1.0f, 1.0f, 1.0f,
+                            static_cast<float>(i) / static_cast<float>(n), 1.0f - static_cast<float>(j) / static_cast<float>(n)
+                        });
+                        continue;
+                    }
+
+                    uint64_t key{
+                        static_cast<uint64_t>(lattice[0] + n) << 42 |
+                        static_cast<uint64_t>(lattice[1] + n) << 21 |
+                        static_cast<uint64_t>(lattice[2] + n)
+                    };
+                    auto [iterator, inserted] = lattice_indices.emplace(key, static_cast<unsigned int>(positions.size()));
+                    if (inserted) positions.push_back(position);
+                    index = iterator->second;
+                }
+            }
+
+            // Splitting along the shorter diagonal keeps the triangles closer to the sphere.
+            for (unsigned int j = 0; j < segment_count; ++j) {
+                for (unsigned int i = 0; i < segment_count; ++i) {
+                    size_t first{static_cast<size_t>(j) * (segment_count + 1) + i};
+                    size_t second{first + segment_count + 1};
+                    unsigned int a{face_indices[first]}, b{face_indices[first + 1]};
+                    unsigned int c{face_indices[second]}, d{face_indices[second + 1]};
+
+                    glm::vec3 ad{face_positions[second + 1] - face_positions[first]};
+                    glm::vec3 bc{face_positions[second] - face_positions[first + 1]};
+                    if (glm::dot(ad, ad) <= glm::dot(bc, bc)) {
+                        for (unsigned int index : {a, b, d, a, d, c}) triangles.push_back(index);
+                    } else {
+                        for (unsigned int index : {a, b, c, b, d, c}) triangles.push_back(index);
+                    }
+                }
+            }
+        }
+
+        if (mapping != CubeFaceMapping) {
+            face_vertices = utilities::map_sphere_positions_to_equirectangular_vertices(
+                positions, triangles, radius, mapping == SeamlessEquirectangularMapping
+            );
+        }
+
+        return utilities::make_triangle_mesh_geometry_data(std::move(face_vertices), triangles, type);
+    }
+
+    /*
+     * Wireframe
+     */
+
+    static GeometryData generate_wireframe_geometry_data(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &triangle_indices)
+    {
+        return utilities::assign_barycentric_slots(vertices.data(), vertices.size(), triangle_indices.data(), triangle_indices.size());
+    }
+
+    // Insert the wireframe sources after the #version line.
+    static std::string get_wireframe_vertex_shader_source()
+    {
+        return R"(
+varying vec3 wireframe_barycentric;
+
+void assign_wireframe_barycentric()
+{
+    int slot = gl_VertexID % 3;
+    wireframe_barycentric = vec3(slot == 0 ? 1.0 : 0.0, slot == 1 ? 1.0 : 0.0, slot == 2 ? 1.0 : 0.0);
+}
+)";
+    }
+
+    static std::string get_wireframe_fragment_shader_source(const glm::vec4 &color = glm::vec4{1.0f}, float width = 1.5f)
+    {
+        // GLSL always takes a period as the decimal separator, whatever the locale of the application.
+        std::ostringstream source;
+        source.imbue(std::locale::classic());
+        source << std::fixed << std::setprecision(8)
+               << "const vec4 wireframe_color = vec4("
+                   << color.x << ", " << color.y << ", " << color.z << ", " << color.w << ");\n"
+               << "const float wireframe_half_width = " << width * 0.5f << ";\n"
+               << R"(
+varying vec3 wireframe_barycentric;
+
+vec4 apply_wireframe(vec4 color)
+{
+    vec3 edge_distances = wireframe_barycentric / max(fwidth(wireframe_barycentric), vec3(1e-6));
+    float edge_distance = min(min(edge_distances.x, edge_distances.y), edge_distances.z);
+    float coverage = 1.0 - smoothstep(wireframe_half_width - 0.5, wireframe_half_width + 0.5, edge_distance);
+
+    return mix(color, vec4(wireframe_color.rgb, 1.0), coverage * wireframe_color.a);
+}
+)";
+
+        return source.str();
+    }
+
+    /*
+     * Texture Handling
+     */
+
+    static Texture generate_texture(Image &image, bool generate_mipmaps = false)
+    {
+        Texture texture;
+        texture.memory_owner = utilities::get_current_memory_owner();
+        utilities::upload_texture_image(texture, image, generate_mipmaps, false);
+
+        return texture;
+    }
+
+    // Shaders sample it with a sampler2DArray and pick the image with the vertex layer.
+    static Texture generate_texture_array(std::vector<Image> &images, bool generate_mipmaps = false)
+    {
+        assert(!images.empty());
+
+        if (!(GLEW_VERSION_3_0 || GLEW_EXT_texture_array)) {
+            std::cerr << "Texture arrays are not supported by the OpenGL context" << std::endl;
+            std::exit(-1);
+        }
+
+        const Image &first_image = images.front();
+        for (const auto &image : images) {
+            if (image.width != first_image.width ||
+                image.height != first_image.height ||
+                image.channels != first_image.channels ||
+                image.bgr_order != first_image.bgr_order) {
+                std::cerr << "Images of a texture array must share the size and the pixel format" << std::endl;
+                std::exit(-1);
+            }
+        }
+
+        Texture texture;
+        texture.memory_owner = utilities::get_current_memory_owner();
+        utilities::upload_texture_array_images(texture, images, generate_mipmaps);
+
+        return texture;
+    }
+
+    static void set_texture_mode(TexturingMode mode)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->mode = mode;
+    }
+
+    static void set_texture_wrap_mode_u(TextureWrapMode wrap_mode_u)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->wrap_mode_u = wrap_mode_u;
+        utilities::set_texture_parameter(
+            utilities::convert_texture_type_to_gl_texture_target(data::current_texture->type), GL_TEXTURE_WRAP_S,
+            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(wrap_mode_u)
+        );
+    }
+
+    static void set_texture_wrap_mode_v(TextureWrapMode wrap_mode_v)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->wrap_mode_v = wrap_mode_v;
+        utilities::set_texture_parameter(
+            utilities::convert_texture_type_to_gl_texture_target(data::current_texture->type), GL_TEXTURE_WRAP_T,
+            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(wrap_mode_v)
+        );
+    }
+
+    static void set_texture_magnification_filter(TextureFilterType magnification_filter)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->magnification_filter = magnification_filter;
+        utilities::set_texture_parameter(
+            utilities::convert_texture_type_to_gl_texture_target(data::current_texture->type), GL_TEXTURE_MAG_FILTER,
+            utilities::convert_filter_type_to_es2_texture_filter_type(magnification_filter)
+        );
+    }
+
+    static void set_texture_minification_filter(TextureFilterType minification_filter)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->minification_filter = minification_filter;
+        utilities::set_texture_parameter(
+            utilities::convert_texture_type_to_gl_texture_target(data::current_texture->type), GL_TEXTURE_MIN_FILTER,
+            utilities::convert_filter_type_to_es2_texture_filter_type(minification_filter)
+        );
+    }
+
+    static void set_texture_anisotropy(float anisotropy)
+    {
+        assert(data::current_texture);
+
+        data::current_texture->anisotropy = anisotropy;
+        utilities::set_texture_parameter(
+            utilities::convert_texture_type_to_gl_texture_target(data::current_texture->type), GL_TEXTURE_MAX_ANISOTROPY_EXT,
+            static_cast<GLfloat>(anisotropy)
+        );
+    }
+
+    static void set_texture_current(Texture *texture, unsigned int sampler = 0)
+    {
+        data::current_texture = texture;
+        utilities::bind_sampled_texture(texture, sampler);
+    }
+
+    static void destroy_texture(Texture &texture)
+    {
+        for (auto &current_texture : data::current_textures) {
+            if (current_texture == &texture) current_texture = nullptr;
+        }
+        if (data::current_texture == &texture) data::current_texture = nullptr;
+
+        utilities::forget_deleted_texture(texture.texture_object);
+        glDeleteTextures(1, &texture.texture_object);
+        texture.texture_object = 0;
+
+        utilities::account_memory(Textures, texture.memory_owner, -static_cast<int64_t>(texture.memory_size));
+        texture.memory_size = 0;
+    }
+
+    /*
+     * Resource Loading
+     */
+
+    static std::shared_ptr<TextureUpload> generate_texture_async(Image image, bool generate_mipmaps = false)
+    {
+        auto upload = std::make_shared<TextureUpload>();
+        upload->texture.memory_owner = utilities::get_current_memory_owner();
+        auto source = std::make_shared<Image>(std::move(image));
+
+        ResourceUploadJob job;
+        job.upload = [upload, source, generate_mipmaps]() {
+            utilities::upload_texture_image(upload->texture, *source, generate_mipmaps, true);
+            source->pixel_data = PixelData{};
+        };
+        job.publish = [upload]() {
+            if (upload.use_count() == 1) {
+                destroy_texture(upload->texture);
+                return;
+            }
+            upload->ready = true;
+        };
+        utilities::enqueue_resource_upload(std::move(job));
+
+        return upload;
+    }
+
+    static std::shared_ptr<GeometryUpload> generate_geometry_async(
+                                               GeometryType type,
+                                               std::vector<Vertex> vertices,
+                                               std::vector<unsigned int> indices
+                                           )
+    {
+        auto upload = std::make_shared<GeometryUpload>();
+        upload->geometry.type = type;
+        upload->geometry.vertex_count = indices.size();
+        upload->geometry.memory_owner = utilities::get_current_memory_owner();
+
+        auto source = std::make_shared<std::pair<std::vector<Vertex>, std::vector<unsigned int>>>(
+            std::move(vertices), std::move(indices)
+        );
+
+        ResourceUploadJob job;
+        job.upload = [upload, source]() {
+            utilities::upload_geometry_buffers(
+                upload->geometry,
+                source->first.data(), source->first.size(),
+                source->second.data(), source->second.size()
+            );
+            source->first = std::vector<Vertex>{};
+            source->second = std::vector<unsigned int>{};
+        };
+        job.publish = [upload]() {
+            // Vertex array objects are not shared between contexts, so they are set up on the render thread.
+            if (upload.use_count() == 1) {
+                destroy_geometry(upload->geometry);
+                return;
+            }
+            utilities::configure_vertex_array(upload->geometry);
+            upload->ready = true;
+        };
+        utilities::enqueue_resource_upload(std::move(job));
+
+        return upload;
+    }
+
+    static void publish_uploaded_resources()
+    {
+        {
+            std::lock_guard<std::mutex> lock{data::resource_loader_mutex};
+            while (!data::finished_resource_uploads.empty()) {
+                data::fenced_resource_uploads.push_back(std::move(data::finished_resource_uploads.front()));
+                data::finished_resource_uploads.pop_front();
+            }
+        }
+
+        while (!data::fenced_resource_uploads.empty()) {
+            ResourceUploadJob &job = data::fenced_resource_uploads.front();
+            if (job.fence != nullptr) {
+                GLenum status = glClientWaitSync(job.fence, 0, 0);
+                if (status == GL_TIMEOUT_EXPIRED) break;
+                if (status == GL_WAIT_FAILED) {
+                    // The fence can no longer tell when the upload has landed, so all queued work is finished instead.
+                    std::cerr << "Failed to wait for a resource upload fence, finishing all OpenGL work instead" << std::endl;
+                    glFinish();
+                }
+
+                glDeleteSync(job.fence);
+                job.fence = nullptr;
+            }
+
+            job.publish();
+            data::fenced_resource_uploads.pop_front();
+        }
+    }
+
+    /*
+     * Asynchronous Loading
+     *
+     * Files are read and decoded by jobs on the job system; completions, including the callbacks, are delivered on
+     * the render thread at the start of prepare_to_render_frame(). Failures never exit the application,
+     * they leave the handle in the Failed state with an error message.
+     */
+
+    template<typename T>
+    using AsyncLoadCallback = std::function<void(AsyncLoad<T> &)>;
+
+    template<typename T>
+    static void cancel_load(AsyncLoad<T> &load)
+    {
+        load.cancel_requested = true;
+    }
+
+    static std::shared_ptr<AsyncLoad<std::string>> read_text_file_async(
+                                                       const std::string &path,
+                                                       LoadPriority priority = Normal,
+                                                       AsyncLoadCallback<std::string> callback = nullptr
+                                                   )
+    {
+        auto load = std::make_shared<AsyncLoad<std::string>>();
+        auto succeeded = std::make_shared<bool>(false);
+
+        AsyncLoadJob job;
+        job.priority = priority;
+        job.is_cancelled = [load]() { return load->cancel_requested.load(); };
+        job.load = [load, succeeded, path]() {
+            *succeeded = utilities::try_read_text_file(path, load->value, load->error);
+        };
+        job.complete = [load, succeeded, callback]() {
+            load->state = load->cancel_requested ? Cancelled : (*succeeded ? Ready : Failed);
+            if (callback) callback(*load);
+        };
+        utilities::enqueue_async_load(std::move(job));
+
+        return load;
+    }
+
+    static std::shared_ptr<AsyncLoad<Image>> read_image_file_async(
+                                                 const std::string &path,
+                                                 unsigned int conversions = NoPixelConversion,
+                                                 LoadPriority priority = Normal,
+                                                 AsyncLoadCallback<Image> callback = nullptr
+                                             )
+    {
+        auto load = std::make_shared<AsyncLoad<Image>>();
+        auto succeeded = std::make_shared<bool>(false);
+
+        AsyncLoadJob job;
+        job.priority = priority;
+        job.is_cancelled = [load]() { return load->cancel_requested.load(); };
+        job.load = [load, succeeded, path, conversions]() {
+            *succeeded = utilities::try_read_image_file(path, conversions, load->value, load->error);
+        };
+        job.complete = [load, succeeded, callback]() {
+            load->state = load->cancel_requested ? Cancelled : (*succeeded ? Ready : Failed);
+            if (load->state != Ready) load->value = Image{};
+            if (callback) callback(*load);
+        };
+        utilities::enqueue_async_load(std::move(job));
+
+        return load;
+    }
+
+    // Until the handle is Ready, get_loaded_texture() returns a shared placeholder.
+    static std::shared_ptr<AsyncLoad<Texture>> load_texture_async(
+                                                   const std::string &path,
+                                                   unsigned int conversions = NoPixelConversion,
+                                                   bool generate_mipmaps = false,
+                                                   LoadPriority priority = Normal,
+                                                   AsyncLoadCallback<Texture> callback = nullptr
+                                               )
+    {
+        utilities::get_placeholder_texture();
+
+        auto load = std::make_shared<AsyncLoad<Texture>>();
+        load->value.memory_owner = utilities::get_current_memory_owner();
+        auto image = std::make_shared<Image>();
+        auto succeeded = std::make_shared<bool>(false);
+
+        AsyncLoadJob job;
+        job.priority = priority;
+        job.is_cancelled = [load]() { return load->cancel_requested.load(); };
+        job.load = [load, image, succeeded, path, conversions]() {
+            *succeeded = utilities::try_read_image_file(path, conversions, *image, load->error);
+        };
+        job.complete = [load, image, succeeded, generate_mipmaps, callback]() {
+            if (load->cancel_requested || !*succeeded) {
+                load->state = load->cancel_requested ? Cancelled : Failed;
+                if (callback) callback(*load);
+                return;
+            }
+
+            ResourceUploadJob upload;
+            upload.upload = [load, image, generate_mipmaps]() {
+                utilities::upload_texture_image(load->value, *image, generate_mipmaps, true);
+                image->pixel_data = PixelData{};
+            };
+            upload.publish = [load, callback]() {
+                if (load.use_count() == 1 || load->cancel_requested) {
+                    destroy_texture(load->value);
+                    load->state = Cancelled;
+                } else {
+                    load->state = Ready;
+                }
+                if (callback) callback(*load);
+            };
+            utilities::enqueue_resource_upload(std::move(upload));
+        };
+        utilities::enqueue_async_load(std::move(job));
+
+        return load;
+    }
+
+    static const Texture *get_loaded_texture(const AsyncLoad<Texture> &load)
+    {
+        return load.state == Ready ? &load.value : &data::placeholder_texture;
+    }
+
+    // The texture parameter setters do not apply to it.
+    static void set_loaded_texture_current(const AsyncLoad<Texture> &load, unsigned int sampler = 0)
+    {
+        data::current_texture = nullptr;
+        utilities::bind_sampled_texture(get_loaded_texture(load), sampler);
+    }
+
+    /*
+     * Texture Streaming
+     */
+
+    // The image passed to an update has to stay unchanged until the next prepare_to_render_frame().
+    static std::shared_ptr<TextureStream> generate_texture_stream(const Texture &texture, bool track_dirty_rows = false)
+    {
+        assert(texture.type == Texture2D);
+
+        auto stream = std::make_shared<TextureStream>();
+        stream->texture = texture;
+        stream->buffer_size = static_cast<size_t>(texture.width) * texture.height * texture.channels;
+        stream->track_dirty_rows = track_dirty_rows;
+        if (track_dirty_rows) {
+            stream->dirty_rows.assign(texture.height, 0);
+        }
+
+        if (utilities::are_texture_streams_supported()) {
+            for (auto &buffer : stream->buffers) {
+                glGenBuffers(1, &buffer.pixel_buffer_object);
+                utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, buffer.pixel_buffer_object);
+                utilities::upload_buffer_data(GL_PIXEL_UNPACK_BUFFER, stream->buffer_size, nullptr, GL_STREAM_DRAW);
+                if (track_dirty_rows) {
+                    buffer.dirty_rows.assign(texture.height, 0);
+                }
+            }
+            utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            utilities::account_memory(
+                Buffers, texture.memory_owner,
+                static_cast<int64_t>(stream->buffer_size * texture_stream_buffer_count)
+            );
+            utilities::start_texture_stream_copier();
+        }
+
+        data::texture_streams.push_back(stream);
+
+        return stream;
+    }
+
+    static void mark_texture_rows_dirty(TextureStream &stream, unsigned int first_row, unsigned int row_count)
+    {
+        assert(stream.track_dirty_rows);
+        assert(first_row + row_count <= stream.texture.height);
+
+        std::fill_n(stream.dirty_rows.begin() + first_row, row_count, static_cast<uint8_t>(1));
+    }
+
+    static void update_texture_region(
+                    TextureStream &stream,
+                    const Image &image,
+                    unsigned int x, unsigned int y,
+                    unsigned int width, unsigned int height
+                )
+    {
+        ASR_TRACE_SCOPE("update_texture_region");
+
+        const Texture &texture = stream.texture;
+        assert(image.width == texture.width && image.height == texture.height && image.channels == texture.channels);
+        assert(x + width <= texture.width && y + height <= texture.height);
+
+        auto dirty_rows_begin = stream.dirty_rows.begin() + (stream.track_dirty_rows ? y : 0);
+        auto dirty_rows_end = stream.dirty_rows.begin() + (stream.track_dirty_rows ? y + height : 0);
+        if (stream.track_dirty_rows && std::find(dirty_rows_begin, dirty_rows_end, 1) == dirty_rows_end) return;
+
+        size_t source_row_size{static_cast<size_t>(image.width) * image.channels};
+        size_t row_size{static_cast<size_t>(width) * image.channels};
+        const uint8_t *source_pixels = image.pixel_data.data() + y * source_row_size + x * image.channels;
+
+        TextureStreamBuffer *free_buffer{nullptr};
+        if (utilities::are_texture_streams_supported()) {
+            free_buffer = utilities::acquire_texture_stream_buffer(stream);
+        }
+        if (free_buffer == nullptr) {
+            // Updates still in the buffers are committed first, so they cannot overwrite this one.
+            utilities::commit_texture_stream(stream);
+
+            unsigned int unit{data::gl_state.active_texture_unit};
+            GLuint previous_texture{data::gl_state.bound_textures[unit]};
+            GLenum previous_target{data::gl_state.bound_texture_targets[unit]};
+
+            utilities::bind_texture(GL_TEXTURE_2D, texture.texture_object);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(image.width));
+            glTexSubImage2D(
+                GL_TEXTURE_2D, 0,
+                static_cast<GLint>(x), static_cast<GLint>(y),
+                static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                utilities::get_pixel_format(texture.channels, texture.bgr_order), GL_UNSIGNED_BYTE,
+                reinterpret_cast<const GLvoid *>(source_pixels)
+            );
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            utilities::count_uploaded_bytes(height * row_size);
+            utilities::bind_texture(previous_target != 0 ? previous_target : GL_TEXTURE_2D, previous_texture);
+
+            std::fill(dirty_rows_begin, dirty_rows_end, static_cast<uint8_t>(0));
+            return;
+        }
+
+        TextureStreamBuffer &buffer = *free_buffer;
+        utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, buffer.pixel_buffer_object);
+        buffer.mapped_pixels = static_cast<uint8_t *>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(height * row_size),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+        ));
+        utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (buffer.mapped_pixels == nullptr) {
+            std::cerr << "Failed to map a pixel buffer of a texture stream" << std::endl;
+            std::exit(-1);
+        }
+
+        buffer.source_pixels = source_pixels;
+        buffer.source_row_size = source_row_size;
+        buffer.row_size = row_size;
+        buffer.x = x;
+        buffer.y = y;
+        buffer.width = width;
+        buffer.height = height;
+        if (stream.track_dirty_rows) {
+            std::copy(stream.dirty_rows.begin(), stream.dirty_rows.end(), buffer.dirty_rows.begin());
+            std::fill(dirty_rows_begin, dirty_rows_end, static_cast<uint8_t>(0));
+        }
+        buffer.pending = true;
+
+        {
+            std::lock_guard<std::mutex> lock{data::texture_stream_mutex};
+            buffer.copied = false;
+            data::pending_texture_stream_copies.push_back(&buffer);
+        }
+        data::texture_stream_condition.notify_all();
+    }
+
+    static void update_texture(TextureStream &stream, const Image &image)
+    {
+        update_texture_region(stream, image, 0, 0, stream.texture.width, stream.texture.height);
+    }
+
+    static void destroy_texture_stream(TextureStream &stream)
+    {
+        for (auto &buffer : stream.buffers) {
+            if (buffer.pending) {
+                utilities::wait_for_texture_stream_copy(buffer);
+                utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, buffer.pixel_buffer_object);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                utilities::bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                buffer.pending = false;
+            }
+            if (buffer.fence != nullptr) {
+                glDeleteSync(buffer.fence);
+                buffer.fence = nullptr;
+            }
+            if (buffer.pixel_buffer_object != 0) {
+                glDeleteBuffers(1, &buffer.pixel_buffer_object);
+                buffer.pixel_buffer_object = 0;
+            }
+        }
+
+        if (utilities::are_texture_streams_supported()) {
+            utilities::account_memory(
+                Buffers, stream.texture.memory_owner,
+                -static_cast<int64_t>(stream.buffer_size * texture_stream_buffer_count)
+            );
+        }
+
+        data::texture_streams.erase(
+            std::remove_if(
+                data::texture_streams.begin(), data::texture_streams.end(),
+                [&stream](const std::shared_ptr<TextureStream> &registered_stream) { return registered_stream.get() == &stream; }
+            ),
+            data::texture_streams.end()
+        );
+    }
+
+    /*
+     * Virtual Texturing
+     */
+
+    static std::shared_ptr<VirtualTexture> generate_virtual_texture(
+                                               unsigned int width, unsigned int height,
+                                               VirtualTextureTileProvider provider,
+                                               unsigned int tile_size = 128,
+                                               unsigned int atlas_size = 4096
+                                           )
+    {
+        assert(width > 0 && height > 0 && tile_size > 0);
+
+        // The OpenGL textures need the render thread, so only destroy_virtual_texture() releases them.
+        std::shared_ptr<VirtualTexture> texture{new VirtualTexture{}, [](VirtualTexture *released_texture) {
+            utilities::stop_virtual_texture_loaders(*released_texture);
+            delete released_texture;
+        }};
+        texture->width = width;
+        texture->height = height;
+        texture->tile_size = tile_size;
+        texture->padded_tile_size = tile_size + 2 * virtual_texture_tile_border;
+        texture->provider = std::move(provider);
+
+        // A power-of-two square of tiles, so every level lines up with a mip level of the indirection texture.
+        unsigned int tiles_needed{(std::max(width, height) + tile_size - 1) / tile_size};
+        texture->tiles_per_side = 1;
+        texture->level_count = 1;
+        while (texture->tiles_per_side < tiles_needed) {
+            texture->tiles_per_side *= 2;
+            ++texture->level_count;
+        }
+
+        GLint max_texture_size{0};
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+        unsigned int atlas_side{std::min(atlas_size, static_cast<unsigned int>(max_texture_size))};
+        texture->atlas_tiles_per_side = std::min(255u, atlas_side / texture->padded_tile_size);
+        if (texture->atlas_tiles_per_side < 2) {
+            std::cerr << "The virtual texture atlas cannot hold the requested tile size" << std::endl;
+            std::exit(-1);
+        }
+
+        unsigned int owner{utilities::get_current_memory_owner()};
+
+        Texture &atlas = texture->atlas_texture;
+        atlas.width = texture->atlas_tiles_per_side * texture->padded_tile_size;
+        atlas.height = atlas.width;
+        atlas.channels = 4;
+        atlas.memory_owner = owner;
+        glGenTextures(1, &atlas.texture_object);
+        utilities::bind_texture(GL_TEXTURE_2D, atlas.texture_object);
+        utilities::apply_texture_parameters(atlas);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGBA,
+            static_cast<GLsizei>(atlas.width), static_cast<GLsizei>(atlas.height),
+            0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
+        );
+        atlas.memory_size = utilities::calculate_texture_memory_size(atlas.width, atlas.height, 4, false);
+        utilities::account_memory(Textures, owner, static_cast<int64_t>(atlas.memory_size));
+
+        Texture &indirection = texture->indirection_texture;
+        indirection.width = texture->tiles_per_side;
+        indirection.height = texture->tiles_per_side;
+        indirection.channels = 4;
+        indirection.minification_filter = NearestMipmapNearest;
+        indirection.magnification_filter = Nearest;
+        indirection.memory_owner = owner;
+        glGenTextures(1, &indirection.texture_object);
+        utilities::bind_texture(GL_TEXTURE_2D, indirection.texture_object);
+        utilities::apply_texture_parameters(indirection);
+        utilities::set_texture_parameter(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture->level_count - 1));
+
+        texture->tile_slots.resize(texture->level_count);
+        texture->indirection_levels.resize(texture->level_count);
+        for (unsigned int level = 0; level < texture->level_count; ++level) {
+            unsigned int side{texture->tiles_per_side >> level};
+            texture->tile_slots[level].assign(static_cast<size_t>(side) * side, virtual_texture_tile_absent);
+            texture->indirection_levels[level].assign(static_cast<size_t>(side) * side, 0);
+            glTexImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA,
+                static_cast<GLsizei>(side), static_cast<GLsizei>(side),
+                0, GL_RGBA, GL_UNSIGNED_BYTE, texture->indirection_levels[level].data()
+            );
+        }
+        indirection.memory_size = utilities::calculate_texture_memory_size(indirection.width, indirection.height, 4, true);
+        utilities::account_memory(Textures, owner, static_cast<int64_t>(indirection.memory_size));
+
+        utilities::bind_texture(GL_TEXTURE_2D, 0);
+
+        texture->slots.resize(static_cast<size_t>(texture->atlas_tiles_per_side) * texture->atlas_tiles_per_side);
+
+        unsigned int buffer_count{texture->max_tile_uploads_per_frame * 2};
+        size_t tile_buffer_size{static_cast<size_t>(texture->padded_tile_size) * texture->padded_tile_size * 4};
+        for (unsigned int i = 0; i < buffer_count; ++i) {
+            texture->free_tile_buffers.emplace_back(tile_buffer_size);
+        }
+        texture->finished_tiles.reserve(buffer_count);
+        texture->committed_tiles.reserve(buffer_count);
+        texture->requested_tiles.reserve(buffer_count * 4);
+        texture->missing_tiles.reserve(buffer_count * 4);
+
+        return texture;
+    }
+
+    // Call once per frame before rendering with the texture.
+    static void update_virtual_texture(VirtualTexture &texture, glm::vec2 visible_min, glm::vec2 visible_max, glm::vec2 viewport_size)
+    {
+        ASR_TRACE_SCOPE("update_virtual_texture");
+
+        ++texture.frame;
+
+        unsigned int unit{data::gl_state.active_texture_unit};
+        GLuint previous_texture{data::gl_state.bound_textures[unit]};
+        GLenum previous_target{data::gl_state.bound_texture_targets[unit]};
+
+        // Committed first, so the visibility pass below already sees them as resident.
+        {
+            std::lock_guard<std::mutex> lock{texture.mutex};
+            size_t count{std::min<size_t>(texture.finished_tiles.size(), texture.max_tile_uploads_per_frame)};
+            for (size_t i = 0; i < count; ++i) {
+                texture.committed_tiles.push_back(std::move(texture.finished_tiles[i]));
+            }
+            texture.finished_tiles.erase(
+                texture.finished_tiles.begin(),
+                texture.finished_tiles.begin() + static_cast<std::ptrdiff_t>(count)
+            );
+        }
+        for (const auto &tile : texture.committed_tiles) {
+            utilities::commit_virtual_texture_tile(texture, tile);
+        }
+        if (!texture.committed_tiles.empty()) {
+            std::lock_guard<std::mutex> lock{texture.mutex};
+            for (auto &tile : texture.committed_tiles) {
+                texture.free_tile_buffers.push_back(std::move(tile.pixels));
+            }
+            texture.committed_tiles.clear();
+        }
+
+        visible_min = glm::clamp(visible_min, glm::vec2{0.0f}, glm::vec2{1.0f});
+        visible_max = glm::clamp(visible_max, glm::vec2{0.0f}, glm::vec2{1.0f});
+        glm::vec2 image_size{static_cast<float>(texture.width), static_cast<float>(texture.height)};
+        glm::vec2 visible_texels{(visible_max - visible_min) * image_size};
+        float texels_per_pixel{std::max(
+            visible_texels.x / std::max(1.0f, viewport_size.x),
+            visible_texels.y / std::max(1.0f, viewport_size.y)
+        )};
+
+        auto max_level = static_cast<int>(texture.level_count) - 1;
+        int level{std::min(max_level, std::max(0, static_cast<int>(std::floor(std::log2(std::max(1.0f, texels_per_pixel))))))};
+
+        // The tiles of a level and of its parent (for a smooth zoom out) have to fit into the atlas together.
+        float virtual_size{static_cast<float>(texture.tiles_per_side * texture.tile_size)};
+        auto tile_range = [&](int tile_level, unsigned int &first_x, unsigned int &first_y, unsigned int &last_x, unsigned int &last_y) {
+            float level_tile_size{static_cast<float>(texture.tile_size << tile_level) / virtual_size};
+            unsigned int side{texture.tiles_per_side >> tile_level};
+            unsigned int image_tiles_x{std::min(side, static_cast<unsigned int>(std::ceil(image_size.x / virtual_size / level_tile_size)))};
+            unsigned int image_tiles_y{std::min(side, static_cast<unsigned int>(std::ceil(image_size.y / virtual_size / level_tile_size)))};
+            glm::vec2 tile_min{visible_min * image_size / virtual_size / level_tile_size};
+            glm::vec2 tile_max{visible_max * image_size / virtual_size / level_tile_size};
+            first_x = static_cast<unsigned int>(std::max(0.0f, tile_min.x - 1.0f));
+            first_y = static_cast<unsigned int>(std::max(0.0f, tile_min.y - 1.0f));
+            last_x = std::min(image_tiles_x, static_cast<unsigned int>(tile_max.x) + 2);
+            last_y = std::min(image_tiles_y, static_cast<unsigned int>(tile_max.y) + 2);
+        };
+
+        size_t capacity{texture.slots.size() * 3 / 4};
+        for (; level < max_level; ++level) {
+            unsigned int first_x, first_y, last_x, last_y;
+            tile_range(level, first_x, first_y, last_x, last_y);
+            size_t count{static_cast<size_t>(last_x - first_x) * (last_y - first_y)};
+            if (count + count / 4 + 1 <= capacity) break;
         }
 
-        data::key_down_event_handler = [&](int key) { if (key == SDLK_ESCAPE) { std::exit(0); }};
-        data::keys_down_event_handler = [&](const uint8_t *keys) { };
-    }
+        glm::vec2 center{(visible_min + visible_max) * 0.5f * image_size / virtual_size};
+        texture.missing_tiles.clear();
+        for (int tile_level = max_level; tile_level >= level; --tile_level) {
+            // The coarsest tile is always wanted; it is the fallback for every virtual tile.
+            if (tile_level != max_level && tile_level > level + 1) continue;
+
+            unsigned int first_x, first_y, last_x, last_y;
+            tile_range(tile_level, first_x, first_y, last_x, last_y);
+            size_t level_first_missing{texture.missing_tiles.size()};
+            for (unsigned int y = first_y; y < last_y; ++y) {
+                for (unsigned int x = first_x; x < last_x; ++x) {
+                    int32_t slot{utilities::get_virtual_texture_tile_slot(texture, static_cast<unsigned int>(tile_level), x, y)};
+                    if (slot >= 0) {
+                        texture.slots[static_cast<size_t>(slot)].last_used_frame = texture.frame;
+                    } else if (slot == virtual_texture_tile_absent) {
+                        texture.missing_tiles.push_back(
+                            utilities::make_virtual_texture_tile_key(static_cast<unsigned int>(tile_level), x, y)
+                        );
+                    }
+                }
+            }
 
-    static void create_window()
-    {
-        create_window(data::fullscreen, data::fullscreen);
+            float tile_extent{static_cast<float>(1u << tile_level) / static_cast<float>(texture.tiles_per_side)};
+            std::sort(
+                texture.missing_tiles.begin() + static_cast<std::ptrdiff_t>(level_first_missing),
+                texture.missing_tiles.end(),
+                [&](uint64_t a, uint64_t b) {
+                    unsigned int a_level, a_x, a_y, b_level, b_x, b_y;
+                    utilities::split_virtual_texture_tile_key(a, a_level, a_x, a_y);
+                    utilities::split_virtual_texture_tile_key(b, b_level, b_x, b_y);
+                    glm::vec2 a_offset{
+                        (glm::vec2{static_cast<float>(a_x), static_cast<float>(a_y)} + 0.5f) * tile_extent - center
+                    };
+                    glm::vec2 b_offset{
+                        (glm::vec2{static_cast<float>(b_x), static_cast<float>(b_y)} + 0.5f) * tile_extent - center
+                    };
+                    return glm::dot(a_offset, a_offset) < glm::dot(b_offset, b_offset);
+                }
+            );
+        }
+
+        // Replaced every frame, so tiles that scrolled out of view are never produced.
+        {
+            std::lock_guard<std::mutex> lock{texture.mutex};
+            for (size_t i = texture.next_requested_tile; i < texture.requested_tiles.size(); ++i) {
+                unsigned int tile_level, x, y;
+                utilities::split_virtual_texture_tile_key(texture.requested_tiles[i], tile_level, x, y);
+                utilities::get_virtual_texture_tile_slot(texture, tile_level, x, y) = virtual_texture_tile_absent;
+            }
+            texture.requested_tiles.clear();
+            texture.next_requested_tile = 0;
+
+            size_t request_count{std::min(texture.missing_tiles.size(), texture.requested_tiles.capacity())};
+            for (size_t i = 0; i < request_count; ++i) {
+                uint64_t key{texture.missing_tiles[i]};
+                unsigned int tile_level, x, y;
+                utilities::split_virtual_texture_tile_key(key, tile_level, x, y);
+                utilities::get_virtual_texture_tile_slot(texture, tile_level, x, y) = virtual_texture_tile_requested;
+                texture.requested_tiles.push_back(key);
+            }
+            utilities::schedule_virtual_texture_loads(texture);
+        }
+
+        utilities::bind_texture(previous_target != 0 ? previous_target : GL_TEXTURE_2D, previous_texture);
     }
 
-    static void set_key_down_event_handler(std::function<void(int)> event_handler)
+    static void set_virtual_texture_current(VirtualTexture *texture, unsigned int first_sampler = 0)
     {
-        data::key_down_event_handler = std::move(event_handler);
+        set_texture_current(texture != nullptr ? &texture->indirection_texture : nullptr, first_sampler);
+        set_texture_current(texture != nullptr ? &texture->atlas_texture : nullptr, first_sampler + 1);
     }
 
-    static void set_keys_down_event_handler(std::function<void(const uint8_t *)> event_handler)
+    // Declares texture_samplers; uv covers the image in [0, 1]. Insert it after the #version line.
+    static std::string get_virtual_texture_shader_source(const VirtualTexture &texture, unsigned int first_sampler = 0)
     {
-        data::keys_down_event_handler = std::move(event_handler);
+        float virtual_size{static_cast<float>(texture.tiles_per_side * texture.tile_size)};
+
+        std::ostringstream source;
+        source.imbue(std::locale::classic());
+        source << std::fixed << std::setprecision(8)
+               << "uniform sampler2D texture_samplers[" << first_sampler + 2 << "];\n"
+               << "const vec2 virtual_texture_scale = vec2("
+                   << static_cast<float>(texture.width) / virtual_size << ", "
+                   << static_cast<float>(texture.height) / virtual_size << ");\n"
+               << "const float virtual_texture_size = " << virtual_size << ";\n"
+               << "const float virtual_texture_tiles = " << static_cast<float>(texture.tiles_per_side) << ";\n"
+               << "const float virtual_texture_max_level = " << static_cast<float>(texture.level_count - 1) << ";\n"
+               << "const float virtual_texture_tile_size = " << static_cast<float>(texture.tile_size) << ";\n"
+               << "const float virtual_texture_padded_tile_size = " << static_cast<float>(texture.padded_tile_size) << ";\n"
+               << "const float virtual_texture_atlas_size = "
+                   << static_cast<float>(texture.atlas_tiles_per_side * texture.padded_tile_size) << ";\n"
+               << R"(
+vec4 sample_virtual_texture(vec2 uv)
+{
+    vec2 virtual_uv = uv * virtual_texture_scale;
+    vec2 texel_position = virtual_uv * virtual_texture_size;
+    vec2 dx = dFdx(texel_position);
+    vec2 dy = dFdy(texel_position);
+    float level = clamp(floor(0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0))), 0.0, virtual_texture_max_level);
+
+)"
+               << "    vec4 entry = floor(textureLod(texture_samplers[" << first_sampler << "], virtual_uv, level) * 255.0 + 0.5);\n"
+               << R"(    if (entry.a < 0.5) {
+        return vec4(0.0);
     }
 
-    static void process_window_events(bool *should_stop)
-    {
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                *should_stop = true;
-            } else if (event.type == SDL_KEYDOWN) {
-                data::key_down_event_handler(event.key.keysym.sym);
-            }
-            data::keys_down_event_handler(SDL_GetKeyboardState(nullptr));
+    vec2 tile_uv = fract(virtual_uv * (virtual_texture_tiles / exp2(entry.b)));
+    vec2 atlas_position = entry.rg * virtual_texture_padded_tile_size +
+                          )" << static_cast<float>(virtual_texture_tile_border) << R"( + tile_uv * virtual_texture_tile_size;
+)"
+               << "    return textureLod(texture_samplers[" << first_sampler + 1 << "], atlas_position / virtual_texture_atlas_size, 0.0);\n"
+               << "}\n";
 
-            data::mouse_state = SDL_GetMouseState(&data::mouse_x, &data::mouse_y);
-        }
+        return source.str();
     }
 
-    static void destroy_window()
+    static void destroy_virtual_texture(VirtualTexture &texture)
     {
-        SDL_GL_DeleteContext(data::gl_context);
-
-        SDL_DestroyWindow(data::window);
-        data::window = nullptr;
+        utilities::stop_virtual_texture_loaders(texture);
 
-        SDL_Quit();
+        destroy_texture(texture.atlas_texture);
+        destroy_texture(texture.indirection_texture);
     }
 
     /*
-     * Shader Handling
+     * Archives
+     *
+     * Archives pack pre-decoded textures with their mip chains and geometry buffers into one file. The file is
+     * mapped into memory and OpenGL reads the data straight from the mapping, so nothing is decoded or copied
+     * at load time. Archives are written ahead of time with an ArchiveBuilder, see the asr_pack tool.
      */
 
-    static void create_shader_program(const char *vertex_shader_source, const char *fragment_shader_source)
+    static std::shared_ptr<Archive> open_archive(const std::string &path)
     {
-        GLint status;
+        auto archive = std::make_shared<Archive>();
+        archive->path = path;
 
-        GLuint vertex_shader_object = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex_shader_object, 1, static_cast<const GLchar **>(&vertex_shader_source), nullptr);
-        glCompileShader(vertex_shader_object);
-        glGetShaderiv(vertex_shader_object, GL_COMPILE_STATUS, &status);
-        if (status == GL_FALSE) {
-            GLint info_log_length;
-            glGetShaderiv(vertex_shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
-            if (info_log_length > 0) {
-                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+        std::string error;
+        if (!utilities::map_file(path, archive->file, error) || !utilities::validate_archive(*archive, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
 
-                glGetShaderInfoLog(vertex_shader_object, info_log_length, nullptr, info_log);
-                std::cerr << "Failed to compile a vertex shader" << std::endl
-                          << "Compilation log:\n" << info_log << std::endl << std::endl;
+        archive->header = reinterpret_cast<const ArchiveHeader *>(archive->file.data);
+        archive->entries =
+            reinterpret_cast<const ArchiveEntry *>(archive->file.data + archive->header->table_of_contents_offset);
 
-                delete[] info_log;
-            }
+        return archive;
+    }
+
+    static bool has_archive_entry(const Archive &archive, const std::string &name)
+    {
+        return utilities::find_archive_entry(archive, name, ArchiveTexture) != nullptr ||
+               utilities::find_archive_entry(archive, name, ArchiveGeometry) != nullptr;
+    }
+
+    static Texture generate_texture(const Archive &archive, const std::string &name)
+    {
+        const ArchiveEntry *entry = utilities::find_archive_entry(archive, name, ArchiveTexture);
+        if (!entry) {
+            std::cerr << "The archive has no texture named '" << name << "': '" << archive.path << "'" << std::endl;
+            std::exit(-1);
         }
 
-        GLuint fragment_shader_object = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment_shader_object, 1, static_cast<const GLchar **>(&fragment_shader_source), nullptr);
-        glCompileShader(fragment_shader_object);
-        glGetShaderiv(fragment_shader_object, GL_COMPILE_STATUS, &status);
-        if (status == GL_FALSE) {
-            GLint info_log_length;
-            glGetShaderiv(fragment_shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
-            if (info_log_length > 0) {
-                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+        ASR_TRACE_SCOPE("generate_texture_from_archive");
 
-                glGetShaderInfoLog(fragment_shader_object, info_log_length, nullptr, info_log);
-                std::cerr << "Failed to compile a fragment shader" << std::endl
-                          << "Compilation log:\n" << info_log << std::endl;
+        Texture texture;
+        texture.memory_owner = utilities::get_current_memory_owner();
+        texture.width = entry->width;
+        texture.height = entry->height;
+        texture.channels = entry->channels;
+        texture.bgr_order = entry->bgr_order != 0;
+        if (entry->section_count > 1) {
+            texture.minification_filter = LinearMipmapLinear;
+        }
 
-                delete[] info_log;
-            }
+        utilities::prefetch_mapped_range(archive.file, entry->offset, entry->size);
+
+        glGenTextures(1, &texture.texture_object);
+        utilities::bind_texture(GL_TEXTURE_2D, texture.texture_object);
+        utilities::apply_texture_parameters(texture);
+        utilities::set_texture_parameter(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(entry->section_count - 1));
+
+        GLint internal_format = utilities::get_internal_pixel_format(texture.channels);
+        GLenum format = utilities::get_pixel_format(texture.channels, texture.bgr_order);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        unsigned int width{texture.width};
+        unsigned int height{texture.height};
+        for (uint32_t level = 0; level < entry->section_count; ++level) {
+            const uint8_t *pixels = archive.file.data + entry->offset + entry->section_offsets[level];
+            utilities::count_uploaded_bytes(entry->section_sizes[level]);
+            glTexImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(level), internal_format,
+                static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                0, format, GL_UNSIGNED_BYTE,
+                reinterpret_cast<const GLvoid *>(pixels)
+            );
+
+            width = std::max(1u, width / 2);
+            height = std::max(1u, height / 2);
         }
 
-        data::shader_program = glCreateProgram();
-        glAttachShader(data::shader_program, vertex_shader_object);
-        glAttachShader(data::shader_program, fragment_shader_object);
-        glLinkProgram(data::shader_program);
-        glGetProgramiv(data::shader_program, GL_LINK_STATUS, &status);
-        if (status == GL_FALSE) {
-            GLint info_log_length;
-            glGetProgramiv(data::shader_program, GL_INFO_LOG_LENGTH, &info_log_length);
-            if (info_log_length > 0) {
-                auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
+        utilities::bind_texture(GL_TEXTURE_2D, 0);
 
-                glGetProgramInfoLog(data::shader_program, info_log_length, nullptr, info_log);
-                std::cerr << "Failed to link a shader program" << std::endl
-                          << "Linker log:\n" << info_log << std::endl;
+        texture.memory_size =
+            utilities::calculate_texture_memory_size(texture.width, texture.height, texture.channels, entry->section_count > 1);
+        utilities::account_memory(Textures, texture.memory_owner, static_cast<int64_t>(texture.memory_size));
 
-                delete[] info_log;
-            }
+        return texture;
+    }
+
+    static Geometry generate_geometry(const Archive &archive, const std::string &name)
+    {
+        const ArchiveEntry *entry = utilities::find_archive_entry(archive, name, ArchiveGeometry);
+        if (!entry) {
+            std::cerr << "The archive has no geometry named '" << name << "': '" << archive.path << "'" << std::endl;
+            std::exit(-1);
         }
 
-        glDetachShader(data::shader_program, vertex_shader_object);
-        glDetachShader(data::shader_program, fragment_shader_object);
-        glDeleteShader(vertex_shader_object);
-        glDeleteShader(fragment_shader_object);
+        ASR_TRACE_SCOPE("generate_geometry_from_archive");
+
+        Geometry geometry{};
+        geometry.type = static_cast<GeometryType>(entry->geometry_type);
+        geometry.vertex_count = entry->index_count;
+        geometry.memory_owner = utilities::get_current_memory_owner();
+
+        utilities::prefetch_mapped_range(archive.file, entry->offset, entry->size);
+        const uint8_t *payload = archive.file.data + entry->offset;
+        utilities::upload_geometry_buffers(
+            geometry,
+            reinterpret_cast<const Vertex *>(payload + entry->section_offsets[0]), entry->vertex_count,
+            reinterpret_cast<const unsigned int *>(payload + entry->section_offsets[1]), entry->index_count
+        );
+        utilities::configure_vertex_array(geometry);
 
-        data::position_attribute_location =
-            glGetAttribLocation(data::shader_program, "position");
-        data::color_attribute_location =
-            glGetAttribLocation(data::shader_program, "color");
-        data::texture_coordinates_attribute_location =
-            glGetAttribLocation(data::shader_program, "texture_coordinates");
-
-        data::resolution_uniform_location =
-            glGetUniformLocation(data::shader_program, "resolution");
-        data::mouse_uniform_location =
-            glGetUniformLocation(data::shader_program, "mouse");
-
-        data::time_uniform_location =
-            glGetUniformLocation(data::shader_program, "time");
-        data::dt_uniform_location =
-            glGetUniformLocation(data::shader_program, "get_dt");
-
-        data::texture_enabled_uniform_location =
-            glGetUniformLocation(data::shader_program, "texture_enabled");
-        data::texture_transformation_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "texture_transformation_matrix");
-        data::texturing_mode_uniform_location =
-            glGetUniformLocation(data::shader_program, "texturing_mode");
-        data::texture_sampler_uniform_location =
-            glGetUniformLocation(data::shader_program, "texture_sampler");
-
-        data::model_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "model_matrix");
-        data::view_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "view_matrix");
-        data::model_view_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "model_view_matrix");
-        data::projection_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "projection_matrix");
-        data::view_projection_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "view_projection_matrix");
-        data::mvp_matrix_uniform_location =
-            glGetUniformLocation(data::shader_program, "model_view_projection_matrix");
+        return geometry;
     }
 
-    static void destroy_shader_program()
+    static void close_archive(Archive &archive)
     {
-        glUseProgram(0);
-        glDeleteProgram(data::shader_program);
-        data::shader_program = 0;
+        utilities::unmap_file(archive.file);
+        archive.header = nullptr;
+        archive.entries = nullptr;
+    }
+
+    static void add_archive_texture(ArchiveBuilder &builder, const std::string &name, const Image &image, bool generate_mipmaps = false)
+    {
+        assert(image.channels >= 1 && image.channels <= 4);
+
+        ArchiveEntry &entry = utilities::add_archive_entry(builder, name, ArchiveTexture);
+        entry.width = image.width;
+        entry.height = image.height;
+        entry.channels = image.channels;
+        entry.bgr_order = image.bgr_order ? 1 : 0;
+
+        auto &sections = builder.sections.back();
+        builder.owned_data.emplace_back(image.pixel_data.begin(), image.pixel_data.end());
+        sections.emplace_back(builder.owned_data.back().data(), builder.owned_data.back().size());
+
+        unsigned int width{image.width};
+        unsigned int height{image.height};
+        while (generate_mipmaps && (width > 1 || height > 1) && sections.size() < archive_max_sections) {
+            const uint8_t *source = sections.back().first;
+            unsigned int next_width{std::max(1u, width / 2)};
+            unsigned int next_height{std::max(1u, height / 2)};
+
+            builder.owned_data.emplace_back(static_cast<size_t>(next_width) * next_height * image.channels);
+            utilities::downsample_archive_image(source, width, height, image.channels, builder.owned_data.back().data());
+            sections.emplace_back(builder.owned_data.back().data(), builder.owned_data.back().size());
+
+            width = next_width;
+            height = next_height;
+        }
+    }
+
+    static void add_archive_geometry(
+                    ArchiveBuilder &builder,
+                    const std::string &name,
+                    GeometryType type,
+                    const std::vector<Vertex> &vertices,
+                    const std::vector<unsigned int> &indices
+                )
+    {
+        ArchiveEntry &entry = utilities::add_archive_entry(builder, name, ArchiveGeometry);
+        entry.geometry_type = static_cast<uint32_t>(type);
+        entry.vertex_count = static_cast<uint32_t>(vertices.size());
+        entry.index_count = static_cast<uint32_t>(indices.size());
+
+        auto &sections = builder.sections.back();
+        const auto *vertex_data = reinterpret_cast<const uint8_t *>(vertices.data());
+        builder.owned_data.emplace_back(vertex_data, vertex_data + vertices.size() * sizeof(Vertex));
+        sections.emplace_back(builder.owned_data.back().data(), builder.owned_data.back().size());
+
+        const auto *index_data = reinterpret_cast<const uint8_t *>(indices.data());
+        builder.owned_data.emplace_back(index_data, index_data + indices.size() * sizeof(unsigned int));
+        sections.emplace_back(builder.owned_data.back().data(), builder.owned_data.back().size());
+    }
+
+    static void write_archive(const ArchiveBuilder &builder, const std::string &path)
+    {
+        std::ofstream file_stream{path, std::ios::binary | std::ios::trunc};
+        if (!file_stream.is_open()) {
+            std::cerr << "Failed to open the file for writing: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
 
-        data::position_attribute_location = -1;
-        data::color_attribute_location = -1;
-        data::time_uniform_location = -1;
+        static const char padding[archive_alignment]{};
+        uint64_t position{0};
+        auto write = [&](const void *bytes, uint64_t size) {
+            file_stream.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(size));
+            position += size;
+        };
+        auto pad = [&]() {
+            write(padding, utilities::align_archive_offset(position) - position);
+        };
+
+        ArchiveHeader header{};
+        std::memcpy(header.magic, archive_magic, sizeof(archive_magic));
+        header.version = archive_version;
+        header.entry_count = static_cast<uint32_t>(builder.entries.size());
+        write(&header, sizeof(header));
+
+        std::vector<ArchiveEntry> entries{builder.entries};
+        for (size_t i = 0; i < entries.size(); ++i) {
+            ArchiveEntry &entry = entries[i];
+            const auto &sections = builder.sections[i];
+
+            pad();
+            entry.offset = position;
+            entry.section_count = static_cast<uint32_t>(sections.size());
+            for (size_t section = 0; section < sections.size(); ++section) {
+                pad();
+                entry.section_offsets[section] = position - entry.offset;
+                entry.section_sizes[section] = sections[section].second;
+                write(sections[section].first, sections[section].second);
+            }
+            entry.size = position - entry.offset;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const ArchiveEntry &a, const ArchiveEntry &b) {
+            return std::strncmp(a.name, b.name, archive_entry_name_size) < 0;
+        });
+
+        pad();
+        header.table_of_contents_offset = position;
+        write(entries.data(), entries.size() * sizeof(ArchiveEntry));
+
+        file_stream.seekp(0);
+        file_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (!file_stream.good()) {
+            std::cerr << "Failed to write the archive: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
     }
 
     /*
-     * Geometry Handling
+     * Geometry Files
+     *
+     * Generated or imported geometry is saved once and loaded on later runs without rebuilding it. Uncompressed
+     * files are mapped and uploaded from the mapping; LZ4 files trade a little CPU for less disk traffic and are
+     * decompressed on all cores.
      */
 
-    static Geometry generate_geometry(GeometryType type, std::vector<Vertex> vertices, std::vector<unsigned int> indices)
+    static void write_geometry_file(
+                    const std::string &path,
+                    GeometryType type,
+                    const std::vector<Vertex> &vertices,
+                    const std::vector<unsigned int> &indices,
+                    GeometryFileCompression compression = UncompressedGeometryFile
+                )
     {
-        Geometry geometry{};
+        ASR_TRACE_SCOPE("write_geometry_file");
 
-        geometry.vertex_count = indices.size();
-        geometry.type = type;
+        std::ofstream file_stream{path, std::ios::binary | std::ios::trunc};
+        if (!file_stream.is_open()) {
+            std::cerr << "Failed to open the file for writing: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
 
-        GLuint vertex_array_object{0};
-        GLuint vertex_buffer_object{0};
-        GLuint index_buffer_object{0};
+        GeometryFileHeader header =
+            utilities::make_geometry_file_header(type, vertices.data(), vertices.size(), indices.size());
+        header.compression = compression;
+
+        uint64_t vertex_data_size{vertices.size() * sizeof(Vertex)};
+        uint64_t index_data_size{indices.size() * sizeof(unsigned int)};
+        header.vertex_data_offset = compression == UncompressedGeometryFile ? sizeof(GeometryFileHeader) : 0;
+        header.index_data_offset =
+            (header.vertex_data_offset + vertex_data_size + geometry_file_alignment - 1) / geometry_file_alignment * geometry_file_alignment;
+
+        static const char padding[geometry_file_alignment]{};
+        if (compression == UncompressedGeometryFile) {
+            file_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file_stream.write(padding, static_cast<std::streamsize>(header.vertex_data_offset - sizeof(header)));
+            file_stream.write(reinterpret_cast<const char *>(vertices.data()), static_cast<std::streamsize>(vertex_data_size));
+            file_stream.write(padding, static_cast<std::streamsize>(header.index_data_offset - header.vertex_data_offset - vertex_data_size));
+            file_stream.write(reinterpret_cast<const char *>(indices.data()), static_cast<std::streamsize>(index_data_size));
+        } else {
+            uint64_t stream_size{header.index_data_offset + index_data_size};
+            std::vector<uint8_t> stream(static_cast<size_t>(stream_size), 0);
+            std::memcpy(stream.data(), vertices.data(), static_cast<size_t>(vertex_data_size));
+            std::memcpy(stream.data() + header.index_data_offset, indices.data(), static_cast<size_t>(index_data_size));
+
+            header.chunk_count = static_cast<uint32_t>((stream_size + geometry_file_chunk_size - 1) / geometry_file_chunk_size);
+            header.chunk_table_offset = sizeof(header);
+
+            std::vector<GeometryFileChunk> chunks(header.chunk_count);
+            std::vector<std::vector<uint8_t>> compressed_chunks(header.chunk_count);
+            utilities::run_parallel_tasks(header.chunk_count, [&](size_t i) {
+                size_t chunk_offset{i * geometry_file_chunk_size};
+                size_t chunk_size{static_cast<size_t>(std::min<uint64_t>(geometry_file_chunk_size, stream_size - chunk_offset))};
+
+                std::vector<uint8_t> &compressed = compressed_chunks[i];
+                compressed.resize(chunk_size);
+                size_t compressed_size{
+                    utilities::compress_lz4_block(stream.data() + chunk_offset, chunk_size, compressed.data(), chunk_size - 1)
+                };
+                if (compressed_size == 0) {
+                    std::memcpy(compressed.data(), stream.data() + chunk_offset, chunk_size);
+                    compressed_size = chunk_size;
+                }
+                compressed.resize(compressed_size);
+
+                chunks[i].compressed_size = static_cast<uint32_t>(compressed_size);
+                chunks[i].size = static_cast<uint32_t>(chunk_size);
+            });
+
+            uint64_t offset{header.chunk_table_offset + chunks.size() * sizeof(GeometryFileChunk)};
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                chunks[i].offset = offset;
+                offset += chunks[i].compressed_size;
+            }
 
-#ifdef __APPLE__
-        glGenVertexArraysAPPLE(1, &vertex_array_object);
-        glBindVertexArrayAPPLE(vertex_array_object);
-#else
-        glGenVertexArrays(1, &vertex_array_object);
-        glBindVertexArray(vertex_array_object);
-#endif
-        geometry.vertex_array_object = static_cast<int>(vertex_array_object);
-
-        glGenBuffers(1, &vertex_buffer_object);
-        geometry.vertex_buffer_object = static_cast<int>(vertex_buffer_object);
-        glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            vertices.size() * 9 * sizeof(float),
-            reinterpret_cast<const float *>(vertices.data()),
-            GL_STATIC_DRAW
-        );
+            file_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file_stream.write(reinterpret_cast<const char *>(chunks.data()), static_cast<std::streamsize>(chunks.size() * sizeof(GeometryFileChunk)));
+            for (const auto &compressed : compressed_chunks) {
+                file_stream.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+            }
+        }
 
-        glGenBuffers(1, &index_buffer_object);
-        geometry.index_buffer_object = static_cast<int>(index_buffer_object);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
-        glBufferData(
-            GL_ELEMENT_ARRAY_BUFFER,
-            indices.size() * sizeof(unsigned int),
-            reinterpret_cast<const unsigned int *>(indices.data()),
-            GL_STATIC_DRAW
-        );
+        if (!file_stream.good()) {
+            std::cerr << "Failed to write the geometry file: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
+    }
 
-        GLsizei stride = sizeof(GLfloat) * 9;
-        glEnableVertexAttribArray(data::position_attribute_location);
-        glVertexAttribPointer(
-            data::position_attribute_location,
-            3, GL_FLOAT, GL_FALSE, stride, static_cast<const GLvoid *>(nullptr)
-        );
-        glEnableVertexAttribArray(data::color_attribute_location);
-        glVertexAttribPointer(
-            data::color_attribute_location,
-            4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 3)
-        );
-        glEnableVertexAttribArray(data::texture_coordinates_attribute_location);
-        glVertexAttribPointer(
-            data::texture_coordinates_attribute_location,
-            2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 7)
-        );
+    static Geometry load_geometry_file(const std::string &path, GeometryBounds *bounds = nullptr)
+    {
+        ASR_TRACE_SCOPE("load_geometry_file");
 
-#ifdef __APPLE__
-        glBindVertexArrayAPPLE(0);
-#else
-        glBindVertexArray(0);
-#endif
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        MappedFile file;
+        std::string error;
+        if (!utilities::map_file(path, file, error) || !utilities::validate_geometry_file(file, path, error)) {
+            utilities::unmap_file(file);
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
+
+        const auto *header = reinterpret_cast<const GeometryFileHeader *>(file.data);
+        if (bounds) {
+            bounds->minimum = glm::vec3{header->bounds_minimum[0], header->bounds_minimum[1], header->bounds_minimum[2]};
+            bounds->maximum = glm::vec3{header->bounds_maximum[0], header->bounds_maximum[1], header->bounds_maximum[2]};
+        }
+
+        auto type = static_cast<GeometryType>(header->geometry_type);
+        Geometry geometry{};
+        if (header->compression == UncompressedGeometryFile) {
+            utilities::prefetch_mapped_range(file, 0, file.size);
+            geometry = generate_geometry(
+                type,
+                reinterpret_cast<const Vertex *>(file.data + header->vertex_data_offset), header->vertex_count,
+                reinterpret_cast<const unsigned int *>(file.data + header->index_data_offset), header->index_count
+            );
+        } else {
+            utilities::GeometryFileData stream(
+                static_cast<size_t>(header->index_data_offset + static_cast<uint64_t>(header->index_count) * sizeof(unsigned int))
+            );
+            const auto *chunks = reinterpret_cast<const GeometryFileChunk *>(file.data + header->chunk_table_offset);
+
+            std::atomic<bool> failed{false};
+            utilities::run_parallel_tasks(header->chunk_count, [&](size_t i) {
+                const GeometryFileChunk &chunk = chunks[i];
+                uint8_t *destination = stream.data() + i * geometry_file_chunk_size;
+                if (chunk.compressed_size == chunk.size) {
+                    std::memcpy(destination, file.data + chunk.offset, chunk.size);
+                } else if (!utilities::decompress_lz4_block(file.data + chunk.offset, chunk.compressed_size, destination, chunk.size)) {
+                    failed = true;
+                }
+            });
+            if (failed) {
+                utilities::unmap_file(file);
+                std::cerr << "The geometry file is corrupted: '" << path << "'" << std::endl;
+                std::exit(-1);
+            }
+
+            geometry = generate_geometry(
+                type,
+                reinterpret_cast<const Vertex *>(stream.data()), header->vertex_count,
+                reinterpret_cast<const unsigned int *>(stream.data() + header->index_data_offset), header->index_count
+            );
+        }
+
+        utilities::unmap_file(file);
 
         return geometry;
     }
 
-    static void set_geometry_current(Geometry *geometry)
+    /*
+     * Geometry Importing
+     *
+     * OBJ and PLY files are mapped and parsed in chunks on all cores. Polygons are triangulated as fans, and
+     * vertices without colors are white. Normals are skipped because the vertex format has no room for them.
+     */
+
+    static GeometryData read_obj_file(const std::string &path)
     {
-        data::current_geometry = geometry;
-        if (geometry != nullptr) {
-#ifdef __APPLE__
-            glBindVertexArrayAPPLE(static_cast<GLuint>(geometry->vertex_array_object));
-#else
-            glBindVertexArray(static_cast<GLuint>(geometry->vertex_array_object));
-#endif
+        ASR_TRACE_SCOPE("read_obj_file");
+
+        MappedFile file;
+        std::string error;
+        if (!utilities::map_file(path, file, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
+
+        const auto *text = reinterpret_cast<const char *>(file.data);
+        auto chunk_ranges = utilities::split_into_line_chunks(text, text + file.size);
+        std::vector<ObjChunk> chunks(chunk_ranges.size());
+        utilities::run_parallel_tasks(chunks.size(), [&](size_t i) {
+            utilities::parse_obj_chunk(chunk_ranges[i].first, chunk_ranges[i].second, chunks[i]);
+        });
+        utilities::unmap_file(file);
+
+        std::vector<int64_t> first_positions(chunks.size() + 1, 0);
+        std::vector<int64_t> first_texture_coordinates(chunks.size() + 1, 0);
+        std::vector<size_t> first_indices(chunks.size() + 1, 0);
+        bool has_colors{false};
+        bool has_texture_coordinate_indices{false};
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (chunks[i].failed) {
+                std::cerr << "Invalid OBJ data: '" << path << "'" << std::endl;
+                std::exit(-1);
+            }
+            first_positions[i + 1] = first_positions[i] + static_cast<int64_t>(chunks[i].positions.size() / 3);
+            first_texture_coordinates[i + 1] =
+                first_texture_coordinates[i] + static_cast<int64_t>(chunks[i].texture_coordinates.size() / 2);
+            first_indices[i + 1] = first_indices[i] + chunks[i].position_indices.size();
+            has_colors = has_colors || chunks[i].has_colors;
+        }
+        int64_t position_count{first_positions.back()};
+        int64_t texture_coordinate_count{first_texture_coordinates.back()};
+
+        std::atomic<bool> failed{false};
+        utilities::run_parallel_tasks(chunks.size(), [&](size_t i) {
+            auto resolve = [](int64_t index, int64_t first, int64_t count) {
+                if (index >= obj_relative_index_bias / 2) index = index - obj_relative_index_bias + first;
+                return index >= 0 && index < count ? index : -1;
+            };
+            for (size_t corner = 0; corner < chunks[i].position_indices.size(); ++corner) {
+                int64_t &position = chunks[i].position_indices[corner];
+                int64_t &texture_coordinate = chunks[i].texture_coordinate_indices[corner];
+                position = resolve(position, first_positions[i], position_count);
+                if (position < 0) failed = true;
+                if (texture_coordinate >= 0) {
+                    texture_coordinate = resolve(texture_coordinate, first_texture_coordinates[i], texture_coordinate_count);
+                    if (texture_coordinate < 0) failed = true;
+                }
+            }
+        });
+        if (failed) {
+            std::cerr << "An OBJ face refers to a missing vertex: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
+
+        // Only files that split vertices need the slower pairing.
+        bool positions_are_vertices{true};
+        for (const auto &chunk : chunks) {
+            for (size_t corner = 0; corner < chunk.position_indices.size() && positions_are_vertices; ++corner) {
+                int64_t texture_coordinate{chunk.texture_coordinate_indices[corner]};
+                has_texture_coordinate_indices = has_texture_coordinate_indices || texture_coordinate >= 0;
+                positions_are_vertices = texture_coordinate < 0 || texture_coordinate == chunk.position_indices[corner];
+            }
+        }
+
+        auto make_vertex = [&](int64_t position, int64_t texture_coordinate) {
+            auto chunk_index = static_cast<size_t>(
+                std::upper_bound(first_positions.begin(), first_positions.end(), position) - first_positions.begin() - 1
+            );
+            const ObjChunk &chunk = chunks[chunk_index];
+            auto local = static_cast<size_t>(position - first_positions[chunk_index]) * 3;
+
+            Vertex vertex{
+                chunk.positions[local], chunk.positions[local + 1], chunk.positions[local + 2],
+                1.0f, 1.0f, 1.0f, 1.0f,
+                0.0f, 0.0f
+            };
+            if (has_colors) {
+                vertex.r = chunk.colors[local];
+                vertex.g = chunk.colors[local + 1];
+                vertex.b = chunk.colors[local + 2];
+            }
+            if (texture_coordinate >= 0) {
+                auto texture_chunk_index = static_cast<size_t>(
+                    std::upper_bound(first_texture_coordinates.begin(), first_texture_coordinates.end(), texture_coordinate) -
+                    first_texture_coordinates.begin() - 1
+                );
+                const ObjChunk &texture_chunk = chunks[texture_chunk_index];
+                auto texture_local = static_cast<size_t>(texture_coordinate - first_texture_coordinates[texture_chunk_index]) * 2;
+                vertex.u = texture_chunk.texture_coordinates[texture_local];
+                vertex.v = texture_chunk.texture_coordinates[texture_local + 1];
+            }
+
+            return vertex;
+        };
+
+        GeometryData geometry_data;
+        if (positions_are_vertices) {
+            bool use_texture_coordinates{has_texture_coordinate_indices && texture_coordinate_count >= position_count};
+            geometry_data.first.resize(static_cast<size_t>(position_count));
+            geometry_data.second.resize(first_indices.back());
+            utilities::run_parallel_tasks(chunks.size(), [&](size_t i) {
+                for (int64_t position = first_positions[i]; position < first_positions[i + 1]; ++position) {
+                    geometry_data.first[static_cast<size_t>(position)] = make_vertex(position, use_texture_coordinates ? position : -1);
+                }
+                std::transform(
+                    chunks[i].position_indices.begin(), chunks[i].position_indices.end(),
+                    geometry_data.second.begin() + static_cast<std::ptrdiff_t>(first_indices[i]),
+                    [](int64_t index) { return static_cast<unsigned int>(index); }
+                );
+            });
         } else {
-#ifdef __APPLE__
-            glBindVertexArrayAPPLE(0);
-#else
-            glBindVertexArray(0);
-#endif
+            std::unordered_map<uint64_t, unsigned int> vertex_indices;
+            geometry_data.second.reserve(first_indices.back());
+            for (const auto &chunk : chunks) {
+                for (size_t corner = 0; corner < chunk.position_indices.size(); ++corner) {
+                    int64_t position{chunk.position_indices[corner]};
+                    int64_t texture_coordinate{chunk.texture_coordinate_indices[corner]};
+                    uint64_t key{static_cast<uint64_t>(position) << 32 | static_cast<uint32_t>(texture_coordinate)};
+
+                    auto [entry, inserted] =
+                        vertex_indices.emplace(key, static_cast<unsigned int>(geometry_data.first.size()));
+                    if (inserted) {
+                        geometry_data.first.push_back(make_vertex(position, texture_coordinate));
+                    }
+                    geometry_data.second.push_back(entry->second);
+                }
+            }
         }
+
+        return geometry_data;
     }
 
-    static void destroy_geometry(Geometry &geometry)
+    static GeometryData read_ply_file(const std::string &path)
     {
-        GLuint vertex_array_object{static_cast<GLuint>(geometry.vertex_array_object)};
-        GLuint vertex_buffer_object{static_cast<GLuint>(geometry.vertex_buffer_object)};
-        GLuint index_buffer_object{static_cast<GLuint>(geometry.index_buffer_object)};
+        ASR_TRACE_SCOPE("read_ply_file");
 
-#ifdef __APPLE__
-        glBindVertexArrayAPPLE(0);
-        glDeleteVertexArraysAPPLE(1, &vertex_array_object);
-#else
-        glBindVertexArray(0);
-        glDeleteVertexArrays(1, &vertex_array_object);
-#endif
-        geometry.vertex_array_object = 0;
+        MappedFile file;
+        std::string error;
+        if (!utilities::map_file(path, file, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDeleteBuffers(1, &vertex_buffer_object);
-        geometry.vertex_buffer_object = 0;
+        const auto *text = reinterpret_cast<const char *>(file.data);
+        const char *body = text;
+        PlyFormat format{PlyAscii};
+        std::vector<PlyElement> elements;
+        if (!utilities::read_ply_header(body, text + file.size, format, elements, error)) {
+            utilities::unmap_file(file);
+            std::cerr << error << ": '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glDeleteBuffers(1, &index_buffer_object);
-        geometry.index_buffer_object = 0;
-    }
+        GeometryData geometry_data;
+        for (const auto &element : elements) {
+            if (element.name == "vertex") {
+                geometry_data.first.assign(element.count, Vertex{0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f});
+            }
+        }
 
-    /*
-     * Texture Handling
-     */
+        bool valid;
+        if (format == PlyAscii) {
+            valid = utilities::read_ply_ascii_body(body, text + file.size, elements, geometry_data);
+        } else {
+            valid = utilities::read_ply_binary_body(
+                reinterpret_cast<const uint8_t *>(body), file.data + file.size, elements,
+                format == PlyBinaryBigEndian, geometry_data
+            );
+        }
+        utilities::unmap_file(file);
+
+        if (!valid) {
+            std::cerr << "Invalid or truncated PLY data: '" << path << "'" << std::endl;
+            std::exit(-1);
+        }
+
+        return geometry_data;
+    }
 
-    static Texture generate_texture(Image &image, bool generate_mipmaps = false)
+    static GeometryData read_geometry_file(const std::string &path)
     {
-        Texture texture;
+        std::string extension{path.substr(std::min(path.size(), path.rfind('.') + 1))};
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) {
+            return static_cast<char>(std::tolower(character));
+        });
 
-        texture.width = image.width;
-        texture.height = image.height;
-        texture.channels = image.channels;
-
-        glGenTextures(1, &texture.texture_object);
-        glBindTexture(GL_TEXTURE_2D, texture.texture_object);
+        if (extension == "obj") return read_obj_file(path);
+        if (extension == "ply") return read_ply_file(path);
 
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
-            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(texture.wrap_mode_u)
-        );
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
-            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(texture.wrap_mode_v)
-        );
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-            utilities::convert_filter_type_to_es2_texture_filter_type(texture.magnification_filter)
-        );
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-            utilities::convert_filter_type_to_es2_texture_filter_type(texture.minification_filter)
-        );
-        glTexParameterf(
-            GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-            static_cast<GLfloat>(texture.anisotropy)
-        );
+        std::cerr << "Unsupported geometry file format: '" << path << "'" << std::endl;
+        std::exit(-1);
+    }
 
-        GLint format = texture.channels == 3 ? GL_RGB : GL_RGBA;
+    /*
+     * Memory Accounting
+     */
 
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, format,
-            static_cast<GLsizei>(texture.width),
-            static_cast<GLsizei>(texture.height),
-            0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
-            reinterpret_cast<GLvoid *>(image.pixel_data.data())
-        );
+    static void set_memory_owner(const std::string &owner)
+    {
+        std::lock_guard<std::mutex> lock{data::memory_accounting_mutex};
 
-        if (generate_mipmaps) {
-            glGenerateMipmap(GL_TEXTURE_2D);
+        auto position = std::find(data::memory_owners.begin(), data::memory_owners.end(), owner);
+        if (position == data::memory_owners.end()) {
+            data::memory_owners.push_back(owner);
+            data::memory_usage.emplace_back();
+            position = data::memory_owners.end() - 1;
         }
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        return texture;
+        data::current_memory_owner = static_cast<unsigned int>(position - data::memory_owners.begin());
     }
 
-    static void set_texture_mode(TexturingMode mode)
+    static void reset_memory_owner()
     {
-        assert(data::current_texture);
-
-        data::current_texture->mode = mode;
+        data::current_memory_owner = 0;
     }
 
-    static void set_texture_wrap_mode_u(TextureWrapMode wrap_mode_u)
+    static void account_memory_allocation(MemoryCategory category, size_t bytes)
     {
-        assert(data::current_texture);
+        utilities::account_memory(category, utilities::get_current_memory_owner(), static_cast<int64_t>(bytes));
+    }
 
-        data::current_texture->wrap_mode_u = wrap_mode_u;
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
-            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(wrap_mode_u)
-        );
+    static void account_memory_deallocation(MemoryCategory category, size_t bytes)
+    {
+        utilities::account_memory(category, utilities::get_current_memory_owner(), -static_cast<int64_t>(bytes));
     }
 
-    static void set_texture_wrap_mode_v(TextureWrapMode wrap_mode_v)
+    static std::vector<MemoryUsageRecord> get_memory_usage_snapshot()
     {
-        assert(data::current_texture);
+        std::lock_guard<std::mutex> lock{data::memory_accounting_mutex};
 
-        data::current_texture->wrap_mode_v = wrap_mode_v;
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
-            utilities::convert_wrap_mode_to_es2_texture_wrap_mode(wrap_mode_v)
-        );
+        std::vector<MemoryUsageRecord> snapshot;
+        for (size_t owner = 0; owner < data::memory_owners.size(); ++owner) {
+            MemoryUsageRecord record{data::memory_owners[owner]};
+            for (unsigned int category = 0; category < memory_category_count; ++category) {
+                record.bytes[category] = static_cast<size_t>(std::max<int64_t>(0, data::memory_usage[owner][category]));
+            }
+            snapshot.push_back(record);
+        }
+
+        return snapshot;
     }
 
-    static void set_texture_magnification_filter(TextureFilterType magnification_filter)
+    static size_t get_memory_usage(MemoryCategory category)
     {
-        assert(data::current_texture);
+        size_t total{0};
+        for (const auto &record : get_memory_usage_snapshot()) {
+            total += record.bytes[category];
+        }
 
-        data::current_texture->magnification_filter = magnification_filter;
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-            utilities::convert_filter_type_to_es2_texture_filter_type(magnification_filter)
-        );
+        return total;
     }
 
-    static void set_texture_minification_filter(TextureFilterType minification_filter)
+    static size_t get_memory_usage(const std::string &owner, MemoryCategory category)
     {
-        assert(data::current_texture);
+        for (const auto &record : get_memory_usage_snapshot()) {
+            if (record.owner == owner) return record.bytes[category];
+        }
 
-        data::current_texture->minification_filter = minification_filter;
-        glTexParameteri(
-            GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-            utilities::convert_filter_type_to_es2_texture_filter_type(minification_filter)
-        );
+        return 0;
     }
 
-    static void set_texture_anisotropy(float anisotropy)
+    static size_t get_gpu_memory_usage()
     {
-        assert(data::current_texture);
-
-        data::current_texture->anisotropy = anisotropy;
-        glTexParameterf(
-            GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-            static_cast<GLfloat>(anisotropy)
-        );
+        return get_memory_usage(Buffers) + get_memory_usage(Textures) + get_memory_usage(RenderTargets);
     }
 
-    static void set_texture_current(Texture *texture, unsigned int sampler = 0)
+    static size_t get_cpu_memory_usage()
     {
-        data::current_texture = texture;
-        if (texture != nullptr) {
-            glActiveTexture(GL_TEXTURE0 + sampler);
-            glBindTexture(GL_TEXTURE_2D, texture->texture_object);
-        } else {
-            glBindTexture(GL_TEXTURE_2D, 0);
-        }
+        return get_memory_usage(Images) + get_memory_usage(Pools);
     }
 
-    static void destroy_texture(Texture &texture)
+    static void print_memory_usage(std::ostream &stream = std::cout)
     {
-        glDeleteTextures(1, &texture.texture_object);
-        texture.texture_object = 0;
+        static const char *category_names[memory_category_count]{
+            "Buffers", "Textures", "Render Targets", "Images", "Pools"
+        };
+
+        auto print_row = [&stream](const std::string &owner, const std::array<size_t, memory_category_count> &bytes) {
+            stream << std::left << std::setw(24) << owner << std::right;
+            for (size_t value : bytes) {
+                stream << std::setw(16) << std::fixed << std::setprecision(2)
+                       << static_cast<double>(value) / (1024.0 * 1024.0);
+            }
+            stream << std::endl;
+        };
+
+        stream << std::left << std::setw(24) << "Owner (MiB)" << std::right;
+        for (const char *name : category_names) {
+            stream << std::setw(16) << name;
+        }
+        stream << std::endl;
+
+        std::array<size_t, memory_category_count> totals{};
+        for (const auto &record : get_memory_usage_snapshot()) {
+            print_row(record.owner, record.bytes);
+            for (unsigned int category = 0; category < memory_category_count; ++category) {
+                totals[category] += record.bytes[category];
+            }
+        }
+        print_row("total", totals);
     }
 
     /*
@@ -826,325 +8373,902 @@ namespace asr
         return data::texture_matrix_stack.top();
     }
 
-    static void set_matrix(glm::mat4 matrix)
+    static void set_matrix(glm::mat4 matrix)
+    {
+        data::current_matrix_stack->pop();
+        data::current_matrix_stack->push(matrix);
+    }
+
+    static void load_identity_matrix()
+    {
+        set_matrix(glm::mat4{1.0f});
+    }
+
+    static void load_look_at_matrix(glm::vec3 position, glm::vec3 target)
+    {
+        glm::vec3 up{0.0f, 1.0f, 0.0f};
+        set_matrix(glm::lookAt(position, target, up));
+    }
+
+    static void load_orthographic_projection_matrix(float zoom, float near_plane, float far_plane)
+    {
+        float aspect_ratio{static_cast<float>(data::window_width) / static_cast<float>(data::window_height)};
+
+        float left{-(zoom * aspect_ratio)};
+        float right{zoom * aspect_ratio};
+        float bottom{-zoom};
+        float top{zoom};
+
+        set_matrix(glm::ortho(left, right, bottom, top, near_plane, far_plane));
+    }
+
+    static void load_perspective_projection_matrix(float field_of_view, float near_plane, float far_plane)
+    {
+        float aspect_ratio{static_cast<float>(data::window_width) / static_cast<float>(data::window_height)};
+
+        set_matrix(glm::perspective(field_of_view, aspect_ratio, near_plane, far_plane));
+    }
+
+    static void push_matrix()
+    {
+        glm::mat4 top_matrix = data::current_matrix_stack->top();
+        data::current_matrix_stack->push(top_matrix);
+    }
+
+    static void pop_matrix()
+    {
+        data::current_matrix_stack->pop();
+        if (data::current_matrix_stack->empty()) {
+            data::current_matrix_stack->push(glm::mat4{1.0f});
+        }
+    }
+
+    static void clear_matrices()
+    {
+        while (!data::current_matrix_stack->empty()) data::current_matrix_stack->pop();
+        data::current_matrix_stack->push(glm::mat4{1.0f});
+    }
+
+    /*
+     * Utility Functions
+     */
+
+    static std::string read_text_file(const std::string &path)
+    {
+        std::string text, error;
+        if (!utilities::try_read_text_file(path, text, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
+
+        return text;
+    }
+
+    static void convert_image(Image &image, unsigned int conversions)
+    {
+        if (conversions == NoPixelConversion) return;
+
+        unsigned int channels{utilities::get_converted_channel_count(image.channels, conversions)};
+        if ((conversions & (ExpandToRGBA | FlipVertically)) != 0) {
+            PixelData converted;
+            utilities::resize_uninitialized(converted, static_cast<size_t>(image.width) * image.height * channels);
+            utilities::convert_pixels(
+                image.pixel_data.data(), converted.data(),
+                image.width, image.height, image.channels, conversions
+            );
+            image.pixel_data = std::move(converted);
+        } else {
+            utilities::convert_pixels(
+                image.pixel_data.data(), image.pixel_data.data(),
+                image.width, image.height, image.channels, conversions
+            );
+        }
+
+        image.channels = channels;
+        if ((conversions & SwizzleToBGRA) != 0 && channels >= 3) {
+            image.bgr_order = !image.bgr_order;
+        }
+    }
+
+    static Image read_image_file(const std::string &path, unsigned int conversions = NoPixelConversion)
+    {
+        Image image{};
+        std::string error;
+        if (!utilities::try_read_image_file(path, conversions, image, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
+
+        return image;
+    }
+
+    static float get_time_scale()
+    {
+        return data::time_scale;
+    }
+
+    static void set_time_scale(float time_scale)
+    {
+        data::time_scale = time_scale;
+    }
+
+    static inline float get_dt()
+    {
+        return data::frame_rendering_delta_time * data::time_scale;
+    }
+
+    /*
+     * Rendering
+     */
+
+    static void prepare_for_rendering()
+    {
+        glClearColor(0, 0, 0, 0);
+        utilities::set_viewport(0, 0, static_cast<GLsizei>(data::window_width), static_cast<GLsizei>(data::window_height));
+        utilities::set_capability(GL_PROGRAM_POINT_SIZE, true);
+        utilities::enable_point_sprites();
+        utilities::enable_primitive_restart();
+
+        utilities::reset_matrix_stack(data::model_matrix_stack);
+        utilities::reset_matrix_stack(data::view_matrix_stack);
+        utilities::reset_matrix_stack(data::projection_matrix_stack);
+        utilities::reset_matrix_stack(data::texture_matrix_stack);
+
+        data::rendering_start_time = std::chrono::system_clock::now();
+    }
+
+    static void set_line_width(float line_width)
+    {
+        utilities::set_line_width(static_cast<GLfloat>(line_width));
+    }
+
+    static void enable_face_culling()
+    {
+        utilities::set_capability(GL_CULL_FACE, true);
+        utilities::set_front_face(GL_CCW);
+        utilities::set_cull_face(GL_BACK);
+    }
+
+    static void disable_face_culling()
+    {
+        utilities::set_capability(GL_CULL_FACE, false);
+    }
+
+    static void enable_depth_test()
+    {
+        utilities::set_capability(GL_DEPTH_TEST, true);
+        utilities::set_depth_function(GL_LESS);
+    }
+
+    static void disable_depth_test()
+    {
+        utilities::set_capability(GL_DEPTH_TEST, false);
+    }
+
+    static void enable_polygon_offset(float factor = 1.0f, float units = 1.0f)
+    {
+        utilities::set_capability(GL_POLYGON_OFFSET_FILL, true);
+        utilities::set_polygon_offset(static_cast<GLfloat>(factor), static_cast<GLfloat>(units));
+    }
+
+    static void disable_polygon_offset()
+    {
+        utilities::set_capability(GL_POLYGON_OFFSET_FILL, false);
+    }
+
+    static void enable_blending(BlendingMode mode = AlphaBlending)
+    {
+        utilities::set_capability(GL_BLEND, true);
+        switch (mode) {
+            case AlphaBlending:
+                utilities::set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+            case PremultipliedAlphaBlending:
+                utilities::set_blend_function(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+            case AdditiveBlending:
+                utilities::set_blend_function(GL_SRC_ALPHA, GL_ONE);
+                break;
+        }
+    }
+
+    static void disable_blending()
+    {
+        utilities::set_capability(GL_BLEND, false);
+    }
+
+    static void enable_depth_writes()
+    {
+        utilities::set_depth_writes(true);
+    }
+
+    static void disable_depth_writes()
+    {
+        utilities::set_depth_writes(false);
+    }
+
+    static bool is_order_independent_transparency_supported()
+    {
+        return GLEW_VERSION_3_0;
+    }
+
+    // Called instead of writing gl_FragColor while a transparency pass is active.
+    static std::string get_transparency_shader_source()
+    {
+        return R"(
+void write_transparent_fragment(vec4 color)
+{
+    float weight = clamp(pow(min(1.0, color.a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    gl_FragData[0] = vec4(color.rgb * color.a * weight, color.a);
+    gl_FragData[1] = vec4(color.a * weight);
+}
+)";
+    }
+
+    // Draw the opaque geometry first: the pass is depth tested against it but does not write depth.
+    static void begin_transparency_pass()
+    {
+        ASR_TRACE_GPU_SCOPE("begin_transparency_pass");
+
+        assert(!data::transparency_pass_active);
+        assert(is_order_independent_transparency_supported());
+
+        TransparencyTargets &targets = data::transparency_targets;
+        if (targets.width != data::window_width || targets.height != data::window_height) {
+            utilities::resize_transparency_targets(data::window_width, data::window_height);
+        }
+
+        auto width = static_cast<GLint>(targets.width);
+        auto height = static_cast<GLint>(targets.height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, targets.framebuffer);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, targets.framebuffer);
+
+        static const GLfloat accumulation_clear_value[4]{0.0f, 0.0f, 0.0f, 1.0f};
+        static const GLfloat weight_clear_value[4]{0.0f, 0.0f, 0.0f, 0.0f};
+        glClearBufferfv(GL_COLOR, 0, accumulation_clear_value);
+        glClearBufferfv(GL_COLOR, 1, weight_clear_value);
+
+        data::state_before_transparency_pass = data::gl_state;
+        utilities::set_capability(GL_BLEND, true);
+        utilities::set_blend_function(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+        utilities::set_depth_writes(false);
+
+        data::transparency_pass_active = true;
+    }
+
+    static void end_transparency_pass()
+    {
+        ASR_TRACE_GPU_SCOPE("end_transparency_pass");
+
+        assert(data::transparency_pass_active);
+        data::transparency_pass_active = false;
+
+        TransparencyTargets &targets = data::transparency_targets;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        if (targets.composite_program.program_object == 0) {
+            targets.composite_program = generate_shader_program(
+                R"(
+                    #version 130
+
+                    attribute vec2 position;
+
+                    void main()
+                    {
+                        gl_Position = vec4(position, 0.0, 1.0);
+                    }
+                )",
+                R"(
+                    #version 130
+
+                    uniform sampler2D accumulation_sampler;
+                    uniform sampler2D weight_sampler;
+
+                    void main()
+                    {
+                        ivec2 texel = ivec2(gl_FragCoord.xy);
+                        vec4 accumulation = texelFetch(accumulation_sampler, texel, 0);
+                        float revealage = accumulation.a;
+                        if (revealage >= 1.0) discard;
+
+                        float weight = texelFetch(weight_sampler, texel, 0).r;
+                        gl_FragColor = vec4(accumulation.rgb / max(weight, 1e-5), 1.0 - revealage);
+                    }
+                )"
+            );
+            utilities::use_program(targets.composite_program.program_object);
+            utilities::set_uniform(glGetUniformLocation(targets.composite_program.program_object, "accumulation_sampler"), 0);
+            utilities::set_uniform(glGetUniformLocation(targets.composite_program.program_object, "weight_sampler"), 1);
+
+#ifdef __APPLE__
+            glGenVertexArraysAPPLE(1, &targets.composite_vertex_array);
+#else
+            glGenVertexArrays(1, &targets.composite_vertex_array);
+#endif
+            utilities::bind_vertex_array(targets.composite_vertex_array);
+
+            // One triangle that covers the window. Compatibility contexts draw nothing without an enabled array.
+            static const GLfloat positions[]{-1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f};
+            glGenBuffers(1, &targets.composite_vertex_buffer);
+            utilities::bind_buffer(GL_ARRAY_BUFFER, targets.composite_vertex_buffer);
+            utilities::upload_buffer_data(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
+            glEnableVertexAttribArray(position_attribute_location);
+            glVertexAttribPointer(position_attribute_location, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        }
+
+        const GLStateCache &state = data::state_before_transparency_pass;
+        utilities::set_capability(GL_DEPTH_TEST, false);
+        utilities::set_blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        utilities::use_program(targets.composite_program.program_object);
+        utilities::set_active_texture_unit(0);
+        utilities::bind_texture(GL_TEXTURE_2D, targets.accumulation_texture);
+        utilities::set_active_texture_unit(1);
+        utilities::bind_texture(GL_TEXTURE_2D, targets.weight_texture);
+        utilities::bind_vertex_array(targets.composite_vertex_array);
+
+        utilities::draw_arrays(GL_TRIANGLES, 0, 3);
+
+        utilities::bind_vertex_array(
+            data::current_geometry != nullptr ? static_cast<GLuint>(data::current_geometry->vertex_array_object) : 0
+        );
+        for (unsigned int unit = 0; unit < 2; ++unit) {
+            utilities::set_active_texture_unit(unit);
+            utilities::bind_texture(
+                state.bound_texture_targets[unit] != 0 ? state.bound_texture_targets[unit] : GL_TEXTURE_2D,
+                state.bound_textures[unit]
+            );
+        }
+        utilities::set_active_texture_unit(state.active_texture_unit);
+        if (state.depth_test != -1) utilities::set_capability(GL_DEPTH_TEST, state.depth_test == 1);
+        if (state.blending != -1) utilities::set_capability(GL_BLEND, state.blending == 1);
+        utilities::set_blend_function(
+            state.blend_source_factor, state.blend_destination_factor,
+            state.blend_source_alpha_factor, state.blend_destination_alpha_factor
+        );
+        utilities::set_depth_writes(state.depth_writes != 0);
+    }
+
+    static void prepare_to_render_frame()
     {
-        data::current_matrix_stack->pop();
-        data::current_matrix_stack->push(matrix);
-    }
+        data::current_frame_allocation_statistics = FrameAllocationStatistics{};
+        data::frame_allocation_tracking = true;
 
-    static void load_identity_matrix()
-    {
-        set_matrix(glm::mat4{1.0f});
-    }
+        ASR_TRACE_SCOPE("prepare_to_render_frame");
 
-    static void load_look_at_matrix(glm::vec3 position, glm::vec3 target)
-    {
-        glm::vec3 up{0.0f, 1.0f, 0.0f};
-        set_matrix(glm::lookAt(position, target, up));
+        utilities::deliver_completed_loads();
+        publish_uploaded_resources();
+        utilities::commit_texture_streams();
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        data::frame_rendering_start_time = std::chrono::system_clock::now();
+        utilities::update_frame_uniform_block();
     }
 
-    static void load_orthographic_projection_matrix(float zoom, float near_plane, float far_plane)
+    static void apply_shader_program_uniforms()
     {
-        float aspect_ratio{static_cast<float>(data::window_width) / static_cast<float>(data::window_height)};
+        if (data::current_shader_variants != nullptr) {
+            data::current_shader_program = &get_shader_variant(*data::current_shader_variants);
+        }
 
-        float left{-(zoom * aspect_ratio)};
-        float right{zoom * aspect_ratio};
-        float bottom{-zoom};
-        float top{zoom};
+        const ShaderProgram &program = *data::current_shader_program;
+        utilities::use_program(program.program_object);
 
-        set_matrix(glm::ortho(left, right, bottom, top, near_plane, far_plane));
+        if (program.uses_view_uniform_block) {
+            utilities::update_view_uniform_block();
+        }
+
+        for (unsigned int i = 0; i < program.active_builtin_uniform_count; ++i) {
+            GLint location{program.builtin_uniforms[i].location};
+            switch (program.builtin_uniforms[i].uniform) {
+                case ResolutionUniform:
+                    utilities::set_uniform(
+                        location, static_cast<GLfloat>(data::window_width), static_cast<GLfloat>(data::window_height)
+                    );
+                    break;
+                case MouseUniform:
+                    utilities::set_uniform(location, static_cast<GLfloat>(data::mouse_x), static_cast<GLfloat>(data::mouse_y));
+                    break;
+                case TimeUniform:
+                    utilities::set_uniform(
+                        location,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now() - data::rendering_start_time
+                        ).count() / 1000.0f
+                    );
+                    break;
+                case DtUniform:
+                    utilities::set_uniform(location, data::frame_rendering_delta_time);
+                    break;
+                case TextureSamplerUniform:
+                    utilities::set_uniform(location, 0);
+                    break;
+                case TextureEnabledUniform:
+                    utilities::set_uniform(location, static_cast<GLint>(data::current_textures[0] != nullptr));
+                    break;
+                // Sampler arrays are filled from the first element; entries past the declared size are ignored by GL.
+                case TextureSamplersUniform:
+                    utilities::set_uniform(location, static_cast<GLsizei>(max_texture_units), data::texture_sampler_units.data());
+                    break;
+                case TexturesEnabledUniform: {
+                    std::array<GLint, max_texture_units> textures_enabled{};
+                    for (unsigned int unit = 0; unit < max_texture_units; ++unit) {
+                        textures_enabled[unit] = static_cast<GLint>(data::current_textures[unit] != nullptr);
+                    }
+                    utilities::set_uniform(location, static_cast<GLsizei>(max_texture_units), textures_enabled.data());
+                    break;
+                }
+                case TexturingModeUniform:
+                    if (data::current_textures[0] != nullptr) {
+                        utilities::set_uniform(location, static_cast<GLint>(data::current_textures[0]->mode));
+                    }
+                    break;
+                case TextureTransformationMatrixUniform:
+                    utilities::set_uniform(location, data::texture_matrix_stack.top());
+                    break;
+                case ModelMatrixUniform:
+                    utilities::set_uniform(location, data::model_matrix_stack.top());
+                    break;
+                case ViewMatrixUniform:
+                    utilities::set_uniform(location, glm::inverse(data::view_matrix_stack.top()));
+                    break;
+                case ModelViewMatrixUniform:
+                    utilities::set_uniform(location, glm::inverse(data::view_matrix_stack.top()) * data::model_matrix_stack.top());
+                    break;
+                case ProjectionMatrixUniform:
+                    utilities::set_uniform(location, data::projection_matrix_stack.top());
+                    break;
+                case ViewProjectionMatrixUniform:
+                    utilities::set_uniform(location, data::projection_matrix_stack.top() * glm::inverse(data::view_matrix_stack.top()));
+                    break;
+                case ModelViewProjectionMatrixUniform:
+                    utilities::set_uniform(
+                        location,
+                        data::projection_matrix_stack.top() * glm::inverse(data::view_matrix_stack.top()) * data::model_matrix_stack.top()
+                    );
+                    break;
+            }
+        }
     }
 
-    static void load_perspective_projection_matrix(float field_of_view, float near_plane, float far_plane)
+    static void render_current_geometry()
     {
-        float aspect_ratio{static_cast<float>(data::window_width) / static_cast<float>(data::window_height)};
+        ASR_TRACE_GPU_SCOPE("render_current_geometry");
 
-        set_matrix(glm::perspective(field_of_view, aspect_ratio, near_plane, far_plane));
+        assert(data::current_geometry);
+
+        apply_shader_program_uniforms();
+        utilities::draw_elements(
+            utilities::convert_geometry_type_to_es2_geometry_type(data::current_geometry->type),
+            static_cast<GLsizei>(data::current_geometry->vertex_count),
+            GL_UNSIGNED_INT,
+            nullptr
+        );
     }
 
-    static void push_matrix()
+    // The view must belong to the current geometry.
+    static void render_current_geometry_view(const GeometryView &view, unsigned int first_index = 0, unsigned int index_count = std::numeric_limits<unsigned int>::max())
     {
-        glm::mat4 top_matrix = data::current_matrix_stack->top();
-        data::current_matrix_stack->push(top_matrix);
+        ASR_TRACE_GPU_SCOPE("render_current_geometry_view");
+
+        assert(data::current_geometry);
+        assert(first_index <= view.index_count);
+        assert(static_cast<size_t>(view.first_index + view.index_count) * sizeof(unsigned int) <= data::current_geometry->index_buffer_size);
+
+        index_count = std::min(index_count, view.index_count - first_index);
+        if (index_count == 0) return;
+
+        apply_shader_program_uniforms();
+        utilities::draw_elements(
+            utilities::convert_geometry_type_to_es2_geometry_type(view.type),
+            static_cast<GLsizei>(index_count),
+            GL_UNSIGNED_INT,
+            reinterpret_cast<const GLvoid *>(static_cast<size_t>(view.first_index + first_index) * sizeof(unsigned int))
+        );
     }
 
-    static void pop_matrix()
+    static void finish_frame_rendering()
     {
-        data::current_matrix_stack->pop();
-        if (data::current_matrix_stack->empty()) {
-            data::current_matrix_stack->push(glm::mat4{1.0f});
+        {
+            ASR_TRACE_SCOPE("wait_for_frame_jobs");
+            utilities::wait_for_job_group(data::frame_job_group);
         }
-    }
+        {
+            ASR_TRACE_GPU_SCOPE("swap");
+            SDL_GL_SwapWindow(data::window);
+        }
+#ifdef ASR_ENABLE_TRACING
+        utilities::collect_gpu_trace_events();
+#endif
 
-    static void clear_matrices()
-    {
-        while (!data::current_matrix_stack->empty()) data::current_matrix_stack->pop();
-        data::current_matrix_stack->push(glm::mat4{1.0f});
+        data::frame_rendering_delta_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now() - data::frame_rendering_start_time
+        ).count() / 1000.0f;
+
+        // If frame time is too large (e.g., the process is being debugged, set an artificial frame time for 60 fps.
+        if (data::frame_rendering_delta_time > 1.0f) data::frame_rendering_delta_time = 0.016;
+
+        data::frame_allocation_tracking = false;
+        data::last_frame_allocation_statistics = data::current_frame_allocation_statistics;
+
+        data::current_frame_statistics.background_uploaded_bytes = data::background_uploaded_bytes.exchange(0);
+        data::last_frame_statistics = data::current_frame_statistics;
+        data::current_frame_statistics = FrameStatistics{};
+
+        ++data::frame_count;
+        if (data::frame_statistics_print_interval != 0 && data::frame_count % data::frame_statistics_print_interval == 0) {
+            utilities::print_frame_statistics(data::last_frame_statistics);
+        }
     }
 
     /*
-     * Utility Functions
+     * Particles
+     *
+     * Particle systems simulate on the CPU with SIMD kernels, split into chunks across cores when they are
+     * large, and are drawn as points from one buffer that is refilled every frame.
      */
 
-    static std::string read_text_file(const std::string &path)
+    static std::shared_ptr<ParticleSystem> generate_particle_system(size_t capacity)
     {
-        std::ifstream file_stream{path};
-        if (!file_stream.is_open()) {
-            std::cerr << "Failed to open the file: '" << path << "'" << std::endl;
-            std::exit(-1);
+        auto system = std::make_shared<ParticleSystem>();
+        system->capacity = capacity;
+        system->memory_owner = utilities::get_current_memory_owner();
+
+        for (ParticleData *values : {
+                 &system->positions_x, &system->positions_y, &system->positions_z,
+                 &system->velocities_x, &system->velocities_y, &system->velocities_z,
+                 &system->ages, &system->lifetimes, &system->sizes
+             }) {
+            values->resize(capacity);
         }
+        system->colors.resize(capacity);
 
-        std::stringstream string_stream;
-        string_stream << file_stream.rdbuf();
+        GLuint vertex_array_object{0};
+#ifdef __APPLE__
+        glGenVertexArraysAPPLE(1, &vertex_array_object);
+#else
+        glGenVertexArrays(1, &vertex_array_object);
+#endif
+        system->vertex_array_object = vertex_array_object;
+        glGenBuffers(1, &system->vertex_buffer_object);
+
+        utilities::bind_vertex_array(vertex_array_object);
+        utilities::bind_buffer(GL_ARRAY_BUFFER, system->vertex_buffer_object);
+
+        GLsizei stride = sizeof(ParticleVertex);
+        glEnableVertexAttribArray(position_attribute_location);
+        glVertexAttribPointer(
+            position_attribute_location,
+            3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offsetof(ParticleVertex, x))
+        );
+        glEnableVertexAttribArray(color_attribute_location);
+        glVertexAttribPointer(
+            color_attribute_location,
+            4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<const GLvoid *>(offsetof(ParticleVertex, r))
+        );
+        glEnableVertexAttribArray(texture_coordinates_attribute_location);
+        glVertexAttribPointer(
+            texture_coordinates_attribute_location,
+            2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offsetof(ParticleVertex, size))
+        );
 
-        return string_stream.str();
+        utilities::bind_vertex_array(0);
+        utilities::bind_buffer(GL_ARRAY_BUFFER, 0);
+
+        return system;
     }
 
-    static Image read_image_file(const std::string &path)
+    static size_t emit_particles(ParticleSystem &system, size_t count, const ParticleEmitter &emitter)
     {
-        int image_width, image_height;
-        int bytes_per_pixel;
-
-        auto image_data = static_cast<uint8_t *>(stbi_load(path.c_str(), &image_width, &image_height, &bytes_per_pixel, 0));
-        if (!image_data) {
-            std::cerr << "Failed to open the file: '" << path << "'" << std::endl;
-            std::exit(-1);
-        }
-        if (!(bytes_per_pixel == 3 || bytes_per_pixel == 4)) {
-            std::cerr << "Invalid image file format (only RGB and RGBA files are supported): '" << path << "'"
-                      << std::endl;
-            std::exit(-1);
+        count = std::min(count, system.capacity - system.count);
+        uint32_t color{utilities::pack_particle_color(emitter.color)};
+
+        for (size_t i = system.count; i < system.count + count; ++i) {
+            system.positions_x[i] = utilities::spread_particle_value(system, emitter.position.x, emitter.position_spread.x);
+            system.positions_y[i] = utilities::spread_particle_value(system, emitter.position.y, emitter.position_spread.y);
+            system.positions_z[i] = utilities::spread_particle_value(system, emitter.position.z, emitter.position_spread.z);
+            system.velocities_x[i] = utilities::spread_particle_value(system, emitter.velocity.x, emitter.velocity_spread.x);
+            system.velocities_y[i] = utilities::spread_particle_value(system, emitter.velocity.y, emitter.velocity_spread.y);
+            system.velocities_z[i] = utilities::spread_particle_value(system, emitter.velocity.z, emitter.velocity_spread.z);
+
+            float lifetime_fraction{utilities::get_particle_random_number(system)};
+            float size_fraction{utilities::get_particle_random_number(system)};
+            system.ages[i] = 0.0f;
+            system.lifetimes[i] = std::max(
+                1e-6f, emitter.minimum_lifetime + (emitter.maximum_lifetime - emitter.minimum_lifetime) * lifetime_fraction
+            );
+            system.sizes[i] = emitter.minimum_size + (emitter.maximum_size - emitter.minimum_size) * size_fraction;
+            system.colors[i] = color;
         }
+        system.count += count;
 
-        std::vector<uint8_t> result{image_data, image_data + image_height * image_width * bytes_per_pixel};
-        stbi_image_free(image_data);
-
-        return Image{
-            result,
-            static_cast<unsigned int>(image_width),
-            static_cast<unsigned int>(image_height),
-            static_cast<unsigned int>(bytes_per_pixel)
-        };
+        return count;
     }
 
-    static float get_time_scale()
+    // Removal moves the last particle into the gap, so the order of particles is not kept.
+    static void update_particle_system(ParticleSystem &system, float dt)
     {
-        return data::time_scale;
+        ASR_TRACE_SCOPE("update_particle_system");
+
+        utilities::ParticleStepParameters parameters{
+            dt,
+            std::max(0.0f, 1.0f - system.drag * dt),
+            system.gravity,
+            system.attractors.data(),
+            system.attractors.size(),
+            system.attractor_softening
+        };
+        utilities::run_particle_chunks(system, [&](size_t begin, size_t end) {
+            utilities::step_particles(system, parameters, begin, end);
+        });
+
+        for (size_t i = 0; i < system.count; ) {
+            if (system.ages[i] >= system.lifetimes[i]) {
+                utilities::move_particle(system, --system.count, i);
+            } else {
+                ++i;
+            }
+        }
     }
 
-    static void set_time_scale(float time_scale)
+    static void clear_particle_system(ParticleSystem &system)
     {
-        data::time_scale = time_scale;
+        system.count = 0;
     }
 
-    static inline float get_dt()
+    static void render_particle_system(ParticleSystem &system)
     {
-        return data::frame_rendering_delta_time * data::time_scale;
-    }
+        ASR_TRACE_GPU_SCOPE("render_particle_system");
 
-    /*
-     * Rendering
-     */
+        if (system.count == 0) return;
 
-    static void prepare_for_rendering()
-    {
-        glClearColor(0, 0, 0, 0);
-        glViewport(0, 0, static_cast<GLsizei>(data::window_width), static_cast<GLsizei>(data::window_height));
-        glEnable(GL_PROGRAM_POINT_SIZE);
+        size_t size{system.count * sizeof(ParticleVertex)};
+        utilities::bind_buffer(GL_ARRAY_BUFFER, system.vertex_buffer_object);
 
-        while (!data::model_matrix_stack.empty()) data::model_matrix_stack.pop();
-        data::model_matrix_stack.push(glm::mat4{1.0f});
+        // The buffer is orphaned every frame, so filling it never waits for the draw of the previous frame.
+        size_t buffer_size{system.capacity * sizeof(ParticleVertex)};
+        utilities::upload_buffer_data(GL_ARRAY_BUFFER, buffer_size, nullptr, GL_STREAM_DRAW);
+        if (system.vertex_buffer_size != buffer_size) {
+            utilities::account_memory(
+                Buffers, system.memory_owner,
+                static_cast<int64_t>(buffer_size) - static_cast<int64_t>(system.vertex_buffer_size)
+            );
+            system.vertex_buffer_size = buffer_size;
+        }
 
-        while (!data::view_matrix_stack.empty()) data::view_matrix_stack.pop();
-        data::view_matrix_stack.push(glm::mat4{1.0f});
+        ParticleVertex *vertices{nullptr};
+        if (GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range) {
+            vertices = static_cast<ParticleVertex *>(glMapBufferRange(
+                GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+            ));
+        }
 
-        while (!data::projection_matrix_stack.empty()) data::projection_matrix_stack.pop();
-        data::projection_matrix_stack.push(glm::mat4{1.0f});
+        // Workers write the vertices straight into the mapped buffer; without mapping they go through memory first.
+        ParticleVertex *destination = vertices;
+        if (!destination) {
+            if (system.staging_vertices.size() < system.capacity) system.staging_vertices.resize(system.capacity);
+            destination = system.staging_vertices.data();
+        }
+        utilities::run_particle_chunks(system, [&](size_t begin, size_t end) {
+            utilities::write_particle_vertices(system, destination, begin, end);
+        });
 
-        while (!data::texture_matrix_stack.empty()) data::texture_matrix_stack.pop();
-        data::texture_matrix_stack.push(glm::mat4{1.0f});
+        if (vertices) {
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            utilities::count_uploaded_bytes(size);
+        } else {
+            utilities::count_uploaded_bytes(size);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), system.staging_vertices.data());
+        }
+        utilities::bind_buffer(GL_ARRAY_BUFFER, 0);
 
-        data::rendering_start_time = std::chrono::system_clock::now();
+        apply_shader_program_uniforms();
+        utilities::bind_vertex_array(system.vertex_array_object);
+        utilities::draw_arrays(GL_POINTS, 0, static_cast<GLsizei>(system.count));
+        utilities::bind_vertex_array(data::current_geometry ? static_cast<GLuint>(data::current_geometry->vertex_array_object) : 0);
     }
 
-    static void set_line_width(float line_width)
+    static void destroy_particle_system(ParticleSystem &system)
     {
-        glLineWidth(static_cast<GLfloat>(line_width));
+        GLuint vertex_array_object{system.vertex_array_object};
+        utilities::bind_vertex_array(0);
+#ifdef __APPLE__
+        glDeleteVertexArraysAPPLE(1, &vertex_array_object);
+#else
+        glDeleteVertexArrays(1, &vertex_array_object);
+#endif
+        system.vertex_array_object = 0;
+
+        utilities::forget_deleted_buffer(system.vertex_buffer_object);
+        glDeleteBuffers(1, &system.vertex_buffer_object);
+        system.vertex_buffer_object = 0;
+
+        utilities::account_memory(Buffers, system.memory_owner, -static_cast<int64_t>(system.vertex_buffer_size));
+        system.vertex_buffer_size = 0;
+        system.count = 0;
     }
 
-    static void enable_face_culling()
+    /*
+     * Allocation Tracking
+     */
+
+    static constexpr bool is_allocation_tracking_enabled()
     {
-        glEnable(GL_CULL_FACE);
-        glFrontFace(GL_CCW);
-        glCullFace(GL_BACK);
+#ifdef ASR_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
     }
 
-    static void disable_face_culling()
+    static FrameAllocationStatistics get_frame_allocation_statistics()
     {
-        glDisable(GL_CULL_FACE);
+        return data::last_frame_allocation_statistics;
     }
 
-    static void enable_depth_test()
+    /*
+     * Statistics
+     */
+
+    static FrameStatistics get_frame_statistics()
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LESS);
+        return data::last_frame_statistics;
     }
 
-    static void disable_depth_test()
+    static void set_frame_statistics_print_interval(unsigned int frame_count)
     {
-        glDisable(GL_DEPTH_TEST);
+        data::frame_statistics_print_interval = frame_count;
     }
 
-    static void prepare_to_render_frame()
+    /*
+     * OpenGL State
+     */
+
+    static void invalidate_gl_state_cache()
     {
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        data::gl_state = GLStateCache{};
 
-        data::frame_rendering_start_time = std::chrono::system_clock::now();
+        // Bindings cannot be left unknown, so they are reset to a state the cache can vouch for.
+        glUseProgram(0);
+#ifdef __APPLE__
+        glBindVertexArrayAPPLE(0);
+#else
+        glBindVertexArray(0);
+#endif
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        for (unsigned int unit = 0; unit < max_texture_units; ++unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glDepthFunc(GL_LESS);
+        glFrontFace(GL_CCW);
+        glCullFace(GL_BACK);
+        glBlendFunc(GL_ONE, GL_ZERO);
+        glLineWidth(1.0f);
+        glPolygonOffset(0.0f, 0.0f);
     }
+}
 
-    static void render_current_geometry()
-    {
-        assert(data::current_geometry);
+/*
+ * Allocation Hooks
+ *
+ * With ASR_TRACK_ALLOCATIONS defined, the global allocation functions are replaced to count heap
+ * allocations made by the render thread between prepare_to_render_frame() and finish_frame_rendering().
+ * Like the rest of the header, this must be compiled into exactly one translation unit.
+ */
 
-        glUseProgram(data::shader_program);
+#ifdef ASR_TRACK_ALLOCATIONS
+static constexpr std::size_t asr_default_allocation_alignment{alignof(std::max_align_t)};
 
-        if (data::resolution_uniform_location != -1) {
-            glUniform2f(
-                data::resolution_uniform_location,
-                static_cast<GLfloat>(data::window_width),
-                static_cast<GLfloat>(data::window_height)
-            );
-        }
+void *operator new(std::size_t size)
+{
+    void *pointer = asr::utilities::allocate_tracked_memory(size, asr_default_allocation_alignment);
+    if (pointer == nullptr) throw std::bad_alloc{};
 
-        if (data::mouse_uniform_location != -1) {
-            glUniform2f(
-                data::mouse_uniform_location,
-                static_cast<GLfloat>(data::mouse_x),
-                static_cast<GLfloat>(data::mouse_y)
-            );
-        }
+    return pointer;
+}
 
-        if (data::time_uniform_location != -1) {
-            float time =
-                std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now() - data::rendering_start_time
-                ).count() / 1000.0f;
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
 
-            glUniform1f(data::time_uniform_location, time);
-        }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return asr::utilities::allocate_tracked_memory(size, asr_default_allocation_alignment);
+}
 
-        if (data::dt_uniform_location != -1) {
-            glUniform1f(data::dt_uniform_location, data::frame_rendering_delta_time);
-        }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return asr::utilities::allocate_tracked_memory(size, asr_default_allocation_alignment);
+}
 
-        bool texture_enabled = data::current_texture != nullptr;
-        if (data::texture_enabled_uniform_location != -1) {
-            glUniform1i(
-                data::texture_enabled_uniform_location,
-                static_cast<GLint>(texture_enabled)
-            );
-        }
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    void *pointer = asr::utilities::allocate_tracked_memory(size, static_cast<std::size_t>(alignment));
+    if (pointer == nullptr) throw std::bad_alloc{};
 
-        if (data::texture_sampler_uniform_location != -1) {
-            glUniform1i(data::texture_sampler_uniform_location, 0);
-        }
+    return pointer;
+}
 
-        if (data::texture_transformation_matrix_uniform_location != -1) {
-            glm::mat4 texture_matrix = data::texture_matrix_stack.top();
-            glUniformMatrix4fv(
-                data::texture_transformation_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(texture_matrix)
-            );
-        }
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
 
-        if (data::texturing_mode_uniform_location != -1 && data::current_texture != nullptr) {
-            glUniform1i(
-                data::texturing_mode_uniform_location,
-                static_cast<GLint>(data::current_texture->mode)
-            );
-        }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return asr::utilities::allocate_tracked_memory(size, static_cast<std::size_t>(alignment));
+}
 
-        if (data::model_matrix_uniform_location != -1) {
-            glm::mat4 model_matrix = data::model_matrix_stack.top();
-            glUniformMatrix4fv(
-                data::model_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(model_matrix)
-            );
-        }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return asr::utilities::allocate_tracked_memory(size, static_cast<std::size_t>(alignment));
+}
 
-        if (data::view_matrix_uniform_location != -1) {
-            glm::mat4 view_matrix = glm::inverse(data::view_matrix_stack.top());
-            glUniformMatrix4fv(
-                data::view_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(view_matrix)
-            );
-        }
+void operator delete(void *pointer) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-        if (data::model_view_matrix_uniform_location != -1) {
-            glm::mat4 model_matrix = data::model_matrix_stack.top();
-            glm::mat4 view_matrix = glm::inverse(data::view_matrix_stack.top());
-            glm::mat4 model_view_matrix = view_matrix * model_matrix;
-            glUniformMatrix4fv(
-                data::model_view_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(model_view_matrix)
-            );
-        }
+void operator delete[](void *pointer) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-        if (data::projection_matrix_uniform_location != -1) {
-            glm::mat4 projection_matrix = data::projection_matrix_stack.top();
-            glUniformMatrix4fv(
-                data::projection_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(projection_matrix)
-            );
-        }
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-        if (data::view_projection_matrix_uniform_location != -1) {
-            glm::mat4 view_matrix = glm::inverse(data::view_matrix_stack.top());
-            glm::mat4 projection_matrix = data::projection_matrix_stack.top();
-            glm::mat4 view_projection_matrix = projection_matrix * view_matrix;
-            glUniformMatrix4fv(
-                data::view_projection_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(view_projection_matrix)
-            );
-        }
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-        if (data::mvp_matrix_uniform_location != -1) {
-            glm::mat4 model_matrix = data::model_matrix_stack.top();
-            glm::mat4 view_matrix = glm::inverse(data::view_matrix_stack.top());
-            glm::mat4 projection_matrix = data::projection_matrix_stack.top();
-            glm::mat4 model_view_projection_matrix = projection_matrix * view_matrix * model_matrix;
-            glUniformMatrix4fv(
-                data::mvp_matrix_uniform_location,
-                1, GL_FALSE,
-                glm::value_ptr(model_view_projection_matrix)
-            );
-        }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-        glDrawElements(
-            utilities::convert_geometry_type_to_es2_geometry_type(data::current_geometry->type),
-            static_cast<GLsizei>(data::current_geometry->vertex_count),
-            GL_UNSIGNED_INT,
-            nullptr
-        );
-    }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, asr_default_allocation_alignment);
+}
 
-    static void finish_frame_rendering()
-    {
-        SDL_GL_SwapWindow(data::window);
+void operator delete(void *pointer, std::align_val_t alignment) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
+}
 
-        data::frame_rendering_delta_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - data::frame_rendering_start_time
-        ).count() / 1000.0f;
+void operator delete[](void *pointer, std::align_val_t alignment) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
+}
 
-        // If frame time is too large (e.g., the process is being debugged, set an artificial frame time for 60 fps.
-        if (data::frame_rendering_delta_time > 1.0f) data::frame_rendering_delta_time = 0.016;
-    }
+void operator delete(void *pointer, std::size_t, std::align_val_t alignment) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t alignment) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
 }
 
+void operator delete[](void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    asr::utilities::free_tracked_memory(pointer, static_cast<std::size_t>(alignment));
+}
+#endif
+
 #endif
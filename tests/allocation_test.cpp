@@ -0,0 +1,196 @@
+#define ASR_TRACK_ALLOCATIONS
+#include "asr.h"
+
+#include <iostream>
+#include <vector>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 110
+
+    attribute vec4 position;
+    attribute vec4 color;
+    attribute vec4 texture_coordinates;
+
+    uniform mat4 texture_transformation_matrix;
+
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec4 fragment_color;
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+    #ifdef ASR_VERTEX_COLOR_ENABLED
+        fragment_color = color;
+    #else
+        fragment_color = vec4(1.0);
+    #endif
+    #ifdef ASR_TEXTURE_ENABLED
+        vec4 transformed_texture_coordinates = texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0);
+        fragment_texture_coordinates = vec2(transformed_texture_coordinates);
+    #endif
+
+        gl_Position = model_view_projection_matrix * position;
+        gl_PointSize = 10.0;
+    }
+)";
+
+static const char Fragment_Shader_Source[] = R"(
+    #version 110
+
+    uniform sampler2D texture_sampler;
+
+    varying vec4 fragment_color;
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+        gl_FragColor = fragment_color;
+    #ifdef ASR_TEXTURE_ENABLED
+        gl_FragColor *= texture2D(texture_sampler, fragment_texture_coordinates);
+    #endif
+    }
+)";
+
+static const std::vector<asr::Vertex> Triangle_Geometry_Vertices = {
+    //           Position             Color (RGBA)            Texture Coordinates (UV)
+    asr::Vertex{ 0.5f,   0.0f,  0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,  0.5f },
+    asr::Vertex{-0.25f,  0.43f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.25f, 0.07f},
+    asr::Vertex{-0.25f, -0.43f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.25f, 0.93f}
+};
+static const std::vector<unsigned int> Triangle_Geometry_Indices = { 0, 1, 2 };
+
+static const std::vector<asr::Vertex> Rectangle_Geometry_Vertices = {
+    //           Position              Color (RGBA)            Texture Coordinates (UV)
+    asr::Vertex{-0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f},
+    asr::Vertex{ 0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    asr::Vertex{ 0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+    asr::Vertex{-0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f}
+};
+static const std::vector<unsigned int> Rectangle_Geometry_Indices = { 0, 1, 2, 0, 2, 3 };
+static const std::vector<unsigned int> Rectangle_Edges_Indices = { 0, 1, 1, 2, 2, 3, 3, 0 };
+
+static const unsigned int Heatmap_Size{64};
+
+static const unsigned int Warm_Up_Frame_Count{10};
+static const unsigned int Measured_Frame_Count{120};
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    auto shader_variants = generate_shader_variants(
+        Vertex_Shader_Source,
+        Fragment_Shader_Source
+    );
+    set_shader_variants_current(&shader_variants);
+    auto triangle_geometry = generate_geometry(
+        GeometryType::Triangles,
+        Triangle_Geometry_Vertices,
+        Triangle_Geometry_Indices
+    );
+    auto rectangle_geometry = generate_geometry(
+        GeometryType::Triangles,
+        Rectangle_Geometry_Vertices,
+        Rectangle_Geometry_Indices
+    );
+    auto rectangle_edges_geometry = generate_geometry(
+        GeometryType::Lines,
+        Rectangle_Geometry_Vertices,
+        Rectangle_Edges_Indices
+    );
+    auto image = read_image_file("data/images/uv_test.png");
+    auto texture = generate_texture(image);
+
+    Image heatmap_image{PixelData(Heatmap_Size * Heatmap_Size * 4, 0), Heatmap_Size, Heatmap_Size, 4};
+    auto heatmap_texture = generate_texture(heatmap_image);
+    auto heatmap_stream = generate_texture_stream(heatmap_texture, true);
+
+    prepare_for_rendering();
+
+    enable_depth_test();
+    enable_face_culling();
+
+    // Scenes: a flat triangle, a textured rectangle with edges, a hierarchy of rectangles under a
+    // perspective camera that pushes and pops model matrices, and a streamed heatmap.
+    set_matrix_mode(MatrixMode::Projection);
+    load_perspective_projection_matrix(1.13f, 0.1f, 100.0f);
+
+    bool should_stop{false};
+    unsigned int failed_frame_count{0};
+    for (unsigned int frame = 0; frame < Warm_Up_Frame_Count + Measured_Frame_Count && !should_stop; ++frame) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        // The heatmap is streamed: one row changes per frame and only that row is transferred.
+        unsigned int heatmap_row{frame % Heatmap_Size};
+        for (unsigned int x = 0; x < Heatmap_Size; ++x) {
+            heatmap_image.pixel_data[(heatmap_row * Heatmap_Size + x) * 4 + 0] = static_cast<uint8_t>(frame * 4);
+            heatmap_image.pixel_data[(heatmap_row * Heatmap_Size + x) * 4 + 3] = 255;
+        }
+        mark_texture_rows_dirty(*heatmap_stream, heatmap_row, 1);
+        update_texture(*heatmap_stream, heatmap_image);
+
+        set_matrix_mode(MatrixMode::View);
+        load_identity_matrix();
+        translate_matrix(glm::vec3{0.0f, 0.0f, 2.5f});
+
+        set_matrix_mode(MatrixMode::Model);
+        load_identity_matrix();
+
+        set_texture_current(nullptr);
+        set_geometry_current(&triangle_geometry);
+        render_current_geometry();
+
+        set_texture_current(&texture);
+        set_matrix_mode(MatrixMode::Texturing);
+        load_identity_matrix();
+        rotate_matrix(glm::vec3{0.0f, 0.0f, get_dt()});
+        set_matrix_mode(MatrixMode::Model);
+        for (int i = 0; i < 8; ++i) {
+            push_matrix();
+            rotate_matrix(glm::vec3{0.0f, static_cast<float>(i) * quarter_pi, 0.0f});
+            translate_matrix(glm::vec3{0.0f, 0.0f, 1.0f});
+            scale_matrix(glm::vec3{0.5f});
+
+            set_texture_current(&texture);
+            set_geometry_current(&rectangle_geometry);
+            render_current_geometry();
+
+            set_texture_current(nullptr);
+            set_geometry_current(&rectangle_edges_geometry);
+            render_current_geometry();
+            pop_matrix();
+        }
+
+        set_texture_current(&heatmap_texture);
+        set_geometry_current(&rectangle_geometry);
+        render_current_geometry();
+
+        finish_frame_rendering();
+
+        if (frame >= Warm_Up_Frame_Count) {
+            FrameAllocationStatistics statistics = get_frame_allocation_statistics();
+            if (statistics.allocation_count != 0) {
+                std::cerr << "Frame " << frame << " made " << statistics.allocation_count
+                          << " heap allocations (" << statistics.allocated_bytes << " bytes)" << std::endl;
+                ++failed_frame_count;
+            }
+        }
+    }
+
+    destroy_texture_stream(*heatmap_stream);
+    destroy_texture(heatmap_texture);
+    destroy_texture(texture);
+    destroy_geometry(triangle_geometry);
+    destroy_geometry(rectangle_geometry);
+    destroy_geometry(rectangle_edges_geometry);
+    destroy_shader_variants(shader_variants);
+
+    destroy_window();
+
+    return failed_frame_count == 0 ? 0 : 1;
+}
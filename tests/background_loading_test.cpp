@@ -0,0 +1,151 @@
+#include "asr.h"
+
+#include <iostream>
+#include <vector>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 110
+
+    attribute vec4 position;
+    attribute vec4 texture_coordinates;
+
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+        fragment_texture_coordinates = texture_coordinates.st;
+        gl_Position = model_view_projection_matrix * position;
+    }
+)";
+
+static const char Fragment_Shader_Source[] = R"(
+    #version 110
+
+    uniform sampler2D texture_sampler;
+
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+        gl_FragColor = texture2D(texture_sampler, fragment_texture_coordinates);
+    }
+)";
+
+static const std::vector<asr::Vertex> Rectangle_Geometry_Vertices = {
+    //           Position              Color (RGBA)            Texture Coordinates (UV)
+    asr::Vertex{-0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f},
+    asr::Vertex{ 0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    asr::Vertex{ 0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+    asr::Vertex{-0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f}
+};
+static const std::vector<unsigned int> Rectangle_Geometry_Indices = { 0, 1, 2, 0, 2, 3 };
+
+// Loads that are not delivered within this many frames count as lost.
+static const unsigned int Max_Frame_Count{600};
+
+static const char Image_Path[] = "data/images/uv_test.png";
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    create_shader_program(Vertex_Shader_Source, Fragment_Shader_Source);
+
+    // The texture and the rectangle go through the loader thread's context and are published on this thread
+    // once their fences have signaled; until then the frame loop keeps going without them.
+    auto texture_upload = generate_texture_async(read_image_file(Image_Path), true);
+    auto geometry_upload = generate_geometry_async(
+        GeometryType::Triangles,
+        Rectangle_Geometry_Vertices,
+        Rectangle_Geometry_Indices
+    );
+
+    // Files read by the job system are delivered at the start of a frame, with their callbacks.
+    unsigned int image_callback_count{0};
+    auto image_load = read_image_file_async(Image_Path, NoPixelConversion, High, [&](AsyncLoad<Image> &) {
+        ++image_callback_count;
+    });
+    auto missing_file_load = read_text_file_async("data/missing_file.txt");
+    auto cancelled_load = read_image_file_async(Image_Path);
+    cancel_load(*cancelled_load);
+    auto texture_load = load_texture_async(Image_Path);
+
+    prepare_for_rendering();
+
+    auto is_done = [&]() {
+        return texture_upload->ready && geometry_upload->ready &&
+               image_load->state != Pending && missing_file_load->state != Pending &&
+               cancelled_load->state != Pending && texture_load->state != Pending;
+    };
+
+    int result{0};
+    bool should_stop{false};
+    unsigned int frame{0};
+    for (; frame < Max_Frame_Count && !should_stop; ++frame) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        // Until the load is ready, the shared placeholder is drawn in place of its texture.
+        if (texture_load->state == Pending && get_loaded_texture(*texture_load) == &texture_load->value) {
+            std::cerr << "A pending texture load handed out its own texture" << std::endl;
+            result = 1;
+        }
+        if (geometry_upload->ready) {
+            set_loaded_texture_current(*texture_load);
+            set_geometry_current(&geometry_upload->geometry);
+            render_current_geometry();
+        }
+        if (texture_upload->ready && geometry_upload->ready) {
+            set_texture_current(&texture_upload->texture);
+            render_current_geometry();
+        }
+
+        finish_frame_rendering();
+
+        if (is_done()) break;
+    }
+
+    if (!is_done()) {
+        std::cerr << "The loads were not delivered within " << Max_Frame_Count << " frames" << std::endl;
+        result = 1;
+    } else {
+        if (glIsTexture(texture_upload->texture.texture_object) != GL_TRUE ||
+            glIsBuffer(static_cast<GLuint>(geometry_upload->geometry.vertex_buffer_object)) != GL_TRUE ||
+            glIsBuffer(static_cast<GLuint>(geometry_upload->geometry.index_buffer_object)) != GL_TRUE) {
+            std::cerr << "A published upload does not name a valid OpenGL object" << std::endl;
+            result = 1;
+        }
+        if (image_load->state != Ready || image_load->value.width == 0 || image_callback_count != 1) {
+            std::cerr << "The image was not delivered once and whole" << std::endl;
+            result = 1;
+        }
+        if (missing_file_load->state != Failed || missing_file_load->error.empty()) {
+            std::cerr << "Reading a missing file did not fail with an error" << std::endl;
+            result = 1;
+        }
+        if (cancelled_load->state != Cancelled) {
+            std::cerr << "A cancelled load was delivered as " << cancelled_load->state << std::endl;
+            result = 1;
+        }
+        if (texture_load->state != Ready || get_loaded_texture(*texture_load) != &texture_load->value ||
+            glIsTexture(texture_load->value.texture_object) != GL_TRUE) {
+            std::cerr << "The texture load did not end with its own texture" << std::endl;
+            result = 1;
+        }
+        if (result == 0) std::cout << "The loads were delivered after " << frame + 1 << " frames" << std::endl;
+    }
+
+    destroy_texture(texture_load->value);
+    destroy_texture(texture_upload->texture);
+    destroy_geometry(geometry_upload->geometry);
+    destroy_shader_program();
+
+    destroy_window();
+
+    return result;
+}
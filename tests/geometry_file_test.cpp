@@ -0,0 +1,128 @@
+#include "asr.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static const char Geometry_File_Path[] = "geometry_file_test.asrgeom";
+
+static const unsigned int Grid_Size{100};
+
+static bool is_geometry_file_accepted(const std::vector<uint8_t> &bytes)
+{
+    {
+        std::ofstream file_stream{Geometry_File_Path, std::ios::binary | std::ios::trunc};
+        file_stream.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    asr::MappedFile file;
+    std::string error;
+    bool accepted{
+        asr::utilities::map_file(Geometry_File_Path, file, error) &&
+        asr::utilities::validate_geometry_file(file, Geometry_File_Path, error)
+    };
+    asr::utilities::unmap_file(file);
+
+    return accepted;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    int result{0};
+
+    // Noise, long runs, repeated text and a mix of noise and runs, from a single byte up to a megabyte.
+    uint32_t state{12345};
+    for (size_t size : {size_t{1}, size_t{12}, size_t{13}, size_t{1000}, size_t{70000}, size_t{1} << 20}) {
+        for (unsigned int kind = 0; kind < 4; ++kind) {
+            std::vector<uint8_t> data(size);
+            for (size_t i = 0; i < size; ++i) {
+                state = state * 1664525u + 1013904223u;
+                auto noise = static_cast<uint8_t>(state >> 24);
+                switch (kind) {
+                    case 0: data[i] = noise; break;
+                    case 1: data[i] = static_cast<uint8_t>(i / 300); break;
+                    case 2: data[i] = static_cast<uint8_t>("vertex index chunk "[i % 19]); break;
+                    default: data[i] = (i / 64) % 2 == 0 ? noise : static_cast<uint8_t>(i % 7); break;
+                }
+            }
+
+            std::vector<uint8_t> compressed(size + size / 255 + 16);
+            size_t compressed_size{utilities::compress_lz4_block(data.data(), size, compressed.data(), compressed.size())};
+            std::vector<uint8_t> decompressed(size);
+            if (compressed_size == 0 ||
+                !utilities::decompress_lz4_block(compressed.data(), compressed_size, decompressed.data(), size) ||
+                decompressed != data) {
+                std::cerr << "LZ4 did not round-trip " << size << " bytes of input " << kind << std::endl;
+                result = 1;
+            } else if (compressed_size > 1 &&
+                       utilities::decompress_lz4_block(compressed.data(), compressed_size / 2, decompressed.data(), size)) {
+                std::cerr << "A truncated LZ4 block of " << size << " bytes of input " << kind << " decoded" << std::endl;
+                result = 1;
+            }
+        }
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    for (unsigned int y = 0; y <= Grid_Size; ++y) {
+        for (unsigned int x = 0; x <= Grid_Size; ++x) {
+            float u{static_cast<float>(x) / Grid_Size}, v{static_cast<float>(y) / Grid_Size};
+            vertices.push_back(Vertex{u, v, 0.0f, u, v, 1.0f, 1.0f, u, v});
+        }
+    }
+    for (unsigned int y = 0; y < Grid_Size; ++y) {
+        for (unsigned int x = 0; x < Grid_Size; ++x) {
+            unsigned int corner{y * (Grid_Size + 1) + x};
+            for (unsigned int offset : {0u, 1u, Grid_Size + 2, 0u, Grid_Size + 2, Grid_Size + 1}) {
+                indices.push_back(corner + offset);
+            }
+        }
+    }
+
+    for (auto compression : {UncompressedGeometryFile, LZ4GeometryFile}) {
+        const char *name = compression == UncompressedGeometryFile ? "uncompressed file" : "LZ4 file";
+
+        write_geometry_file(Geometry_File_Path, Triangles, vertices, indices, compression);
+        std::vector<uint8_t> bytes;
+        {
+            std::ifstream file_stream{Geometry_File_Path, std::ios::binary};
+            bytes.assign(std::istreambuf_iterator<char>{file_stream}, std::istreambuf_iterator<char>{});
+        }
+        if (!is_geometry_file_accepted(bytes)) {
+            std::cerr << name << ": the file as written was rejected" << std::endl;
+            result = 1;
+        }
+
+        // Near 2^64, adding the vertex data size to the offset wraps around.
+        std::vector<uint8_t> corrupted{bytes};
+        reinterpret_cast<GeometryFileHeader *>(corrupted.data())->vertex_data_offset = ~uint64_t{0} - geometry_file_alignment + 1;
+        if (is_geometry_file_accepted(corrupted)) {
+            std::cerr << name << ": a wrapping vertex data offset was accepted" << std::endl;
+            result = 1;
+        }
+
+        corrupted = bytes;
+        reinterpret_cast<GeometryFileHeader *>(corrupted.data())->vertex_data_offset += geometry_file_alignment;
+        if (is_geometry_file_accepted(corrupted)) {
+            std::cerr << name << ": vertex data running into the indices was accepted" << std::endl;
+            result = 1;
+        }
+
+        corrupted.assign(bytes.begin(), bytes.end() - 1);
+        if (is_geometry_file_accepted(corrupted)) {
+            std::cerr << name << ": a truncated file was accepted" << std::endl;
+            result = 1;
+        }
+    }
+    std::remove(Geometry_File_Path);
+
+    stop_job_system();
+
+    return result;
+}
@@ -0,0 +1,94 @@
+#include "asr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static bool is_mesh_valid(const asr::GeometryData &geometry_data, bool check_seam)
+{
+    const auto &[vertices, indices] = geometry_data;
+    if (indices.size() % 3 != 0) return false;
+    for (unsigned int index : indices) {
+        if (index >= vertices.size()) return false;
+    }
+
+    // A triangle over the seam that was not split interpolates u across the whole texture.
+    for (size_t i = 0; check_seam && i < indices.size(); i += 3) {
+        auto [min_u, max_u] = std::minmax({vertices[indices[i]].u, vertices[indices[i + 1]].u, vertices[indices[i + 2]].u});
+        if (max_u - min_u > 0.5f) return false;
+    }
+
+    return true;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    int result{0};
+
+    // The odd angles land in both the SIMD groups and the scalar tail.
+    std::vector<float> angles;
+    for (int i = -4000; i <= 4000; ++i) {
+        angles.push_back(static_cast<float>(i) * 2.0473f);
+    }
+    for (size_t position : {size_t{5}, size_t{1234}, angles.size() - 2}) {
+        angles.insert(angles.begin() + static_cast<std::ptrdiff_t>(position), {
+            std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+            -std::numeric_limits<float>::infinity(), 3.0e9f, -1.0e30f, 8192.5f
+        });
+    }
+    std::vector<float> sines(angles.size()), cosines(angles.size());
+    compute_sines_and_cosines(angles.data(), sines.data(), cosines.data(), angles.size());
+
+    for (size_t i = 0; i < angles.size(); ++i) {
+        float expected_sine{std::sin(angles[i])}, expected_cosine{std::cos(angles[i])};
+        if (std::isnan(expected_sine) || std::isnan(expected_cosine)) {
+            if (!std::isnan(sines[i]) || !std::isnan(cosines[i])) {
+                std::cerr << "sine and cosine of " << angles[i] << " are not NaN" << std::endl;
+                result = 1;
+            }
+        } else if (!(std::abs(sines[i] - expected_sine) <= 1e-6f && std::abs(cosines[i] - expected_cosine) <= 1e-6f)) {
+            std::cerr << "sine and cosine of " << angles[i] << ": got " << sines[i] << " and " << cosines[i]
+                      << " instead of " << expected_sine << " and " << expected_cosine << std::endl;
+            result = 1;
+        }
+    }
+
+    if (!is_mesh_valid(generate_circle_geometry_data(1.0f, 64), false)) {
+        std::cerr << "circle: the indices do not make triangles of its vertices" << std::endl;
+        result = 1;
+    }
+    if (!is_mesh_valid(generate_sphere_geometry_data(1.0f, 32, 16), false)) {
+        std::cerr << "UV sphere: the indices do not make triangles of its vertices" << std::endl;
+        result = 1;
+    }
+
+    for (unsigned int level = 0; level <= 5; ++level) {
+        auto icosphere = generate_icosphere_geometry_data(1.0f, level);
+        if (!is_mesh_valid(icosphere, true)) {
+            std::cerr << "icosphere level " << level << ": a triangle is invalid or crosses the seam" << std::endl;
+            result = 1;
+        }
+
+        // The seam split only depends on the positions, so the same level always gives the same mesh.
+        auto regenerated_icosphere = generate_icosphere_geometry_data(1.0f, level);
+        if (regenerated_icosphere.first.size() != icosphere.first.size() ||
+            regenerated_icosphere.second != icosphere.second) {
+            std::cerr << "icosphere level " << level << ": regenerating it gave a different mesh" << std::endl;
+            result = 1;
+        }
+    }
+    for (unsigned int segment_count : {1u, 2u, 8u, 16u, 33u}) {
+        if (!is_mesh_valid(generate_cube_sphere_geometry_data(1.0f, segment_count), true)) {
+            std::cerr << "cube sphere " << segment_count << ": a triangle is invalid or crosses the seam" << std::endl;
+            result = 1;
+        }
+    }
+
+    stop_job_system();
+
+    return result;
+}
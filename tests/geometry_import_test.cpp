@@ -0,0 +1,199 @@
+#include "asr.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const char Obj_Quads_Source[] =
+    "# A unit square as one quad, and the same square again through relative indices, with CRLF line ends\r\n"
+    "v 0 0 0\r\n"
+    "v 1 0 0\r\n"
+    "v 1 1 0\r\n"
+    "v 0 1 0\r\n"
+    "f 1 2 3 4\r\n"
+    "f -4 -2 -1\r\n";
+
+static const char Obj_Split_Texture_Coordinates_Source[] =
+    "v 0 0 0\n"
+    "v 1 0 0\n"
+    "v 0 1 0\n"
+    "vt 0 0\n"
+    "vt 1 0\n"
+    "vt 0 1\n"
+    "vt 0.5 0.5\n"
+    "f 1/1 2/2 3/3\n"
+    "f 1/4/1 3/3/1 2/2/1\n";
+
+static const char Obj_Colors_Source[] =
+    "v 0 0 0 0.5\n"
+    "v 1 0 0 0.25 0.5 0.75\n"
+    "v 0 1 0\n"
+    "f 1 2 3\n";
+
+static const char Ply_Ascii_Source[] =
+    "ply\r\n"
+    "format ascii 1.0\r\n"
+    "comment A unit square as one quad\r\n"
+    "element vertex 4\r\n"
+    "property float x\r\n"
+    "property float y\r\n"
+    "property float z\r\n"
+    "property uchar red\r\n"
+    "property uchar green\r\n"
+    "property uchar blue\r\n"
+    "element face 1\r\n"
+    "property list uchar int vertex_indices\r\n"
+    "end_header\r\n"
+    "0 0 0 255 0 0\r\n"
+    "1 0 0 0 255 0\r\n"
+    "1 1 0 0 0 255\r\n"
+    "0 1 0 255 255 255\r\n"
+    "4 0 1 2 3\r\n";
+
+static const float Square_Positions[4][3]{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+static const uint8_t Square_Colors[4][3]{{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255}};
+
+static const char Fixture_Path_Prefix[] = "geometry_import_test";
+
+static std::string write_fixture(const std::string &extension, const std::string &contents)
+{
+    std::string path{std::string{Fixture_Path_Prefix} + "." + extension};
+    std::ofstream file_stream{path, std::ios::binary | std::ios::trunc};
+    file_stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    return path;
+}
+
+template<typename T>
+static void append_binary_value(std::string &contents, T value, bool big_endian)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        contents.push_back(bytes[big_endian ? sizeof(T) - 1 - i : i]);
+    }
+}
+
+// The square of the ASCII fixture in a binary encoding.
+static std::string make_binary_ply_source(bool big_endian)
+{
+    std::string contents{
+        std::string{"ply\nformat "} + (big_endian ? "binary_big_endian" : "binary_little_endian") + " 1.0\n"
+        "element vertex 4\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+        "element face 1\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"
+    };
+    for (unsigned int i = 0; i < 4; ++i) {
+        for (float component : Square_Positions[i]) {
+            append_binary_value(contents, component, big_endian);
+        }
+        for (uint8_t channel : Square_Colors[i]) {
+            append_binary_value(contents, channel, big_endian);
+        }
+    }
+    append_binary_value(contents, static_cast<uint8_t>(4), big_endian);
+    for (int32_t index : {0, 1, 2, 3}) {
+        append_binary_value(contents, index, big_endian);
+    }
+
+    return contents;
+}
+
+static bool is_vertex_close(const asr::Vertex &vertex, const std::vector<float> &expected)
+{
+    const float actual[]{vertex.x, vertex.y, vertex.z, vertex.r, vertex.g, vertex.b, vertex.a, vertex.u, vertex.v};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (std::abs(actual[i] - expected[i]) > 1e-6f) return false;
+    }
+
+    return true;
+}
+
+struct Fixture
+{
+    std::string name;
+    std::string extension;
+    std::string contents;
+    std::vector<std::vector<float>> expected_vertices;
+    std::vector<unsigned int> expected_indices;
+};
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    std::vector<std::vector<float>> square_vertices;
+    for (unsigned int i = 0; i < 4; ++i) {
+        square_vertices.push_back({
+            Square_Positions[i][0], Square_Positions[i][1], Square_Positions[i][2],
+            Square_Colors[i][0] / 255.0f, Square_Colors[i][1] / 255.0f, Square_Colors[i][2] / 255.0f, 1.0f
+        });
+    }
+    std::vector<unsigned int> square_indices{0, 1, 2, 0, 2, 3};
+
+    const std::vector<Fixture> fixtures{
+        {
+            "OBJ quads", "obj", Obj_Quads_Source,
+            {{0, 0, 0, 1, 1, 1, 1}, {1, 0, 0, 1, 1, 1, 1}, {1, 1, 0, 1, 1, 1, 1}, {0, 1, 0, 1, 1, 1, 1}},
+            {0, 1, 2, 0, 2, 3, 0, 2, 3}
+        },
+        // The first corner is used with two texture coordinates, so it becomes two vertices.
+        {
+            "OBJ split texture coordinates", "obj", Obj_Split_Texture_Coordinates_Source,
+            {
+                {0, 0, 0, 1, 1, 1, 1, 0.0f, 0.0f}, {1, 0, 0, 1, 1, 1, 1, 1.0f, 0.0f},
+                {0, 1, 0, 1, 1, 1, 1, 0.0f, 1.0f}, {0, 0, 0, 1, 1, 1, 1, 0.5f, 0.5f}
+            },
+            {0, 1, 2, 3, 2, 1}
+        },
+        // A weight is not a color, even when another vertex of the file has one.
+        {
+            "OBJ colors", "obj", Obj_Colors_Source,
+            {{0, 0, 0, 1.0f, 1.0f, 1.0f, 1}, {1, 0, 0, 0.25f, 0.5f, 0.75f, 1}, {0, 1, 0, 1.0f, 1.0f, 1.0f, 1}},
+            {0, 1, 2}
+        },
+        {"ASCII PLY", "ply", Ply_Ascii_Source, square_vertices, square_indices},
+        {"little-endian PLY", "ply", make_binary_ply_source(false), square_vertices, square_indices},
+        {"big-endian PLY", "ply", make_binary_ply_source(true), square_vertices, square_indices}
+    };
+
+    int result{0};
+    for (const auto &fixture : fixtures) {
+        const auto &[vertices, indices] = read_geometry_file(write_fixture(fixture.extension, fixture.contents));
+        bool matches{vertices.size() == fixture.expected_vertices.size() && indices == fixture.expected_indices};
+        for (size_t i = 0; matches && i < vertices.size(); ++i) {
+            matches = is_vertex_close(vertices[i], fixture.expected_vertices[i]);
+        }
+        if (!matches) {
+            std::cerr << fixture.name << ": read " << vertices.size() << " vertices and " << indices.size()
+                      << " indices that differ from the expected ones" << std::endl;
+            result = 1;
+        }
+    }
+
+    // A count that the file cannot hold is rejected before anything is allocated for it.
+    std::string header{"ply\nformat binary_little_endian 1.0\nelement vertex 18446744073709551615\nproperty float x\nend_header\n"};
+    const char *position = header.c_str();
+    PlyFormat format;
+    std::vector<PlyElement> elements;
+    std::string error;
+    if (utilities::read_ply_header(position, header.c_str() + header.size(), format, elements, error)) {
+        std::cerr << "PLY header: a vertex count beyond the file size was accepted" << std::endl;
+        result = 1;
+    }
+
+    std::remove((std::string{Fixture_Path_Prefix} + ".obj").c_str());
+    std::remove((std::string{Fixture_Path_Prefix} + ".ply").c_str());
+
+    stop_job_system();
+
+    return result;
+}
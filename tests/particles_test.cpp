@@ -0,0 +1,115 @@
+#include "asr.h"
+
+#include <cmath>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 120
+
+    attribute vec4 position;
+    attribute vec4 color;
+    attribute vec4 texture_coordinates;
+
+    uniform vec2 resolution;
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec4 fragment_color;
+
+    void main()
+    {
+        float size = texture_coordinates.x;
+        float age = texture_coordinates.y;
+
+        fragment_color = color;
+        fragment_color.a *= 1.0 - age;
+
+        gl_Position = model_view_projection_matrix * position;
+        gl_PointSize = max(1.0, size * resolution.y / gl_Position.w);
+    }
+)";
+
+static const char Fragment_Shader_Source[] = R"(
+    #version 120
+
+    varying vec4 fragment_color;
+
+    void main()
+    {
+        vec2 offset = gl_PointCoord * 2.0 - 1.0;
+        float falloff = 1.0 - dot(offset, offset);
+        if (falloff <= 0.0) discard;
+
+        gl_FragColor = vec4(fragment_color.rgb, fragment_color.a * falloff);
+    }
+)";
+
+static const size_t Particle_Count{1000000};
+static const float Particle_Lifetime{4.0f};
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    create_shader_program(
+        Vertex_Shader_Source,
+        Fragment_Shader_Source
+    );
+
+    // A fountain of a million particles that keeps its population steady, pulled around by two
+    // attractors orbiting the origin.
+    auto particles = generate_particle_system(Particle_Count);
+    particles->gravity = glm::vec3{0.0f, -1.0f, 0.0f};
+    particles->drag = 0.2f;
+    particles->attractors.resize(2);
+
+    ParticleEmitter emitter;
+    emitter.position = glm::vec3{0.0f, -1.0f, 0.0f};
+    emitter.position_spread = glm::vec3{0.05f, 0.0f, 0.05f};
+    emitter.velocity = glm::vec3{0.0f, 2.5f, 0.0f};
+    emitter.velocity_spread = glm::vec3{0.6f, 0.5f, 0.6f};
+    emitter.minimum_lifetime = Particle_Lifetime * 0.5f;
+    emitter.maximum_lifetime = Particle_Lifetime;
+    emitter.minimum_size = 0.002f;
+    emitter.maximum_size = 0.006f;
+    emitter.color = glm::vec4{1.0f, 0.5f, 0.2f, 0.6f};
+
+    prepare_for_rendering();
+
+    enable_blending(AdditiveBlending);
+
+    set_matrix_mode(MatrixMode::Projection);
+    load_perspective_projection_matrix(1.13f, 0.1f, 100.0f);
+    set_matrix_mode(MatrixMode::View);
+    load_identity_matrix();
+    translate_matrix(glm::vec3{0.0f, 0.0f, 3.0f});
+
+    float time{0.0f};
+
+    bool should_stop{false};
+    while (!should_stop) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        float dt{get_dt()};
+        time += dt;
+        particles->attractors[0] = ParticleAttractor{glm::vec3{std::cos(time), 0.5f, std::sin(time)}, 0.4f};
+        particles->attractors[1] = ParticleAttractor{glm::vec3{-std::cos(time), 0.0f, -std::sin(time)}, 0.4f};
+
+        auto emitted_count = static_cast<size_t>(static_cast<float>(Particle_Count) * dt / (Particle_Lifetime * 0.75f));
+        emit_particles(*particles, emitted_count, emitter);
+        update_particle_system(*particles, dt);
+
+        render_particle_system(*particles);
+
+        finish_frame_rendering();
+    }
+
+    destroy_particle_system(*particles);
+    destroy_shader_program();
+
+    destroy_window();
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "asr.h"
+
+#include <vector>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 130
+
+    attribute vec4 position;
+    attribute vec4 color;
+    attribute vec4 texture_coordinates;
+
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec4 fragment_color;
+    varying vec3 fragment_texture_coordinates;
+
+    void main()
+    {
+        fragment_color = color;
+        fragment_texture_coordinates = texture_coordinates.stp;
+
+        gl_Position = model_view_projection_matrix * position;
+    }
+)";
+
+static const char Fragment_Shader_Source[] = R"(
+    #version 130
+
+    uniform bool textures_enabled[1];
+    uniform sampler2DArray texture_samplers[1];
+
+    varying vec4 fragment_color;
+    varying vec3 fragment_texture_coordinates;
+
+    void main()
+    {
+        gl_FragColor = fragment_color;
+        if (textures_enabled[0]) {
+            gl_FragColor *= texture(texture_samplers[0], fragment_texture_coordinates);
+        }
+    }
+)";
+
+static void append_sphere_geometry_data(
+                std::vector<asr::Vertex> &vertices,
+                std::vector<unsigned int> &indices,
+                glm::vec3 center,
+                float radius,
+                float layer,
+                unsigned int width_segments_count,
+                unsigned int height_segments_count
+            )
+{
+    auto first_index = static_cast<unsigned int>(vertices.size());
+
+    auto [sphere_vertices, sphere_indices] = asr::generate_sphere_geometry_data(
+        radius, width_segments_count, height_segments_count
+    );
+    for (auto &vertex : sphere_vertices) {
+        vertex.x += center.x; vertex.y += center.y; vertex.z += center.z;
+        vertex.layer = layer;
+    }
+    vertices.insert(vertices.end(), sphere_vertices.begin(), sphere_vertices.end());
+    for (unsigned int index : sphere_indices) {
+        indices.push_back(first_index + index);
+    }
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    create_shader_program(
+        Vertex_Shader_Source,
+        Fragment_Shader_Source
+    );
+
+    // All planet images are 1280x640, so they share one texture array. Every sphere carries the layer
+    // of its image in the vertices, and the whole system is drawn with a single bind and draw call.
+    std::vector<Image> images;
+    images.push_back(read_image_file("data/images/sun.jpg"));
+    images.push_back(read_image_file("data/images/venus.jpg"));
+    images.push_back(read_image_file("data/images/earth.jpg"));
+    images.push_back(read_image_file("data/images/moon.jpg"));
+    auto texture = generate_texture_array(images);
+
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    append_sphere_geometry_data(vertices, indices, glm::vec3{ 0.0f,  0.0f, 0.0f}, 0.8f,  0.0f, 40, 40);
+    append_sphere_geometry_data(vertices, indices, glm::vec3{ 1.4f,  0.0f, 0.0f}, 0.25f, 1.0f, 20, 20);
+    append_sphere_geometry_data(vertices, indices, glm::vec3{-2.0f,  0.0f, 0.0f}, 0.3f,  2.0f, 20, 20);
+    append_sphere_geometry_data(vertices, indices, glm::vec3{-2.5f,  0.3f, 0.0f}, 0.1f,  3.0f, 10, 10);
+    auto geometry = generate_geometry(
+        GeometryType::Triangles,
+        vertices,
+        indices
+    );
+
+    prepare_for_rendering();
+
+    enable_depth_test();
+    enable_face_culling();
+
+    set_matrix_mode(MatrixMode::Projection);
+    load_perspective_projection_matrix(1.13f, 0.1f, 100.0f);
+
+    float rotation{0.0f};
+
+    bool should_stop{false};
+    while (!should_stop) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        set_matrix_mode(MatrixMode::View);
+        load_identity_matrix();
+        translate_matrix(glm::vec3{0.0f, 0.0f, 4.0f});
+
+        rotation += 0.3f * get_dt();
+        set_matrix_mode(MatrixMode::Model);
+        load_identity_matrix();
+        rotate_matrix(glm::vec3{0.0f, rotation, 0.0f});
+
+        set_texture_current(&texture);
+        set_geometry_current(&geometry);
+        render_current_geometry();
+
+        finish_frame_rendering();
+    }
+
+    destroy_texture(texture);
+    destroy_geometry(geometry);
+    destroy_shader_program();
+
+    destroy_window();
+
+    return 0;
+}
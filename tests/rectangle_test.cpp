@@ -10,7 +10,6 @@ static const char Vertex_Shader_Source[] = R"(
     attribute vec4 color;
     attribute vec4 texture_coordinates;
 
-    uniform bool texture_enabled;
     uniform mat4 texture_transformation_matrix;
 
     uniform mat4 model_view_projection_matrix;
@@ -20,11 +19,15 @@ static const char Vertex_Shader_Source[] = R"(
 
     void main()
     {
+    #ifdef ASR_VERTEX_COLOR_ENABLED
         fragment_color = color;
-        if (texture_enabled) {
-            vec4 transformed_texture_coordinates = texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0);
-            fragment_texture_coordinates = vec2(transformed_texture_coordinates);
-        }
+    #else
+        fragment_color = vec4(1.0);
+    #endif
+    #ifdef ASR_TEXTURE_ENABLED
+        vec4 transformed_texture_coordinates = texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0);
+        fragment_texture_coordinates = vec2(transformed_texture_coordinates);
+    #endif
 
         gl_Position = model_view_projection_matrix * position;
         gl_PointSize = 10.0;
@@ -40,8 +43,6 @@ static const char Fragment_Shader_Source[] = R"(
     #define TEXTURING_MODE_MODULATION          3
     #define TEXTURING_MODE_DECALING            4
 
-    uniform bool texture_enabled;
-    uniform int texturing_mode;
     uniform sampler2D texture_sampler;
 
     varying vec4 fragment_color;
@@ -51,20 +52,20 @@ static const char Fragment_Shader_Source[] = R"(
     {
         gl_FragColor = fragment_color;
 
-        if (texture_enabled) {
-            if (texturing_mode == TEXTURING_MODE_ADDITION) {
-                gl_FragColor += texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_MODULATION) {
-                gl_FragColor *= texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_DECALING) {
-                vec4 texel_color = texture2D(texture_sampler, fragment_texture_coordinates);
-                gl_FragColor.rgb = mix(gl_FragColor.rgb, texel_color.rgb, texel_color.a);
-            } else if (texturing_mode == TEXTURING_MODE_SUBTRACTION) {
-                gl_FragColor -= texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_REVERSE_SUBTRACTION) {
-                gl_FragColor = texture2D(texture_sampler, fragment_texture_coordinates) - gl_FragColor;
-            }
-        }
+    #ifdef ASR_TEXTURE_ENABLED
+    #if ASR_TEXTURING_MODE == TEXTURING_MODE_ADDITION
+        gl_FragColor += texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_MODULATION
+        gl_FragColor *= texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_DECALING
+        vec4 texel_color = texture2D(texture_sampler, fragment_texture_coordinates);
+        gl_FragColor.rgb = mix(gl_FragColor.rgb, texel_color.rgb, texel_color.a);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_SUBTRACTION
+        gl_FragColor -= texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_REVERSE_SUBTRACTION
+        gl_FragColor = texture2D(texture_sampler, fragment_texture_coordinates) - gl_FragColor;
+    #endif
+    #endif
     }
 )";
 
@@ -207,16 +208,13 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
 
     create_window(500, 500);
 
-    create_shader_program(
+    auto shader_variants = generate_shader_variants(
         Vertex_Shader_Source,
         Fragment_Shader_Source
     );
+    set_shader_variants_current(&shader_variants);
     auto [geometry_vertices, geometry_indices] = generate_rectangle_geometry_data(1.0f, 1.0f, 5, 5);
-    auto geometry = generate_geometry(
-        GeometryType::Triangles,
-        geometry_vertices,
-        geometry_indices
-    );
+    auto geometry = generate_strip_geometry(geometry_vertices, geometry_indices);
     auto [edge_vertices, edge_indices] = generate_rectangle_edges_data(1.0f, 1.0f, 5, 5);
     for (auto &vertex : edge_vertices) { vertex.z -= 0.01f; }
     auto edges_geometry = generate_geometry(
@@ -263,7 +261,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     destroy_geometry(geometry);
     destroy_geometry(edges_geometry);
     destroy_geometry(vertices_geometry);
-    destroy_shader_program();
+    destroy_shader_variants(shader_variants);
 
     destroy_window();
 
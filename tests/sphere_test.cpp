@@ -1,9 +1,5 @@
 #include "asr.h"
 
-#include <cmath>
-#include <utility>
-#include <vector>
-
 static const char Vertex_Shader_Source[] = R"(
     #version 110
 
@@ -11,7 +7,6 @@ static const char Vertex_Shader_Source[] = R"(
     attribute vec4 color;
     attribute vec4 texture_coordinates;
 
-    uniform bool texture_enabled;
     uniform mat4 texture_transformation_matrix;
 
     uniform mat4 model_view_projection_matrix;
@@ -21,11 +16,15 @@ static const char Vertex_Shader_Source[] = R"(
 
     void main()
     {
+    #ifdef ASR_VERTEX_COLOR_ENABLED
         fragment_color = color;
-        if (texture_enabled) {
-            vec4 transformed_texture_coordinates = texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0);
-            fragment_texture_coordinates = vec2(transformed_texture_coordinates);
-        }
+    #else
+        fragment_color = vec4(1.0);
+    #endif
+    #ifdef ASR_TEXTURE_ENABLED
+        vec4 transformed_texture_coordinates = texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0);
+        fragment_texture_coordinates = vec2(transformed_texture_coordinates);
+    #endif
 
         gl_Position = model_view_projection_matrix * position;
         gl_PointSize = 10.0;
@@ -41,8 +40,6 @@ static const char Fragment_Shader_Source[] = R"(
     #define TEXTURING_MODE_MODULATION          3
     #define TEXTURING_MODE_DECALING            4
 
-    uniform bool texture_enabled;
-    uniform int texturing_mode;
     uniform sampler2D texture_sampler;
 
     varying vec4 fragment_color;
@@ -52,212 +49,59 @@ static const char Fragment_Shader_Source[] = R"(
     {
         gl_FragColor = fragment_color;
 
-        if (texture_enabled) {
-            if (texturing_mode == TEXTURING_MODE_ADDITION) {
-                gl_FragColor += texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_MODULATION) {
-                gl_FragColor *= texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_DECALING) {
-                vec4 texel_color = texture2D(texture_sampler, fragment_texture_coordinates);
-                gl_FragColor.rgb = mix(gl_FragColor.rgb, texel_color.rgb, texel_color.a);
-            } else if (texturing_mode == TEXTURING_MODE_SUBTRACTION) {
-                gl_FragColor -= texture2D(texture_sampler, fragment_texture_coordinates);
-            } else if (texturing_mode == TEXTURING_MODE_REVERSE_SUBTRACTION) {
-                gl_FragColor = texture2D(texture_sampler, fragment_texture_coordinates) - gl_FragColor;
-            }
-        }
+    #ifdef ASR_TEXTURE_ENABLED
+    #if ASR_TEXTURING_MODE == TEXTURING_MODE_ADDITION
+        gl_FragColor += texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_MODULATION
+        gl_FragColor *= texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_DECALING
+        vec4 texel_color = texture2D(texture_sampler, fragment_texture_coordinates);
+        gl_FragColor.rgb = mix(gl_FragColor.rgb, texel_color.rgb, texel_color.a);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_SUBTRACTION
+        gl_FragColor -= texture2D(texture_sampler, fragment_texture_coordinates);
+    #elif ASR_TEXTURING_MODE == TEXTURING_MODE_REVERSE_SUBTRACTION
+        gl_FragColor = texture2D(texture_sampler, fragment_texture_coordinates) - gl_FragColor;
+    #endif
+    #endif
     }
 )";
 
-static std::pair<std::vector<asr::Vertex>, std::vector<unsigned int>> generate_sphere_geometry_data(
-                                                                          float radius,
-                                                                          unsigned int width_segments_count,
-                                                                          unsigned int height_segments_count
-                                                                      )
-{
-    std::vector<asr::Vertex> vertices;
-    std::vector<unsigned int> indices;
-
-    for (unsigned int ring = 0; ring <= height_segments_count; ++ring) {
-        float v{static_cast<float>(ring) / static_cast<float>(height_segments_count)};
-        float phi{v * asr::pi};
-
-        for (unsigned int segment = 0; segment <= width_segments_count; ++segment) {
-            float u{static_cast<float>(segment) / static_cast<float>(width_segments_count)};
-            float theta{u * asr::two_pi};
-
-            float cos_phi{std::cosf(phi)};
-            float sin_phi{std::sinf(phi)};
-            float cos_theta{std::cosf(theta)};
-            float sin_theta{std::sinf(theta)};
-
-            float y{cos_phi * radius};
-            float x{sin_phi * cos_theta * radius};
-            float z{sin_phi * sin_theta * radius};
-
-            vertices.push_back(asr::Vertex{
-                x, y, z,
-                1.0f, 1.0f, 1.0f, 1.0f,
-                1.0f - u, v
-            });
-        }
-    }
-
-    for (unsigned int ring = 0; ring < height_segments_count; ++ring) {
-        for (unsigned int segment = 0; segment < width_segments_count; ++segment) {
-            unsigned int index_a{ring * (width_segments_count + 1) + segment};
-            unsigned int index_b{index_a + 1};
-
-            unsigned int index_c{index_a + (width_segments_count + 1)};
-            unsigned int index_d{index_c + 1};
-
-            if (ring != 0) {
-                indices.push_back(index_a);
-                indices.push_back(index_b);
-                indices.push_back(index_c);
-            }
-
-            if (ring != height_segments_count - 1) {
-                indices.push_back(index_b);
-                indices.push_back(index_d);
-                indices.push_back(index_c);
-            }
-        }
-    }
-
-    return std::make_pair(vertices, indices);
-}
-
-static std::pair<std::vector<asr::Vertex>, std::vector<unsigned int>> generate_sphere_edges_data(
-                                                                          float radius,
-                                                                          unsigned int width_segments_count,
-                                                                          unsigned int height_segments_count
-                                                                      )
-{
-    std::vector<asr::Vertex> vertices;
-    std::vector<unsigned int> indices;
-
-    for (unsigned int ring = 0; ring <= height_segments_count; ++ring) {
-        float v{static_cast<float>(ring) / static_cast<float>(height_segments_count)};
-        for (unsigned int segment = 0; segment <= width_segments_count; ++segment) {
-            float u{static_cast<float>(segment) / static_cast<float>(width_segments_count)};
-
-            float theta{u * asr::two_pi};
-            float phi{v * asr::pi};
-
-            float cos_theta{std::cosf(theta)};
-            float sin_theta{std::sinf(theta)};
-            float sin_phi{std::sinf(phi)};
-            float cos_phi{std::cosf(phi)};
-
-            float x{cos_theta * sin_phi * radius};
-            float y{cos_phi * radius};
-            float z{sin_theta * sin_phi * radius};
-
-            vertices.push_back(asr::Vertex{
-                x, y, z,
-                1.0f, 1.0f, 1.0f, 1.0f,
-                1.0f - u, v
-            });
-        }
-    }
-
-    for (unsigned int ring = 0; ring < height_segments_count; ++ring) {
-        for (unsigned int segment = 0; segment < width_segments_count; ++segment) {
-            unsigned int index_a{ring * (width_segments_count + 1) + segment};
-            unsigned int index_b{index_a + 1};
-
-            unsigned int index_c{index_a + (width_segments_count + 1)};
-            unsigned int index_d{index_c + 1};
-
-            if (ring != 0) {
-                indices.push_back(index_a); indices.push_back(index_b);
-                indices.push_back(index_b); indices.push_back(index_c);
-                indices.push_back(index_c); indices.push_back(index_a);
-            }
-
-            if (ring != height_segments_count - 1) {
-                indices.push_back(index_b); indices.push_back(index_d);
-                indices.push_back(index_d); indices.push_back(index_c);
-                indices.push_back(index_c); indices.push_back(index_b);
-            }
-        }
-    }
-
-    return std::make_pair(vertices, indices);
-}
-
-static std::pair<std::vector<asr::Vertex>, std::vector<unsigned int>> generate_sphere_vertices_data(
-                                                                          float radius,
-                                                                          unsigned int width_segments_count,
-                                                                          unsigned int height_segments_count
-                                                                      )
-{
-    std::vector<asr::Vertex> vertices;
-    std::vector<unsigned int> indices;
-
-    for (unsigned int ring = 0; ring <= height_segments_count; ++ring) {
-        float v{static_cast<float>(ring) / static_cast<float>(height_segments_count)};
-        for (unsigned int segment = 0; segment <= width_segments_count; ++segment) {
-            float u{static_cast<float>(segment) / static_cast<float>(width_segments_count)};
-
-            float theta{u * asr::two_pi};
-            float phi{v * asr::pi};
-
-            float cos_theta{std::cosf(theta)};
-            float sin_theta{std::sinf(theta)};
-            float sin_phi{std::sinf(phi)};
-            float cos_phi{std::cosf(phi)};
-
-            float x{cos_theta * sin_phi * radius};
-            float y{cos_phi * radius};
-            float z{sin_theta * sin_phi * radius};
-
-            vertices.push_back(asr::Vertex{
-                x, y, z,
-                1.0f, 1.0f, 1.0f, 1.0f,
-                1.0f - u, v
-            });
-            indices.push_back(vertices.size() - 1);
-        }
-    }
-
-    return std::make_pair(vertices, indices);
-}
-
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
 {
     using namespace asr;
 
     create_window(500, 500);
 
-    create_shader_program(
+    auto shader_variants = generate_shader_variants(
         Vertex_Shader_Source,
         Fragment_Shader_Source
     );
-    auto [geometry_vertices, geometry_indices] = generate_sphere_geometry_data(0.5f, 20, 20);
-    auto geometry = generate_geometry(
-        GeometryType::Triangles,
-        geometry_vertices,
-        geometry_indices
-    );
-    auto [edge_vertices, edge_indices] = generate_sphere_edges_data(0.501f, 20, 20);
-    auto edges_geometry = generate_geometry(
-        GeometryType::Lines,
-        edge_vertices,
-        edge_indices
-    );
-    auto [vertices, vertex_indices]  = generate_sphere_vertices_data(0.502f, 20, 20);
-    for (auto &vertex : vertices) {
-        vertex.r = 1.0f; vertex.g = 0.0f; vertex.b = 0.0f;
+    set_shader_variants_current(&shader_variants);
+    // Keys 1, 2 and 3 switch between a UV sphere, an icosphere and a cube sphere.
+    auto generate_sphere_data = [](unsigned int shape, float radius, GeometryType type) {
+        if (shape == 1) return generate_icosphere_geometry_data(radius, 3, type);
+        if (shape == 2) return generate_cube_sphere_geometry_data(radius, 8, type);
+        return generate_sphere_geometry_data(radius, 20, 20, type);
+    };
+
+    // The surface, its edges and its vertices are views over one vertex buffer.
+    static const unsigned int SHAPE_COUNT{3};
+    Geometry geometries[SHAPE_COUNT];
+    for (unsigned int shape = 0; shape < SHAPE_COUNT; ++shape) {
+        auto [vertices, triangle_indices] = generate_sphere_data(shape, 0.5f, Triangles);
+        geometries[shape] = generate_geometry(vertices, {
+            {TriangleStrip, convert_triangles_to_strips(triangle_indices, is_primitive_restart_supported())},
+            {Lines, generate_sphere_data(shape, 0.5f, Lines).second},
+            {Points, generate_sphere_data(shape, 0.5f, Points).second}
+        });
     }
-    auto vertices_geometry = generate_geometry(
-        GeometryType::Points,
-        vertices,
-        vertex_indices
-    );
+    unsigned int current_shape{0};
+
+    // The seamless mappings of the icosphere and the cube sphere reach past u = 1 over the seam.
     auto image = read_image_file("data/images/uv_test.png");
     auto texture = generate_texture(image);
+    set_texture_current(&texture);
+    set_texture_wrap_mode_u(Repeat);
 
     prepare_for_rendering();
 
@@ -275,6 +119,9 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     glm::vec3 camera_rotation{0.0f, 0.0f, 0.0f};
     set_keys_down_event_handler([&](const uint8_t *keys) {
         if (keys[SDL_SCANCODE_ESCAPE]) std::exit(0);
+        if (keys[SDL_SCANCODE_1]) current_shape = 0;
+        if (keys[SDL_SCANCODE_2]) current_shape = 1;
+        if (keys[SDL_SCANCODE_3]) current_shape = 2;
         if (keys[SDL_SCANCODE_W]) camera_rotation.x -= CAMERA_ROT_SPEED * get_dt();
         if (keys[SDL_SCANCODE_A]) camera_rotation.y += CAMERA_ROT_SPEED * get_dt();
         if (keys[SDL_SCANCODE_S]) camera_rotation.x += CAMERA_ROT_SPEED * get_dt();
@@ -303,23 +150,23 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
         rotate_matrix(camera_rotation);
 
         set_texture_current(&texture);
-        set_geometry_current(&geometry);
+        set_geometry_current(&geometries[current_shape]);
+        enable_polygon_offset();
         render_current_geometry();
+        disable_polygon_offset();
 
         set_texture_current(nullptr);
-        set_geometry_current(&edges_geometry);
-        render_current_geometry();
-        set_geometry_current(&vertices_geometry);
-        render_current_geometry();
+        render_current_geometry_view(geometries[current_shape].views[1]);
+        render_current_geometry_view(geometries[current_shape].views[2]);
 
         finish_frame_rendering();
     }
 
     destroy_texture(texture);
-    destroy_geometry(geometry);
-    destroy_geometry(edges_geometry);
-    destroy_geometry(vertices_geometry);
-    destroy_shader_program();
+    for (unsigned int shape = 0; shape < SHAPE_COUNT; ++shape) {
+        destroy_geometry(geometries[shape]);
+    }
+    destroy_shader_variants(shader_variants);
 
     destroy_window();
 
@@ -0,0 +1,176 @@
+#include "asr.h"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 130
+
+    attribute vec4 position;
+    attribute vec4 color;
+
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec4 fragment_color;
+
+    void main()
+    {
+        fragment_color = color;
+        gl_Position = model_view_projection_matrix * position;
+    }
+)";
+
+static const char Opaque_Fragment_Shader_Source[] = R"(
+    #version 130
+
+    varying vec4 fragment_color;
+
+    void main()
+    {
+        gl_FragColor = fragment_color;
+    }
+)";
+
+static const char Transparent_Fragment_Shader_Main_Source[] = R"(
+    uniform vec4 tint;
+
+    varying vec4 fragment_color;
+
+    void main()
+    {
+        write_transparent_fragment(fragment_color * tint);
+    }
+)";
+
+struct GlyphUniforms
+{
+    glm::vec4 tint;
+
+    static constexpr auto get_shader_uniforms()
+    {
+        return std::make_tuple(asr::make_shader_uniform("tint", &GlyphUniforms::tint));
+    }
+};
+
+static const unsigned int Glyph_Count{20000};
+
+// A cloud of translucent quads around an opaque sphere, drawn in whatever order they were generated in.
+static std::pair<std::vector<asr::Vertex>, std::vector<unsigned int>> generate_glyph_cloud_data(unsigned int glyph_count)
+{
+    std::vector<asr::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve(glyph_count * 4);
+    indices.reserve(glyph_count * 6);
+
+    uint32_t state{12345};
+    auto random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    };
+
+    for (unsigned int i = 0; i < glyph_count; ++i) {
+        float x{random() * 2.0f - 1.0f}, y{random() * 2.0f - 1.0f}, z{random() * 2.0f - 1.0f};
+        float size{0.01f + random() * 0.03f};
+        float r{random()}, g{random()}, b{random()}, a{0.2f + random() * 0.5f};
+
+        auto first = static_cast<unsigned int>(vertices.size());
+        vertices.push_back(asr::Vertex{x - size, y - size, z, r, g, b, a, 0.0f, 0.0f});
+        vertices.push_back(asr::Vertex{x + size, y - size, z, r, g, b, a, 1.0f, 0.0f});
+        vertices.push_back(asr::Vertex{x + size, y + size, z, r, g, b, a, 1.0f, 1.0f});
+        vertices.push_back(asr::Vertex{x - size, y + size, z, r, g, b, a, 0.0f, 1.0f});
+        for (unsigned int corner : {0u, 1u, 2u, 0u, 2u, 3u}) {
+            indices.push_back(first + corner);
+        }
+    }
+
+    return std::make_pair(vertices, indices);
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    if (!is_order_independent_transparency_supported()) {
+        std::cerr << "Order-independent transparency needs OpenGL 3.0." << std::endl;
+        destroy_window();
+        return -1;
+    }
+
+    auto opaque_program = generate_shader_program(Vertex_Shader_Source, Opaque_Fragment_Shader_Source);
+    auto transparent_program = generate_shader_program(
+        Vertex_Shader_Source,
+        ("#version 130\n" + get_transparency_shader_source() + Transparent_Fragment_Shader_Main_Source).c_str()
+    );
+
+    auto glyph_interface = generate_shader_interface<GlyphUniforms>(transparent_program);
+
+    auto [sphere_vertices, sphere_indices] = generate_sphere_geometry_data(0.4f, 32, 32);
+    for (auto &vertex : sphere_vertices) {
+        vertex.r = vertex.u; vertex.g = vertex.v; vertex.b = 0.5f;
+    }
+    auto sphere_geometry = generate_geometry(GeometryType::Triangles, sphere_vertices, sphere_indices);
+
+    auto [glyph_vertices, glyph_indices] = generate_glyph_cloud_data(Glyph_Count);
+    auto glyph_geometry = generate_geometry(GeometryType::Triangles, glyph_vertices, glyph_indices);
+
+    prepare_for_rendering();
+
+    enable_depth_test();
+
+    set_matrix_mode(MatrixMode::Projection);
+    load_perspective_projection_matrix(1.13f, 0.1f, 100.0f);
+
+    glm::vec3 camera_rotation{0.0f, 0.0f, 0.0f};
+    set_keys_down_event_handler([&](const uint8_t *keys) {
+        if (keys[SDL_SCANCODE_ESCAPE]) std::exit(0);
+        if (keys[SDL_SCANCODE_W]) camera_rotation.x -= 1.5f * get_dt();
+        if (keys[SDL_SCANCODE_A]) camera_rotation.y += 1.5f * get_dt();
+        if (keys[SDL_SCANCODE_S]) camera_rotation.x += 1.5f * get_dt();
+        if (keys[SDL_SCANCODE_D]) camera_rotation.y -= 1.5f * get_dt();
+    });
+
+    bool should_stop{false};
+    while (!should_stop) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        set_matrix_mode(MatrixMode::View);
+        load_identity_matrix();
+        rotate_matrix(camera_rotation);
+        translate_matrix(glm::vec3{0.0f, 0.0f, 2.5f});
+
+        set_shader_program_current(&opaque_program);
+        set_geometry_current(&sphere_geometry);
+        render_current_geometry();
+
+        // The cloud is drawn twice, turned and tinted differently per draw.
+        begin_transparency_pass();
+        set_shader_program_current(&transparent_program);
+        set_geometry_current(&glyph_geometry);
+        set_matrix_mode(MatrixMode::Model);
+        for (int i = 0; i < 2; ++i) {
+            push_matrix();
+            rotate_matrix(glm::vec3{0.0f, static_cast<float>(i) * 1.57f, 0.0f});
+            set_shader_interface_uniforms(glyph_interface, GlyphUniforms{i == 0 ? glm::vec4{1.0f} : glm::vec4{0.4f, 0.8f, 1.0f, 1.0f}});
+            render_current_geometry();
+            pop_matrix();
+        }
+        end_transparency_pass();
+
+        finish_frame_rendering();
+    }
+
+    destroy_geometry(glyph_geometry);
+    destroy_geometry(sphere_geometry);
+    destroy_shader_program(transparent_program);
+    destroy_shader_program(opaque_program);
+
+    destroy_window();
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "asr.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Triangle = std::array<unsigned int, 3>;
+
+// Rotates the smallest index to the front, which keeps the winding.
+static Triangle make_canonical_triangle(unsigned int a, unsigned int b, unsigned int c)
+{
+    if (b < a && b < c) return {b, c, a};
+    if (c < a && c < b) return {c, a, b};
+
+    return {a, b, c};
+}
+
+static bool is_degenerate_triangle(unsigned int a, unsigned int b, unsigned int c)
+{
+    return a == b || b == c || c == a;
+}
+
+static void decode_strip(const unsigned int *strip, size_t index_count, std::vector<Triangle> &triangles)
+{
+    for (size_t i = 2; i < index_count; ++i) {
+        unsigned int a{strip[i - 2]}, b{strip[i - 1]}, c{strip[i]};
+        if (is_degenerate_triangle(a, b, c)) continue;
+
+        // Every second triangle of a strip is wound the other way round.
+        triangles.push_back(i % 2 == 0 ? make_canonical_triangle(a, b, c) : make_canonical_triangle(b, a, c));
+    }
+}
+
+static std::vector<Triangle> decode_strips(const std::vector<unsigned int> &strips, bool use_primitive_restart)
+{
+    std::vector<Triangle> triangles;
+    if (!use_primitive_restart) {
+        decode_strip(strips.data(), strips.size(), triangles);
+        return triangles;
+    }
+
+    size_t strip_start{0};
+    for (size_t i = 0; i <= strips.size(); ++i) {
+        if (i == strips.size() || strips[i] == asr::primitive_restart_index) {
+            decode_strip(strips.data() + strip_start, i - strip_start, triangles);
+            strip_start = i + 1;
+        }
+    }
+
+    return triangles;
+}
+
+static bool are_strips_equivalent(const std::string &name, const std::vector<unsigned int> &indices, bool expect_savings)
+{
+    std::vector<Triangle> expected_triangles;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        if (is_degenerate_triangle(indices[i], indices[i + 1], indices[i + 2])) continue;
+        expected_triangles.push_back(make_canonical_triangle(indices[i], indices[i + 1], indices[i + 2]));
+    }
+    std::sort(expected_triangles.begin(), expected_triangles.end());
+
+    bool equivalent{true};
+    for (bool use_primitive_restart : {true, false}) {
+        const char *mode = use_primitive_restart ? " with primitive restart" : " with degenerate triangles";
+
+        std::vector<unsigned int> strips{asr::convert_triangles_to_strips(indices, use_primitive_restart)};
+        std::vector<Triangle> triangles{decode_strips(strips, use_primitive_restart)};
+        std::sort(triangles.begin(), triangles.end());
+        if (triangles != expected_triangles) {
+            std::cerr << name << mode << ": the strips decode to " << triangles.size() << " triangles instead of "
+                      << expected_triangles.size() << std::endl;
+            equivalent = false;
+        }
+        if (expect_savings && strips.size() >= indices.size()) {
+            std::cerr << name << mode << ": " << strips.size() << " strip indices for a list of "
+                      << indices.size() << std::endl;
+            equivalent = false;
+        }
+    }
+
+    return equivalent;
+}
+
+// Triangles of random corners, which rarely share an edge and make strips larger than the list.
+static std::vector<unsigned int> generate_triangle_soup_indices(unsigned int triangle_count, unsigned int vertex_count)
+{
+    uint32_t state{12345};
+    auto random = [&state, vertex_count]() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) % vertex_count;
+    };
+
+    std::vector<unsigned int> indices;
+    for (unsigned int i = 0; i < triangle_count * 3; ++i) {
+        indices.push_back(random());
+    }
+
+    return indices;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    std::vector<std::pair<std::string, std::vector<unsigned int>>> meshes;
+    for (unsigned int level = 0; level <= 4; ++level) {
+        meshes.emplace_back("icosphere level " + std::to_string(level), generate_icosphere_geometry_data(1.0f, level).second);
+    }
+    for (unsigned int segment_count : {1u, 4u, 16u}) {
+        meshes.emplace_back(
+            "cube sphere " + std::to_string(segment_count), generate_cube_sphere_geometry_data(1.0f, segment_count).second
+        );
+    }
+    meshes.emplace_back("UV sphere", generate_sphere_geometry_data(1.0f, 32, 16).second);
+
+    int result{0};
+    for (const auto &[name, indices] : meshes) {
+        // Only the smallest meshes have too few shared edges to win over a list.
+        bool expect_savings{indices.size() >= 3 * 100};
+        if (!are_strips_equivalent(name, indices, expect_savings)) result = 1;
+    }
+    if (!are_strips_equivalent("triangle soup", generate_triangle_soup_indices(2000, 500), false)) result = 1;
+    if (!are_strips_equivalent("empty list", {}, false)) result = 1;
+
+    stop_job_system();
+
+    return result;
+}
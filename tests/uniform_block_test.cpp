@@ -0,0 +1,120 @@
+#include "asr.h"
+
+#include <iostream>
+#include <vector>
+
+// Draws a rectangle whose position comes from ViewUniforms and whose color comes from FrameUniforms, then
+// reads the frame back. Returns 1 if the blocks did not reach the shader.
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 140
+
+    layout(std140) uniform ViewUniforms
+    {
+        mat4 view_matrix;
+        mat4 projection_matrix;
+        mat4 view_projection_matrix;
+    };
+
+    in vec4 position;
+
+    void main()
+    {
+        gl_Position = view_projection_matrix * position;
+    }
+)";
+
+static const char Fragment_Shader_Source[] = R"(
+    #version 140
+
+    layout(std140) uniform FrameUniforms
+    {
+        vec2 resolution;
+        vec2 mouse;
+        float time;
+        float dt;
+    };
+
+    out vec4 output_color;
+
+    void main()
+    {
+        output_color = vec4(resolution / 500.0, 0.0, 1.0);
+    }
+)";
+
+static const std::vector<asr::Vertex> Rectangle_Geometry_Vertices = {
+    //           Position                Color (RGBA)            Texture Coordinates (UV)
+    asr::Vertex{-0.25f, -0.25f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f},
+    asr::Vertex{ 0.25f, -0.25f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    asr::Vertex{ 0.25f,  0.25f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+    asr::Vertex{-0.25f,  0.25f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f}
+};
+static const std::vector<unsigned int> Rectangle_Geometry_Indices = { 0, 1, 2, 0, 2, 3 };
+
+static bool is_pixel_yellow(int x, int y)
+{
+    uint8_t pixel[4]{};
+    glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+    return pixel[0] > 250 && pixel[1] > 250 && pixel[2] < 5;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    if (!is_uniform_block_supported()) {
+        std::cout << "Uniform blocks need OpenGL 3.1, so there is nothing to check." << std::endl;
+        destroy_window();
+        return 0;
+    }
+
+    auto shader_program = generate_shader_program(Vertex_Shader_Source, Fragment_Shader_Source);
+    set_shader_program_current(&shader_program);
+    auto geometry = generate_geometry(
+        GeometryType::Triangles,
+        Rectangle_Geometry_Vertices,
+        Rectangle_Geometry_Indices
+    );
+
+    prepare_for_rendering();
+
+    int result{0};
+    if (!shader_program.uses_frame_uniform_block || !shader_program.uses_view_uniform_block) {
+        std::cerr << "The program was not bound to the shared uniform blocks" << std::endl;
+        result = 1;
+    }
+
+    prepare_to_render_frame();
+
+    // The camera moves right, so the rectangle ends up in the left half of the window.
+    set_matrix_mode(MatrixMode::View);
+    load_identity_matrix();
+    translate_matrix(glm::vec3{0.5f, 0.0f, 0.0f});
+
+    set_geometry_current(&geometry);
+    render_current_geometry();
+
+    GLint viewport[4]{};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (!is_pixel_yellow(viewport[2] / 4, viewport[3] / 2)) {
+        std::cerr << "The rectangle is not where the view block puts it, or not in the frame block's color" << std::endl;
+        result = 1;
+    }
+    if (is_pixel_yellow(viewport[2] / 2, viewport[3] / 2)) {
+        std::cerr << "The rectangle was drawn without the view block's matrices" << std::endl;
+        result = 1;
+    }
+
+    finish_frame_rendering();
+
+    destroy_geometry(geometry);
+    destroy_shader_program(shader_program);
+
+    destroy_window();
+
+    return result;
+}
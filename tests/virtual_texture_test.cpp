@@ -0,0 +1,136 @@
+#include "asr.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static const char Vertex_Shader_Source[] = R"(
+    #version 130
+
+    attribute vec4 position;
+    attribute vec4 texture_coordinates;
+
+    uniform mat4 texture_transformation_matrix;
+    uniform mat4 model_view_projection_matrix;
+
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+        fragment_texture_coordinates = vec2(texture_transformation_matrix * vec4(texture_coordinates.st, 0.0, 1.0));
+        gl_Position = model_view_projection_matrix * position;
+    }
+)";
+
+static const char Fragment_Shader_Main_Source[] = R"(
+    varying vec2 fragment_texture_coordinates;
+
+    void main()
+    {
+        gl_FragColor = sample_virtual_texture(fragment_texture_coordinates);
+    }
+)";
+
+static const std::vector<asr::Vertex> Screen_Geometry_Vertices = {
+    //           Position             Color (RGBA)            Texture Coordinates (UV)
+    asr::Vertex{-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+    asr::Vertex{ 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+    asr::Vertex{ 1.0f,  1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    asr::Vertex{-1.0f,  1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f}
+};
+static const std::vector<unsigned int> Screen_Geometry_Indices = { 0, 1, 2, 0, 2, 3 };
+
+static const unsigned int Image_Size{100000};
+
+// A procedural 100K x 100K image stands in for a gigapixel scan: colors change slowly across the image,
+// and a grid of lines every 4096 texels makes panning and level changes easy to follow.
+static bool provide_tile(unsigned int level, int x, int y, unsigned int width, unsigned int height, uint8_t *pixels)
+{
+    int level_size{static_cast<int>(std::max(1u, Image_Size >> level))};
+    for (unsigned int row = 0; row < height; ++row) {
+        int texel_y{std::min(std::max(y + static_cast<int>(row), 0), level_size - 1)};
+        auto image_y = static_cast<unsigned int>(texel_y) << level;
+        for (unsigned int column = 0; column < width; ++column) {
+            int texel_x{std::min(std::max(x + static_cast<int>(column), 0), level_size - 1)};
+            auto image_x = static_cast<unsigned int>(texel_x) << level;
+
+            bool grid_line{(image_x & 4095u) < (1u << level) || (image_y & 4095u) < (1u << level)};
+            uint8_t *pixel = pixels + (row * width + column) * 4;
+            pixel[0] = grid_line ? 255 : static_cast<uint8_t>(image_x * 255ull / Image_Size);
+            pixel[1] = grid_line ? 255 : static_cast<uint8_t>(image_y * 255ull / Image_Size);
+            pixel[2] = grid_line ? 255 : static_cast<uint8_t>(((image_x ^ image_y) >> 6) & 0xFF);
+            pixel[3] = 255;
+        }
+    }
+
+    return true;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    using namespace asr;
+
+    create_window(500, 500);
+
+    auto virtual_texture = generate_virtual_texture(Image_Size, Image_Size, provide_tile);
+    std::string fragment_shader_source =
+        "#version 130\n" + get_virtual_texture_shader_source(*virtual_texture) + Fragment_Shader_Main_Source;
+
+    create_shader_program(
+        Vertex_Shader_Source,
+        fragment_shader_source.c_str()
+    );
+    auto screen_geometry = generate_geometry(
+        GeometryType::Triangles,
+        Screen_Geometry_Vertices,
+        Screen_Geometry_Indices
+    );
+
+    prepare_for_rendering();
+
+    static const float PAN_SPEED{0.5f};
+    static const float ZOOM_SPEED{1.5f};
+    static const float MIN_EXTENT{0.001f};
+
+    glm::vec2 center{0.5f, 0.5f};
+    float extent{1.0f};
+    set_keys_down_event_handler([&](const uint8_t *keys) {
+        if (keys[SDL_SCANCODE_ESCAPE]) std::exit(0);
+        if (keys[SDL_SCANCODE_LEFT]) center.x -= PAN_SPEED * extent * get_dt();
+        if (keys[SDL_SCANCODE_RIGHT]) center.x += PAN_SPEED * extent * get_dt();
+        if (keys[SDL_SCANCODE_DOWN]) center.y -= PAN_SPEED * extent * get_dt();
+        if (keys[SDL_SCANCODE_UP]) center.y += PAN_SPEED * extent * get_dt();
+        if (keys[SDL_SCANCODE_W]) extent = std::max(MIN_EXTENT, extent * (1.0f - ZOOM_SPEED * get_dt()));
+        if (keys[SDL_SCANCODE_S]) extent = std::min(1.0f, extent * (1.0f + ZOOM_SPEED * get_dt()));
+    });
+
+    bool should_stop{false};
+    while (!should_stop) {
+        process_window_events(&should_stop);
+
+        prepare_to_render_frame();
+
+        glm::vec2 visible_min{center - extent * 0.5f};
+        glm::vec2 visible_max{center + extent * 0.5f};
+        update_virtual_texture(*virtual_texture, visible_min, visible_max, glm::vec2{500.0f, 500.0f});
+
+        set_matrix_mode(MatrixMode::Texturing);
+        load_identity_matrix();
+        translate_matrix(glm::vec3{visible_min.x, visible_min.y, 0.0f});
+        scale_matrix(glm::vec3{extent, extent, 1.0f});
+
+        set_virtual_texture_current(virtual_texture.get());
+        set_geometry_current(&screen_geometry);
+        render_current_geometry();
+
+        finish_frame_rendering();
+    }
+
+    destroy_virtual_texture(*virtual_texture);
+    destroy_geometry(screen_geometry);
+    destroy_shader_program();
+
+    destroy_window();
+
+    return 0;
+}
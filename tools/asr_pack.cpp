@@ -0,0 +1,76 @@
+#include "asr.h"
+
+#include <iostream>
+#include <string>
+
+// Packs images into an archive that asr::open_archive() maps at run time:
+//
+//     asr_pack <archive> [--mipmaps] [--rgba] [--premultiply] [--linear] <image>...
+//     asr_pack --list <archive>
+//
+// Options apply to the images that follow them. Entries are named by the image paths as given.
+
+static void print_usage()
+{
+    std::cerr << "Usage: asr_pack <archive> [--mipmaps] [--rgba] [--premultiply] [--linear] <image>..." << std::endl
+              << "       asr_pack --list <archive>" << std::endl;
+}
+
+static int list_archive(const std::string &path)
+{
+    using namespace asr;
+
+    auto archive = open_archive(path);
+    for (uint32_t i = 0; i < archive->header->entry_count; ++i) {
+        const ArchiveEntry &entry = archive->entries[i];
+        if (entry.type == ArchiveTexture) {
+            std::cout << entry.name << ": texture " << entry.width << "x" << entry.height << "x" << entry.channels
+                      << ", " << entry.section_count << " levels, " << entry.size << " bytes" << std::endl;
+        } else {
+            std::cout << entry.name << ": geometry " << entry.vertex_count << " vertices, " << entry.index_count
+                      << " indices, " << entry.size << " bytes" << std::endl;
+        }
+    }
+    close_archive(*archive);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    using namespace asr;
+
+    if (argc == 3 && std::string{argv[1]} == "--list") {
+        return list_archive(argv[2]);
+    }
+    if (argc < 3) {
+        print_usage();
+        return -1;
+    }
+
+    ArchiveBuilder builder;
+    bool generate_mipmaps{false};
+    unsigned int conversions{NoPixelConversion};
+    for (int i = 2; i < argc; ++i) {
+        std::string argument{argv[i]};
+        if (argument == "--mipmaps") {
+            generate_mipmaps = true;
+        } else if (argument == "--rgba") {
+            conversions |= ExpandToRGBA;
+        } else if (argument == "--premultiply") {
+            conversions |= PremultiplyAlpha;
+        } else if (argument == "--linear") {
+            conversions |= ConvertSRGBToLinear;
+        } else if (argument.rfind("--", 0) == 0) {
+            print_usage();
+            return -1;
+        } else {
+            Image image = read_image_file(argument, conversions);
+            add_archive_texture(builder, argument, image, generate_mipmaps);
+        }
+    }
+
+    write_archive(builder, argv[1]);
+
+    return 0;
+}